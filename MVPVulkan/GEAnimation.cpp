@@ -11,7 +11,7 @@
  * @brief Constructor de la animación.
  */
 GEAnimation::GEAnimation(float duration, bool loop)
-    : duration(duration), loop(loop), currentTime(0.0f), paused(false)
+    : duration(duration), currentTime(0.0f), loop(loop), paused(false)
 {
 }
 
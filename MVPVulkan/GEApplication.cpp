@@ -5,14 +5,30 @@
 
 #include "GEApplication.h"
 
+// Icono de la ventana: recurso IDI_ICON1 del ejecutable y carga opcional con stb_image (solo Windows)
+#ifdef _WIN32
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
 #include <windows.h>
+#include "resource.h"
+#endif
+
 #include <iostream>
 #include <vector>
 #include <glm/common.hpp>
-#include "resource.h"
+#include "DEBUG.h"
+
+/**
+ * @brief Crea la aplicación.
+ * @param pushTransforms Envía la matriz Model de las figuras por push constants.
+ * @param meshPath Fichero .gem que se dibuja junto al esqueleto.
+ */
+GEApplication::GEApplication(bool pushTransforms, const std::string& meshPath)
+{
+	this->pushTransforms = pushTransforms;
+	this->meshPath = meshPath;
+}
 
 /**
  * @brief Ejecuta la aplicación.
@@ -21,11 +37,22 @@ void GEApplication::run()
 {
 	this->window = initWindow();
 	this->windowPos = initWindowPos();
+#ifdef DEBUG
+	double startTime = glfwGetTime();
+#endif
 	this->gc = new GEGraphicsContext(window);
-	this->dc = new GEDrawingContext(this->gc, this->windowPos);
-	this->cc = new GECommandContext(this->gc, this->dc->getImageCount());
+	this->dc = new GEDrawingContext(this->gc, this->windowPos, FRAMES_IN_FLIGHT, PRESENT_MODE);
+	this->cc = new GECommandContext(this->gc, this->dc->getFrameCount());
+	this->pacer = new GEFramePacer(PACING_LATENCY);
+	this->resizePending = false;
+
+	this->scene = new GEScene(gc, dc, cc, pushTransforms, meshPath);
 
-	this->scene = new GEScene(gc, dc, cc);
+#ifdef DEBUG
+	// Comparar dos arranques seguidos: el primero compila los pipelines y el segundo los lee de la caché
+	std::cout << "[Arranque] " << (glfwGetTime() - startTime) * 1000.0 << " ms, pipeline cache "
+		<< (gc->pipelineCache->isWarm() ? "caliente (" : "fria (") << gc->pipelineCache->getLoadedSize() << " bytes)" << std::endl;
+#endif
 
 	mainLoop();
 
@@ -86,7 +113,21 @@ void GEApplication::mainLoop()
 {
 	while (!glfwWindowShouldClose(window))
 	{
+		// Se espera a la GPU antes de leer la entrada, no después: la cámara usa los
+		// eventos más recientes y el frame no se queda parado con ellos en la cola
+		pacer->wait(gc, dc);
 		glfwPollEvents();
+
+		// Un arrastre genera muchos eventos: se aplica solo el último, una vez por frame
+		if (resizePending)
+		{
+			resize();
+			if (resizePending)
+			{
+				glfwWaitEvents();
+				continue;
+			}
+		}
 		draw();
 	}
 }
@@ -97,9 +138,21 @@ void GEApplication::mainLoop()
 void GEApplication::draw()
 {
 	dc->waitForNextImage(gc);
-	scene->update(gc, dc->getCurrentImage());
+	scene->update(gc, dc->getCurrentFrame(), dc->getCurrentImage());
 	dc->submitGraphicsCommands(gc, cc->commandBuffers);
+	pacer->markSubmitted();
 	dc->submitPresentCommands(gc);
+
+#ifdef DEBUG
+	GELatencyStats latency = pacer->getStats();
+	if (latency.frames == CPU_STATS_FRAMES)
+	{
+		std::cout << "[Latencia] entrada-envio: " << latency.averageLatency << " ms (max " << latency.maxLatency << " ms)"
+			<< ", espera al frame N-" << pacer->getLatency() << ": " << latency.averageWait << " ms"
+			<< ", modo: " << GEDrawingContext::getPresentModeName(dc->getPresentMode()) << std::endl;
+		pacer->resetStats();
+	}
+#endif
 }
 
 /**
@@ -111,6 +164,7 @@ void GEApplication::cleanup()
 	cc->destroy(gc);
 	dc->destroy(gc);
 	delete scene;
+	delete pacer;
 	delete cc;
 	delete dc;
 	delete gc;
@@ -135,10 +189,44 @@ void GEApplication::swapFullScreen()
 	else
 	{
 		windowPos.fullScreen = false;
-		glfwSetWindowMonitor(window, nullptr, windowPos.Xpos, windowPos.Ypos, windowPos.width, windowPos.height, NULL);
+		glfwSetWindowMonitor(window, nullptr, windowPos.Xpos, windowPos.Ypos, windowPos.width, windowPos.height, GLFW_DONT_CARE);
+	}
+}
+
+/**
+ * @brief Pasa al siguiente modo de presentación admitido.
+ */
+void GEApplication::nextPresentMode()
+{
+	const VkPresentModeKHR modes[] = { VK_PRESENT_MODE_FIFO_KHR, VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR };
+	const int modeCount = 3;
+
+	int current = 0;
+	for (int i = 0; i < modeCount; i++)
+	{
+		if (modes[i] == dc->getPresentMode()) current = i;
+	}
+	for (int i = 1; i < modeCount; i++)
+	{
+		VkPresentModeKHR mode = modes[(current + i) % modeCount];
+		if (dc->isPresentModeSupported(mode))
+		{
+			dc->setPresentMode(mode);
+			resizePending = true;
+			return;
+		}
 	}
 }
 
+/**
+ * @brief Alterna el ritmo entre mínima latencia y máximo rendimiento.
+ */
+void GEApplication::swapPacing()
+{
+	pacer->setLatency(pacer->getLatency() == 1 ? dc->getFrameCount() : 1);
+	pacer->resetStats();
+}
+
 /**
  * @brief Respuesta a un evento de teclado sobre la aplicación.
  * @param window Ventana GLFW de tipo @ref GLFWwindow.
@@ -153,6 +241,8 @@ void GEApplication::keyCallback(GLFWwindow* window, int key, int scancode, int a
 	if (action == GLFW_PRESS || action == GLFW_REPEAT)
 	{
 		if (key == GLFW_KEY_F12) app->swapFullScreen();
+		else if (key == GLFW_KEY_F11 && action == GLFW_PRESS) app->nextPresentMode();
+		else if (key == GLFW_KEY_F10 && action == GLFW_PRESS) app->swapPacing();
 		else app->scene->key_action(key, true);
 	}
 	else app->scene->key_action(key, false);
@@ -188,10 +278,7 @@ void GEApplication::cursorPositionCallback(GLFWwindow* window, double xpos, doub
 void GEApplication::framebufferResizeCallback(GLFWwindow* window, int width, int height)
 {
 	GEApplication* app = (GEApplication*)glfwGetWindowUserPointer(window);
-	if (height != 0)
-	{
-		app->resize();
-	}
+	app->resizePending = true;
 }
 
 /**
@@ -199,23 +286,39 @@ void GEApplication::framebufferResizeCallback(GLFWwindow* window, int width, int
  */
 void GEApplication::resize()
 {
+	int width, height;
+	glfwGetFramebufferSize(window, &width, &height);
+	if (width == 0 || height == 0) return;
+	resizePending = false;
+
+#ifdef DEBUG
+	double startTime = glfwGetTime();
+#endif
+
 	if (!windowPos.fullScreen)
 	{
 		glfwGetWindowSize(window, &windowPos.width, &windowPos.height);
 		glfwGetWindowPos(window, &windowPos.Xpos, &windowPos.Ypos);
 	}
 
+	// Los framebuffers y el swapchain pueden estar en uso por frames anteriores
+	vkDeviceWaitIdle(gc->device);
 	dc->recreate(gc, windowPos);
-	cc->destroy(gc);
-	delete cc;
-
-	this->cc = new GECommandContext(this->gc, this->dc->getImageCount());
 
+	// Los command buffers son por frame en vuelo: se conservan aunque cambie el número de imágenes
 	scene->recreate(gc, dc, cc);
+	// Las imágenes del tamaño anterior pueden haber dejado un bloque vacío
+	gc->allocator->trim();
 
 	double aspect;
 	if (!windowPos.fullScreen) aspect = (double)this->windowPos.width / (double)this->windowPos.height;
 	else aspect = (double)this->windowPos.screenWidth / (double)this->windowPos.screenHeight;
 	this->scene->aspect_ratio(aspect);
+
+#ifdef DEBUG
+	std::cout << "[Resize] " << width << "x" << height << ": " << (glfwGetTime() - startTime) * 1000.0 << " ms"
+		<< ", modo: " << GEDrawingContext::getPresentModeName(dc->getPresentMode()) << std::endl;
+	pacer->resetStats();
+#endif
 }
 
@@ -11,10 +11,13 @@
 #include "GEGraphicsContext.h"
 #include "GEDrawingContext.h"
 #include "GECommandContext.h"
+#include "GEFramePacer.h"
 #include "GEScene.h"
 
 const int WIDTH = 800;
 const int HEIGHT = 600;
+const VkPresentModeKHR PRESENT_MODE = VK_PRESENT_MODE_MAILBOX_KHR; ///< Modo de presentación inicial (FIFO si la superficie no lo admite; F11 lo cambia).
+const uint32_t PACING_LATENCY = 1; ///< Frames que pueden seguir en la GPU al leer la entrada (1: mínima latencia; FRAMES_IN_FLIGHT: máximo rendimiento; F10 alterna).
 
 /**
  * @class GEApplication
@@ -23,6 +26,13 @@ const int HEIGHT = 600;
 class GEApplication
 {
 public:
+	/**
+	 * @brief Crea la aplicación (la ventana se abre en run()).
+	 * @param pushTransforms Envía la matriz Model de las figuras por push constants (false: por el buffer de uniformes).
+	 * @param meshPath Fichero .gem que se dibuja junto al esqueleto (vacío: ninguno).
+	 */
+	GEApplication(bool pushTransforms = PUSH_TRANSFORMS, const std::string& meshPath = "");
+
 	/**
 	 * @brief Ejecuta la aplicación.
 	 */
@@ -35,6 +45,10 @@ private:
 	GEDrawingContext* dc;
 	GECommandContext* cc;
 	GEScene* scene;
+	GEFramePacer* pacer; ///< Ritmo del bucle principal y medida de la latencia de entrada.
+	bool resizePending; ///< Hay un cambio de tamaño sin aplicar (los eventos se agrupan hasta el siguiente frame).
+	bool pushTransforms; ///< Modo de envío de la matriz Model con el que se crea la escena.
+	std::string meshPath; ///< Fichero .gem que carga la escena (vacío: ninguno).
 
 	// ===== Métodos principales =====
 	/**
@@ -69,8 +83,22 @@ private:
 	 */
 	void swapFullScreen();
 
+	/**
+	 * @brief Pasa al siguiente modo de presentación admitido (FIFO, MAILBOX, IMMEDIATE).
+	 *
+	 * El swapchain se reconstruye en el siguiente frame, como en un cambio de tamaño.
+	 */
+	void nextPresentMode();
+
+	/**
+	 * @brief Alterna el ritmo entre mínima latencia (k = 1) y máximo rendimiento (k = frames en vuelo).
+	 */
+	void swapPacing();
+
 	/**
 	 * @brief Reconstruye los objetos con el nuevo tamaño de ventana.
+	 *
+	 * Si la ventana está minimizada no hace nada y el cambio sigue pendiente.
 	 */
 	void resize();
 
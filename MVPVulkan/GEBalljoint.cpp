@@ -31,8 +31,10 @@ GEBalljoint::GEBalljoint(float l)
     angles[1] = 0.0f;
     angles[2] = 0.0f;
 
-    joint = nullptr;
-    bone = nullptr;
+    renderer = nullptr;
+    meshCache = nullptr;
+    jointLod = {};
+    boneLod = {};
 
     worldMatrix = glm::mat4(1.0f);
 
@@ -75,8 +77,10 @@ GEBalljoint::GEBalljoint(const std::string &name, float length,
     angles[1] = 0.0f;
     angles[2] = 0.0f;
 
-    joint = nullptr;
-    bone = nullptr;
+    renderer = nullptr;
+    meshCache = nullptr;
+    jointLod = {};
+    boneLod = {};
     worldMatrix = glm::mat4(1.0f);
 
     limits.enabled = false;
@@ -147,11 +151,11 @@ void GEBalljoint::ComputeMatrix()
 
     worldMatrix = jointm * posem;
 
-    if (joint && bone)
+    if (renderer)
     {
-        joint->setLocation(worldMatrix);
+        renderer->setLocation(jointInstance, worldMatrix);
         glm::mat4 mm = glm::translate(worldMatrix, glm::vec3(0.0f, 0.0f, length / 2));
-        bone->setLocation(mm);
+        renderer->setLocation(boneInstance, glm::scale(mm, glm::vec3(1.0f, 1.0f, length)));
     }
 }
 
@@ -200,30 +204,35 @@ void GEBalljoint::ComputeMatrix(glm::mat4 parentMatrix)
 
     worldMatrix = parentMatrix * orientationMatrix * poseMatrix;
 
-    if (joint && bone)
+    if (renderer)
     {
-        joint->setLocation(worldMatrix);
+        renderer->setLocation(jointInstance, worldMatrix);
+        // El cilindro compartido mide 1; la longitud del hueso se aplica como escala en Z
         glm::mat4 boneMatrix = glm::translate(worldMatrix, glm::vec3(0.0f, 0.0f, length / 2));
-        bone->setLocation(boneMatrix);
+        renderer->setLocation(boneInstance, glm::scale(boneMatrix, glm::vec3(1.0f, 1.0f, length)));
     }
 }
 
 /**
- * @brief Inicializa las piezas de la articulación.
+ * @brief Registra las piezas de la articulación como instancias.
  * @param gc Contexto gráfico.
- * @param rc Contexto de renderizado.
+ * @param cache Caché de mallas compartidas.
+ * @param r Renderizador de instancias.
  */
-void GEBalljoint::initialize(GEGraphicsContext *gc, GERenderingContext *rc)
+void GEBalljoint::initialize(GEGraphicsContext *gc, GEMeshCache *cache, GEInstanceRenderer *r)
 {
+    renderer = r;
+    meshCache = cache;
+    jointLod = cache->getSphereLod(gc, 10, 20, 0.05f, JOINT_LOD_LEVELS);
+    boneLod = cache->getCylinderLod(gc, 2, 10, 0.03f, 0.5f, JOINT_LOD_LEVELS);
+
     GEMaterial jointMat = {};
     jointMat.Ka = glm::vec3(1.0f, 0.0f, 0.0f);
     jointMat.Kd = glm::vec3(1.0f, 0.0f, 0.0f);
     jointMat.Ks = glm::vec3(0.8f, 0.8f, 0.8f);
     jointMat.Shininess = 16.0f;
 
-    joint = new GESphere(10, 20, 0.05f);
-    joint->initialize(gc, rc);
-    joint->setMaterial(jointMat);
+    jointInstance = renderer->addInstance(jointLod, renderer->addMaterial(jointMat));
 
     GEMaterial boneMat = {};
     boneMat.Ka = glm::vec3(0.0f, 0.0f, 0.8f);
@@ -231,9 +240,7 @@ void GEBalljoint::initialize(GEGraphicsContext *gc, GERenderingContext *rc)
     boneMat.Ks = glm::vec3(0.8f, 0.8f, 0.8f);
     boneMat.Shininess = 16.0f;
 
-    bone = new GECylinder(2, 10, 0.03f, length / 2);
-    bone->initialize(gc, rc);
-    bone->setMaterial(boneMat);
+    boneInstance = renderer->addInstance(boneLod, renderer->addMaterial(boneMat));
 
     ComputeMatrix();
 }
@@ -241,67 +248,46 @@ void GEBalljoint::initialize(GEGraphicsContext *gc, GERenderingContext *rc)
 /**
  * @brief Inicializa recursivamente esta articulación y sus hijas.
  * @param gc Contexto gráfico.
- * @param rc Contexto de renderizado.
+ * @param cache Caché de mallas compartidas.
+ * @param r Renderizador de instancias.
  */
-void GEBalljoint::initializeRecursive(GEGraphicsContext *gc, GERenderingContext *rc)
+void GEBalljoint::initializeRecursive(GEGraphicsContext *gc, GEMeshCache *cache, GEInstanceRenderer *r)
 {
-    initialize(gc, rc);
+    initialize(gc, cache, r);
     for (GEBalljoint *child : children)
     {
-        child->initializeRecursive(gc, rc);
-    }
-}
-
-/**
- * @brief Actualiza las variables uniformes.
- * @param gc Contexto gráfico.
- * @param index Índice de la imagen.
- * @param view Matriz de vista.
- * @param projection Matriz de proyección.
- */
-void GEBalljoint::update(GEGraphicsContext *gc, uint32_t index, glm::mat4 view, glm::mat4 projection)
-{
-    if (joint && bone)
-    {
-        joint->update(gc, index, view, projection);
-        bone->update(gc, index, view, projection);
+        child->initializeRecursive(gc, cache, r);
     }
 }
 
 /**
  * @brief Actualiza recursivamente con matriz del padre.
  */
-void GEBalljoint::updateRecursive(GEGraphicsContext *gc, uint32_t index,
-                                  glm::mat4 parentMatrix, glm::mat4 view, glm::mat4 projection)
+void GEBalljoint::updateRecursive(glm::mat4 parentMatrix)
 {
     ComputeMatrix(parentMatrix);
-    update(gc, index, view, projection);
 
     glm::mat4 childBaseMatrix = getBoneEndMatrix();
     for (GEBalljoint *child : children)
     {
-        child->updateRecursive(gc, index, childBaseMatrix, view, projection);
+        child->updateRecursive(childBaseMatrix);
     }
 }
 
 /**
- * @brief Destruye los buffers de las piezas.
+ * @brief Libera las mallas de las piezas.
  * @param gc Contexto gráfico.
  */
 void GEBalljoint::destroy(GEGraphicsContext *gc)
 {
-    if (joint)
-    {
-        joint->destroy(gc);
-        delete joint;
-        joint = nullptr;
-    }
-    if (bone)
+    if (meshCache)
     {
-        bone->destroy(gc);
-        delete bone;
-        bone = nullptr;
+        meshCache->release(gc, jointLod);
+        meshCache->release(gc, boneLod);
+        jointLod = {};
+        boneLod = {};
     }
+    renderer = nullptr;
 }
 
 /**
@@ -396,54 +382,6 @@ void GEBalljoint::setLimits(glm::vec3 min, glm::vec3 max)
     limits.enabled = true;
 }
 
-/**
- * @brief Añade los comandos de dibujo.
- */
-void GEBalljoint::addCommands(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, int index)
-{
-    if (joint && bone)
-    {
-        joint->addCommands(commandBuffer, pipelineLayout, index);
-        bone->addCommands(commandBuffer, pipelineLayout, index);
-    }
-}
-
-/**
- * @brief Añade comandos recursivamente.
- */
-void GEBalljoint::addCommandsRecursive(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, int index)
-{
-    addCommands(commandBuffer, pipelineLayout, index);
-    for (GEBalljoint *child : children)
-    {
-        child->addCommandsRecursive(commandBuffer, pipelineLayout, index);
-    }
-}
-
-/**
- * @brief Asigna las propiedades de la luz.
- */
-void GEBalljoint::setLight(GELight l)
-{
-    if (joint && bone)
-    {
-        joint->setLight(l);
-        bone->setLight(l);
-    }
-}
-
-/**
- * @brief Asigna la luz recursivamente.
- */
-void GEBalljoint::setLightRecursive(GELight l)
-{
-    setLight(l);
-    for (GEBalljoint *child : children)
-    {
-        child->setLightRecursive(l);
-    }
-}
-
 /**
  * @brief Añade una articulación hija.
  */
@@ -7,15 +7,15 @@
 #pragma once
 
 #include "GEGraphicsContext.h"
-#include "GERenderingContext.h"
-#include "GESphere.h"
-#include "GECylinder.h"
-#include "GELight.h"
+#include "GEMeshCache.h"
+#include "GEInstanceRenderer.h"
 #include <glm/glm.hpp>
 #include <string>
 #include <vector>
 #include "DEBUG.h"
 
+const uint32_t JOINT_LOD_LEVELS = 3; ///< Niveles de detalle de las mallas de articulaciones y huesos.
+
 /**
  * @class GEBalljoint
  * @brief Representa una articulación esférica con 3 grados de libertad.
@@ -32,8 +32,12 @@ private:
     glm::vec3 up;         ///< Vector arriba local.
     glm::vec3 right;      ///< Vector derecha local.
     GLfloat angles[3];    ///< Ángulos de rotación (X, Y, Z).
-    GESphere *joint;      ///< Esfera que representa la articulación.
-    GECylinder *bone;     ///< Cilindro que representa el hueso.
+    GEInstanceRenderer *renderer;   ///< Renderizador que dibuja las piezas como instancias.
+    GEMeshCache *meshCache;         ///< Caché de la que proceden las mallas.
+    GEMeshLod jointLod;             ///< Niveles de detalle de la esfera que representa la articulación.
+    GEMeshLod boneLod;              ///< Niveles de detalle del cilindro unitario (escalado por length) que representa el hueso.
+    GEInstanceHandle jointInstance; ///< Instancia de la esfera en el renderizador.
+    GEInstanceHandle boneInstance;  ///< Instancia del cilindro en el renderizador.
 
     // ===== Jerarquía =====
     std::string name;                   ///< Nombre de la articulación.
@@ -90,73 +94,38 @@ public:
 
     // Ciclo de vida
     /**
-     * @brief Inicializa las piezas de la articulación.
+     * @brief Registra las piezas de la articulación como instancias.
      * @param gc Contexto gráfico.
-     * @param rc Contexto de renderizado.
+     * @param cache Caché de mallas compartidas.
+     * @param renderer Renderizador de instancias.
      */
-    void initialize(GEGraphicsContext *gc, GERenderingContext *rc);
+    void initialize(GEGraphicsContext *gc, GEMeshCache *cache, GEInstanceRenderer *renderer);
     /**
-     * @brief Destruye los buffers de las piezas.
+     * @brief Libera las mallas de las piezas.
      * @param gc Contexto gráfico.
      */
     void destroy(GEGraphicsContext *gc);
-    /**
-     * @brief Añade los comandos de dibujo.
-     * @param commandBuffer Buffer de comandos.
-     * @param pipelineLayout Layout del pipeline.
-     * @param index Índice de la imagen.
-     */
-    void addCommands(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, int index);
-    /**
-     * @brief Actualiza las variables uniformes.
-     * @param gc Contexto gráfico.
-     * @param index Índice de la imagen.
-     * @param view Matriz de vista.
-     * @param projection Matriz de proyección.
-     */
-    void update(GEGraphicsContext *gc, uint32_t index, glm::mat4 view, glm::mat4 projection);
 
     // Métodos recursivos
     /**
      * @brief Inicializa recursivamente esta articulación y sus hijas.
      * @param gc Contexto gráfico.
-     * @param rc Contexto de renderizado.
+     * @param cache Caché de mallas compartidas.
+     * @param renderer Renderizador de instancias.
      */
-    void initializeRecursive(GEGraphicsContext *gc, GERenderingContext *rc);
+    void initializeRecursive(GEGraphicsContext *gc, GEMeshCache *cache, GEInstanceRenderer *renderer);
     /**
      * @brief Destruye recursivamente esta articulación y sus hijas.
      * @param gc Contexto gráfico.
      */
     void destroyRecursive(GEGraphicsContext *gc);
-    /**
-     * @brief Añade comandos recursivamente.
-     * @param commandBuffer Buffer de comandos.
-     * @param pipelineLayout Layout del pipeline.
-     * @param index Índice de la imagen.
-     */
-    void addCommandsRecursive(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, int index);
     /**
      * @brief Actualiza recursivamente con matriz del padre.
-     * @param gc Contexto gráfico.
-     * @param index Índice de la imagen.
      * @param parentMatrix Matriz del padre.
-     * @param view Matriz de vista.
-     * @param projection Matriz de proyección.
-     */
-    void updateRecursive(GEGraphicsContext *gc, uint32_t index,
-                         glm::mat4 parentMatrix, glm::mat4 view, glm::mat4 projection);
-    /**
-     * @brief Asigna la luz recursivamente.
-     * @param l Propiedades de la luz.
      */
-    void setLightRecursive(GELight l);
+    void updateRecursive(glm::mat4 parentMatrix);
 
     // Setters
-    /**
-     * @brief Asigna las propiedades de la luz.
-     * @param l Propiedades de la luz.
-     */
-    void setLight(GELight l);
     /**
      * @brief Asigna la posición de la articulación.
      * @param loc Posición.
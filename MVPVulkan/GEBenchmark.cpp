@@ -0,0 +1,119 @@
+/**
+ * @file GEBenchmark.cpp
+ * @brief Implementación de la medida de rendimiento sin ventana.
+ */
+
+#include "GEBenchmark.h"
+
+#include "GEGraphicsContext.h"
+#include "GEOffscreenContext.h"
+#include "GECommandContext.h"
+#include "GEScene.h"
+
+#include <chrono>
+#include <iostream>
+
+/**
+ * @brief Dibuja los frames de calentamiento y los medidos con una escena.
+ * @param gc Contexto gráfico.
+ * @param dc Contexto de dibujo sin ventana.
+ * @param cc Contexto de comandos.
+ * @param scene Escena a dibujar.
+ * @param frames Frames medidos.
+ * @return Tiempo medio por frame (total y de CPU en GEScene::update()).
+ */
+static GEBenchmarkResult measureScene(GEGraphicsContext* gc, GEOffscreenContext* dc, GECommandContext* cc, GEScene* scene, uint32_t frames)
+{
+	std::chrono::steady_clock::time_point start;
+	double cpuSeconds = 0.0;
+	for (uint32_t i = 0; i < BENCHMARK_WARMUP_FRAMES + frames; i++)
+	{
+		if (i == BENCHMARK_WARMUP_FRAMES)
+		{
+			start = std::chrono::steady_clock::now();
+			cpuSeconds = 0.0;
+		}
+		dc->waitForNextImage(gc);
+		std::chrono::steady_clock::time_point updateStart = std::chrono::steady_clock::now();
+		scene->update(gc, dc->getCurrentFrame(), dc->getCurrentImage());
+		cpuSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - updateStart).count();
+		dc->submitGraphicsCommands(gc, cc->commandBuffers);
+		dc->submitPresentCommands(gc);
+	}
+	// Se cuenta hasta que la GPU termina el último frame
+	vkDeviceWaitIdle(gc->device);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	GEBenchmarkResult result;
+	result.frameMs = seconds * 1000.0 / frames;
+	result.cpuMs = cpuSeconds * 1000.0 / frames;
+	return result;
+}
+
+/**
+ * @brief Dibuja la escena sin ventana a varias resoluciones e imprime los FPS.
+ * @param frames Frames medidos por resolución.
+ * @param imagePrefix Prefijo de las imágenes guardadas (vacío: no se guardan).
+ */
+void runOffscreenBenchmark(uint32_t frames, const std::string& imagePrefix)
+{
+	const uint32_t resolutions[][2] = { { 640, 480 }, { 1280, 720 }, { 1920, 1080 }, { 3840, 2160 } };
+	const uint32_t resolutionCount = sizeof(resolutions) / sizeof(resolutions[0]);
+	// Primero el modo por defecto: es el que guarda la imagen
+	const bool transformModes[] = { PUSH_TRANSFORMS, !PUSH_TRANSFORMS };
+	if (frames == 0) frames = BENCHMARK_FRAMES;
+
+	// Sin ventana no se inicializa GLFW: la animación usa un paso fijo y los tiempos
+	// (también los de DEBUG en la escena) se miden con std::chrono::steady_clock
+	GEGraphicsContext* gc = new GEGraphicsContext(nullptr);
+	GEOffscreenContext* dc = new GEOffscreenContext(gc, resolutions[0][0], resolutions[0][1]);
+	GECommandContext* cc = new GECommandContext(gc, dc->getFrameCount());
+
+	for (uint32_t r = 0; r < resolutionCount; r++)
+	{
+		GEWindowPosition wpos = {};
+		wpos.width = (int)resolutions[r][0];
+		wpos.height = (int)resolutions[r][1];
+		wpos.screenWidth = wpos.width;
+		wpos.screenHeight = wpos.height;
+
+		if (r > 0)
+		{
+			vkDeviceWaitIdle(gc->device);
+			dc->recreate(gc, wpos);
+		}
+
+		// Una escena nueva por modo: cambia el pipeline y los sets de las figuras. Las dos
+		// empiezan la animación desde el principio con el mismo paso, así que dibujan lo mismo
+		std::cout << "[Benchmark] " << wpos.width << "x" << wpos.height << ":";
+		for (uint32_t m = 0; m < 2; m++)
+		{
+			GEScene* scene = new GEScene(gc, dc, cc, transformModes[m]);
+			scene->setFixedTimestep(BENCHMARK_TIMESTEP);
+
+			GEBenchmarkResult result = measureScene(gc, dc, cc, scene, frames);
+			std::cout << (m > 0 ? " |" : "") << " " << (transformModes[m] ? "push constants " : "UBO ")
+				<< 1000.0 / result.frameMs << " FPS, " << result.frameMs << " ms/frame, CPU "
+				<< result.cpuMs << " ms/frame";
+
+			if (m == 0 && !imagePrefix.empty())
+			{
+				std::string filename = imagePrefix + "_" + std::to_string(wpos.width) + "x" + std::to_string(wpos.height) + ".ppm";
+				if (!dc->saveImage(gc, filename))
+				{
+					std::cerr << std::endl << "No se pudo guardar " << filename;
+				}
+			}
+
+			scene->destroy(gc);
+			delete scene;
+		}
+		std::cout << std::endl;
+	}
+
+	cc->destroy(gc);
+	dc->destroy(gc);
+	delete cc;
+	delete dc;
+	delete gc;
+}
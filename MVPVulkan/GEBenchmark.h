@@ -0,0 +1,37 @@
+/**
+ * @file GEBenchmark.h
+ * @brief Declaración de la función que mide el rendimiento de la escena sin ventana.
+ */
+
+#pragma once
+
+#include <string>
+#include <stdint.h>
+
+const uint32_t BENCHMARK_FRAMES = 500; ///< Frames medidos por resolución si no se indica otro número.
+const uint32_t BENCHMARK_WARMUP_FRAMES = 20; ///< Frames que se dibujan antes de medir (cachés, primeras grabaciones).
+const double BENCHMARK_TIMESTEP = 1.0 / 60.0; ///< Paso fijo de la animación (segundos por frame).
+
+/**
+ * @struct GEBenchmarkResult
+ * @brief Tiempos medios por frame de una resolución y un modo.
+ */
+typedef struct
+{
+	double frameMs; ///< Tiempo total por frame, hasta que termina la GPU (ms).
+	double cpuMs;   ///< Tiempo de CPU por frame en GEScene::update(): uniformes y grabación (ms).
+} GEBenchmarkResult;
+
+/**
+ * @brief Dibuja la escena sin ventana a varias resoluciones e imprime los FPS.
+ *
+ * Cada resolución se mide dos veces, con las matrices Model por push constants y
+ * por el buffer de uniformes, y los tiempos de CPU se imprimen en la misma línea.
+ * Usa un GEGraphicsContext sin superficie y un GEOffscreenContext, así que funciona
+ * en servidores sin pantalla (p. ej. con lavapipe). Cada frame incluye la copia
+ * de la imagen al buffer de lectura. La animación avanza con un paso fijo y empieza
+ * desde el principio en cada medida, así que todas dibujan los mismos frames.
+ * @param frames Frames medidos por resolución.
+ * @param imagePrefix Si no está vacío, guarda la última imagen de cada resolución (modo por defecto) en "<prefijo>_<ancho>x<alto>.ppm".
+ */
+void runOffscreenBenchmark(uint32_t frames, const std::string& imagePrefix);
@@ -16,12 +16,12 @@
 /**
  * @brief Construye los buffers de comandos.
  * @param gc Contexto gráfico.
- * @param imageCount Número de imágenes del swapchain.
+ * @param frameCount Número de frames en vuelo.
  */
-GECommandContext::GECommandContext(GEGraphicsContext* gc, uint32_t imageCount)
+GECommandContext::GECommandContext(GEGraphicsContext* gc, uint32_t frameCount)
 {
 	createCommandPool(gc);
-	createCommandBuffers(gc, imageCount);
+	createCommandBuffers(gc, frameCount);
 }
 
 /**
@@ -51,6 +51,8 @@ void GECommandContext::createCommandPool(GEGraphicsContext* gc)
 	VkCommandPoolCreateInfo poolInfo{};
 	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
 	poolInfo.queueFamilyIndex = gc->graphicsQueueFamilyIndex;
+	// Los buffers se vuelven a grabar por separado (recreate y push constants)
+	poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 
 	if (vkCreateCommandPool(gc->device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS)
 	{
@@ -63,17 +65,17 @@ void GECommandContext::createCommandPool(GEGraphicsContext* gc)
  * 
  * El contenido de los buffers incluye la orden de dibujar.
  * @param gc Contexto gráfico.
- * @param imageCount Número de imágenes del swapchain.
+ * @param frameCount Número de frames en vuelo.
  */
-void GECommandContext::createCommandBuffers(GEGraphicsContext* gc, uint32_t imageCount)
+void GECommandContext::createCommandBuffers(GEGraphicsContext* gc, uint32_t frameCount)
 {
-	commandBuffers.resize(imageCount);
+	commandBuffers.resize(frameCount);
 
 	VkCommandBufferAllocateInfo allocInfo = {};
 	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
 	allocInfo.commandPool = commandPool;
 	allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-	allocInfo.commandBufferCount = imageCount;
+	allocInfo.commandBufferCount = frameCount;
 
 	if (vkAllocateCommandBuffers(gc->device, &allocInfo, commandBuffers.data()) != VK_SUCCESS)
 	{
@@ -12,19 +12,19 @@
 
 /**
  * @class GECommandContext
- * @brief Clase que almacena los buffers de comandos vinculados a cada imagen de la swapchain.
+ * @brief Clase que almacena los buffers de comandos de cada frame en vuelo.
  */
 class GECommandContext
 {
 public:
-	std::vector<VkCommandBuffer> commandBuffers;  ///< Buffers de comandos por imagen.
+	std::vector<VkCommandBuffer> commandBuffers;  ///< Buffers de comandos por frame en vuelo.
 
 	/**
 	 * @brief Construye los buffers de comandos.
 	 * @param gc Contexto gráfico.
-	 * @param imageCount Número de imágenes de la swapchain.
+	 * @param frameCount Número de frames en vuelo.
 	 */
-	GECommandContext(GEGraphicsContext* gc, uint32_t imageCount);
+	GECommandContext(GEGraphicsContext* gc, uint32_t frameCount);
 
 	/**
 	 * @brief Destruye los buffers de comandos.
@@ -44,8 +44,8 @@ private:
 	/**
 	 * @brief Crea los buffers de comandos que se enviarán a la cola gráfica.
 	 * @param gc Contexto gráfico.
-	 * @param imageCount Número de imágenes del swapchain.
+	 * @param frameCount Número de frames en vuelo.
 	 */
-	void createCommandBuffers(GEGraphicsContext* gc, uint32_t imageCount);
+	void createCommandBuffers(GEGraphicsContext* gc, uint32_t frameCount);
 };
 
@@ -0,0 +1,229 @@
+/**
+ * @file GECommandRecorder.cpp
+ * @brief Implementación de la clase GECommandRecorder.
+ */
+
+#include "GECommandRecorder.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * @brief Crea los command pools y arranca los hilos.
+ * @param gc Contexto gráfico.
+ * @param frameCount Número de frames en vuelo.
+ * @param threadCount Número de hilos que graban.
+ */
+GECommandRecorder::GECommandRecorder(GEGraphicsContext* gc, uint32_t frameCount, uint32_t threadCount)
+{
+	device = gc->device;
+	generation = 0;
+	pending = 0;
+	quit = false;
+	function = nullptr;
+	inheritance = {};
+	frameIndex = 0;
+	drawCount = 0;
+	activeThreads = 0;
+
+	// Un command pool solo puede usarse desde un hilo a la vez: cada worker tiene los suyos
+	workers.resize(std::max(threadCount, 1u));
+	for (Worker& worker : workers)
+	{
+		worker.pools.resize(frameCount);
+		worker.buffers.resize(frameCount);
+		for (uint32_t i = 0; i < frameCount; i++)
+		{
+			VkCommandPoolCreateInfo poolInfo = {};
+			poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+			poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+			poolInfo.queueFamilyIndex = gc->graphicsQueueFamilyIndex;
+
+			if (vkCreateCommandPool(device, &poolInfo, nullptr, &worker.pools[i]) != VK_SUCCESS)
+			{
+				throw std::runtime_error("failed to create recording command pool!");
+			}
+
+			VkCommandBufferAllocateInfo allocInfo = {};
+			allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocInfo.commandPool = worker.pools[i];
+			allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+			allocInfo.commandBufferCount = 1;
+
+			if (vkAllocateCommandBuffers(device, &allocInfo, &worker.buffers[i]) != VK_SUCCESS)
+			{
+				throw std::runtime_error("failed to allocate secondary command buffer!");
+			}
+		}
+	}
+
+	for (uint32_t id = 1; id < (uint32_t)workers.size(); id++)
+	{
+		threads.emplace_back(&GECommandRecorder::threadMain, this, id);
+	}
+}
+
+/**
+ * @brief Graba una lista de draws en buffers secundarios y los ejecuta en el primario.
+ * @param primary Buffer de comandos primario.
+ * @param rc Contexto de renderizado.
+ * @param frame Índice del frame.
+ * @param image Índice de la imagen.
+ * @param drawCount Número de draws de la lista.
+ * @param function Función que graba cada tramo.
+ */
+void GECommandRecorder::record(VkCommandBuffer primary, GERenderingContext* rc, uint32_t frame, uint32_t image, uint32_t drawCount, const RecordFunction& function)
+{
+	// Con pocos draws sale más barato grabarlos en un solo hilo
+	uint32_t useful = std::max((drawCount + RECORDING_MIN_DRAWS - 1) / RECORDING_MIN_DRAWS, 1u);
+	uint32_t active = std::min(useful, (uint32_t)workers.size());
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		this->function = &function;
+		this->inheritance = rc->getInheritanceInfo(image);
+		this->frameIndex = frame;
+		this->drawCount = drawCount;
+		this->activeThreads = active;
+		this->pending = active - 1;
+		this->error = nullptr;
+		generation++;
+	}
+	if (active > 1) startCondition.notify_all();
+
+	std::exception_ptr localError;
+	try
+	{
+		recordSlice(0);
+	}
+	catch (...)
+	{
+		localError = std::current_exception();
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		doneCondition.wait(lock, [this] { return pending == 0; });
+		this->function = nullptr;
+		if (!localError) localError = error;
+	}
+	if (localError) std::rethrow_exception(localError);
+
+	std::vector<VkCommandBuffer> secondaries(active);
+	for (uint32_t id = 0; id < active; id++)
+	{
+		secondaries[id] = workers[id].buffers[frame];
+	}
+	vkCmdExecuteCommands(primary, active, secondaries.data());
+}
+
+/**
+ * @brief Obtiene el número de hilos disponibles para grabar.
+ * @return Número de workers.
+ */
+uint32_t GECommandRecorder::getThreadCount() const
+{
+	return (uint32_t)workers.size();
+}
+
+/**
+ * @brief Obtiene el número de hilos que grabaron en el último record().
+ * @return Número de buffers secundarios ejecutados.
+ */
+uint32_t GECommandRecorder::getActiveThreads() const
+{
+	return activeThreads;
+}
+
+/**
+ * @brief Detiene los hilos y destruye los command pools.
+ * @param gc Contexto gráfico.
+ */
+void GECommandRecorder::destroy(GEGraphicsContext* gc)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+	}
+	startCondition.notify_all();
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+	threads.clear();
+
+	// Destruir el pool libera también sus command buffers
+	for (Worker& worker : workers)
+	{
+		for (VkCommandPool pool : worker.pools)
+		{
+			vkDestroyCommandPool(gc->device, pool, nullptr);
+		}
+	}
+	workers.clear();
+}
+
+/**
+ * @brief Bucle de un hilo auxiliar.
+ * @param id Índice del worker.
+ */
+void GECommandRecorder::threadMain(uint32_t id)
+{
+	uint64_t seen = 0;
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true)
+	{
+		startCondition.wait(lock, [this, seen] { return quit || generation != seen; });
+		if (quit) return;
+		seen = generation;
+		if (id >= activeThreads) continue;
+
+		lock.unlock();
+		std::exception_ptr localError;
+		try
+		{
+			recordSlice(id);
+		}
+		catch (...)
+		{
+			localError = std::current_exception();
+		}
+		lock.lock();
+
+		if (localError && !error) error = localError;
+		if (--pending == 0) doneCondition.notify_one();
+	}
+}
+
+/**
+ * @brief Graba el tramo de un worker en su buffer secundario.
+ * @param id Índice del worker.
+ */
+void GECommandRecorder::recordSlice(uint32_t id)
+{
+	// Tramos consecutivos del mismo tamaño (el último puede ser menor)
+	uint32_t sliceSize = (drawCount + activeThreads - 1) / activeThreads;
+	uint32_t first = std::min(id * sliceSize, drawCount);
+	uint32_t count = std::min(sliceSize, drawCount - first);
+
+	// Resetear el pool entero es más barato que resetear cada buffer
+	vkResetCommandPool(device, workers[id].pools[frameIndex], 0);
+
+	VkCommandBuffer commandBuffer = workers[id].buffers[frameIndex];
+	VkCommandBufferBeginInfo beginInfo = {};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+	beginInfo.pInheritanceInfo = &inheritance;
+
+	if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to begin recording secondary command buffer!");
+	}
+
+	(*function)(commandBuffer, first, count);
+
+	if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to record secondary command buffer!");
+	}
+}
@@ -0,0 +1,121 @@
+/**
+ * @file GECommandRecorder.h
+ * @brief Declaración de la clase GECommandRecorder que graba command buffers secundarios en paralelo.
+ */
+
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include "GEGraphicsContext.h"
+#include "GERenderingContext.h"
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+const uint32_t RECORDING_MIN_DRAWS = 256; ///< Draws mínimos por hilo (con menos no compensa repartir la grabación).
+
+/**
+ * @class GECommandRecorder
+ * @brief Reparte la grabación de una lista de draws entre varios hilos.
+ *
+ * Cada hilo tiene un command pool por frame en vuelo y graba un command
+ * buffer secundario con un tramo consecutivo de la lista; el buffer primario los
+ * ejecuta en orden, así que el orden de los draws se conserva. El hilo que llama
+ * a record() graba el primer tramo y los demás esperan en una variable de
+ * condición entre frame y frame.
+ *
+ * Los buffers secundarios no heredan el estado del primario: cada tramo debe
+ * enlazar su pipeline y sus descriptor sets.
+ */
+class GECommandRecorder
+{
+public:
+	/**
+	 * @brief Función que graba los draws [first, first + count) en un buffer secundario.
+	 */
+	typedef std::function<void(VkCommandBuffer commandBuffer, uint32_t first, uint32_t count)> RecordFunction;
+
+	/**
+	 * @brief Crea los command pools y arranca los hilos.
+	 * @param gc Contexto gráfico.
+	 * @param frameCount Número de frames en vuelo.
+	 * @param threadCount Número de hilos que graban (incluido el que llama a record()).
+	 */
+	GECommandRecorder(GEGraphicsContext* gc, uint32_t frameCount, uint32_t threadCount);
+
+	/**
+	 * @brief Graba una lista de draws en buffers secundarios y los ejecuta en el primario.
+	 *
+	 * El buffer primario debe haber empezado el render pass con
+	 * VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS. Los buffers secundarios del
+	 * frame no pueden estar pendientes de ejecución.
+	 * @param primary Buffer de comandos primario.
+	 * @param rc Contexto de renderizado (render pass y framebuffer heredados).
+	 * @param frame Índice del frame (command pools).
+	 * @param image Índice de la imagen (framebuffer).
+	 * @param drawCount Número de draws de la lista.
+	 * @param function Función que graba cada tramo.
+	 */
+	void record(VkCommandBuffer primary, GERenderingContext* rc, uint32_t frame, uint32_t image, uint32_t drawCount, const RecordFunction& function);
+
+	/**
+	 * @brief Obtiene el número de hilos disponibles para grabar.
+	 * @return Número de workers (incluido el hilo que llama a record()).
+	 */
+	uint32_t getThreadCount() const;
+
+	/**
+	 * @brief Obtiene el número de hilos que grabaron en el último record().
+	 * @return Número de buffers secundarios ejecutados.
+	 */
+	uint32_t getActiveThreads() const;
+
+	/**
+	 * @brief Detiene los hilos y destruye los command pools.
+	 * @param gc Contexto gráfico.
+	 */
+	void destroy(GEGraphicsContext* gc);
+
+private:
+	/**
+	 * @struct Worker
+	 * @brief Command pools y buffers secundarios de un hilo.
+	 */
+	struct Worker
+	{
+		std::vector<VkCommandPool> pools;      ///< Un pool por frame en vuelo (se resetea entero cada vez que se usa).
+		std::vector<VkCommandBuffer> buffers;  ///< Buffer secundario de cada frame.
+	};
+
+	VkDevice device;                   ///< Dispositivo lógico.
+	std::vector<Worker> workers;       ///< Recursos de cada hilo (el 0 es el que llama a record()).
+	std::vector<std::thread> threads;  ///< Hilos auxiliares (workers 1..n-1).
+	std::mutex mutex;                  ///< Protege el estado del trabajo en curso.
+	std::condition_variable startCondition; ///< Avisa a los hilos de que hay un trabajo nuevo.
+	std::condition_variable doneCondition;  ///< Avisa al hilo principal de que han terminado.
+	uint64_t generation;               ///< Número del trabajo en curso.
+	uint32_t pending;                  ///< Hilos auxiliares que no han terminado el trabajo en curso.
+	bool quit;                         ///< Los hilos deben terminar.
+	std::exception_ptr error;          ///< Primera excepción lanzada por un hilo auxiliar.
+
+	const RecordFunction* function;    ///< Función del trabajo en curso.
+	VkCommandBufferInheritanceInfo inheritance; ///< Render pass y framebuffer del trabajo en curso.
+	uint32_t frameIndex;               ///< Frame del trabajo en curso.
+	uint32_t drawCount;                ///< Draws del trabajo en curso.
+	uint32_t activeThreads;            ///< Hilos que participan en el trabajo en curso.
+
+	/**
+	 * @brief Bucle de un hilo auxiliar.
+	 * @param id Índice del worker.
+	 */
+	void threadMain(uint32_t id);
+
+	/**
+	 * @brief Graba el tramo de un worker en su buffer secundario.
+	 * @param id Índice del worker.
+	 */
+	void recordSlice(uint32_t id);
+};
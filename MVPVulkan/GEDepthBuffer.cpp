@@ -37,17 +37,11 @@ GEDepthBuffer::GEDepthBuffer(GEGraphicsContext* gc, VkExtent2D extent)
 	VkMemoryRequirements memRequirements;
 	vkGetImageMemoryRequirements(gc->device, image, &memRequirements);
 
-	VkMemoryAllocateInfo allocInfo = {};
-	allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-	allocInfo.allocationSize = memRequirements.size;
-	allocInfo.memoryTypeIndex = gc->findMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	// Imagen con tiling óptimo: recurso no lineal para el asignador
+	uint32_t memoryType = gc->findMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	allocation = gc->allocator->allocate(memRequirements, memoryType, false);
 
-	if (vkAllocateMemory(gc->device, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS)
-	{
-		throw std::runtime_error("failed to allocate depth buffer image memory!");
-	}
-
-	vkBindImageMemory(gc->device, image, imageMemory, 0);
+	vkBindImageMemory(gc->device, image, allocation.memory, allocation.offset);
 
 	VkImageViewCreateInfo viewInfo = {};
 	viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -74,6 +68,6 @@ GEDepthBuffer::GEDepthBuffer(GEGraphicsContext* gc, VkExtent2D extent)
 void GEDepthBuffer::destroy(GEGraphicsContext* gc)
 {
 	vkDestroyImageView(gc->device, imageView, nullptr);
-	vkFreeMemory(gc->device, imageMemory, nullptr);
 	vkDestroyImage(gc->device, image, nullptr);
+	gc->allocator->free(allocation);
 }
\ No newline at end of file
@@ -16,7 +16,7 @@ class GEDepthBuffer
 {
 public:
 	VkImage image;            ///< Imagen de profundidad.
-	VkDeviceMemory imageMemory; ///< Memoria asociada a la imagen.
+	GEAllocation allocation;  ///< Rango de memoria asignado a la imagen.
 	VkImageView imageView;    ///< Vista de la imagen.
 
 	/**
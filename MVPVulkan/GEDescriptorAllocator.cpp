@@ -0,0 +1,158 @@
+/**
+ * @file GEDescriptorAllocator.cpp
+ * @brief Implementación de la clase GEDescriptorAllocator.
+ */
+
+#include "GEDescriptorAllocator.h"
+
+#include <stdexcept>
+
+/**
+ * @brief Tipos de descriptor que admite cada pool.
+ */
+static const VkDescriptorType POOL_DESCRIPTOR_TYPES[] = {
+	VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+	VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+	VK_DESCRIPTOR_TYPE_STORAGE_BUFFER
+};
+
+/**
+ * @brief Número medio de descriptores de cada tipo por conjunto.
+ */
+static const uint32_t DESCRIPTORS_PER_SET = 4;
+
+/**
+ * @brief Crea el asignador (sin pools).
+ * @param device Dispositivo lógico.
+ * @param setsPerPool Número de conjuntos de cada pool.
+ */
+GEDescriptorAllocator::GEDescriptorAllocator(VkDevice device, uint32_t setsPerPool)
+{
+	this->device = device;
+	this->setsPerPool = setsPerPool;
+	this->setCount = 0;
+}
+
+/**
+ * @brief Crea un pool nuevo y lo añade a la lista.
+ * @param maxSets Número máximo de conjuntos del pool.
+ * @return Pool creado.
+ */
+VkDescriptorPool GEDescriptorAllocator::createPool(uint32_t maxSets)
+{
+	std::vector<VkDescriptorPoolSize> poolSizes;
+	for (VkDescriptorType type : POOL_DESCRIPTOR_TYPES)
+	{
+		VkDescriptorPoolSize poolSize = {};
+		poolSize.type = type;
+		poolSize.descriptorCount = maxSets * DESCRIPTORS_PER_SET;
+		poolSizes.push_back(poolSize);
+	}
+
+	VkDescriptorPoolCreateInfo poolInfo = {};
+	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+	poolInfo.poolSizeCount = (uint32_t)poolSizes.size();
+	poolInfo.pPoolSizes = poolSizes.data();
+	poolInfo.maxSets = maxSets;
+
+	VkDescriptorPool pool;
+	if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &pool) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create descriptor pool!");
+	}
+
+	pools.push_back(pool);
+	return pool;
+}
+
+/**
+ * @brief Reserva un conjunto por cada layout.
+ * @param layouts Layouts de los conjuntos.
+ * @param sets Conjuntos reservados (salida).
+ * @return Pool del que se han obtenido los conjuntos.
+ */
+VkDescriptorPool GEDescriptorAllocator::allocate(const std::vector<VkDescriptorSetLayout>& layouts, VkDescriptorSet* sets)
+{
+	VkDescriptorSetAllocateInfo allocInfo = {};
+	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	allocInfo.descriptorSetCount = (uint32_t)layouts.size();
+	allocInfo.pSetLayouts = layouts.data();
+
+	// Un pool lleno o fragmentado devuelve error: se prueba con el siguiente
+	for (VkDescriptorPool pool : pools)
+	{
+		allocInfo.descriptorPool = pool;
+		if (vkAllocateDescriptorSets(device, &allocInfo, sets) == VK_SUCCESS)
+		{
+			setCount += allocInfo.descriptorSetCount;
+			return pool;
+		}
+	}
+
+	uint32_t maxSets = allocInfo.descriptorSetCount > setsPerPool ? allocInfo.descriptorSetCount : setsPerPool;
+	allocInfo.descriptorPool = createPool(maxSets);
+	if (vkAllocateDescriptorSets(device, &allocInfo, sets) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to allocate descriptor sets!");
+	}
+
+	setCount += allocInfo.descriptorSetCount;
+	return allocInfo.descriptorPool;
+}
+
+/**
+ * @brief Devuelve unos conjuntos a su pool.
+ * @param pool Pool devuelto por allocate().
+ * @param sets Conjuntos a liberar.
+ */
+void GEDescriptorAllocator::free(VkDescriptorPool pool, const std::vector<VkDescriptorSet>& sets)
+{
+	if (sets.empty()) return;
+
+	vkFreeDescriptorSets(device, pool, (uint32_t)sets.size(), sets.data());
+	setCount -= (uint32_t)sets.size();
+}
+
+/**
+ * @brief Libera a la vez todos los conjuntos de todos los pools.
+ */
+void GEDescriptorAllocator::reset()
+{
+	for (VkDescriptorPool pool : pools)
+	{
+		vkResetDescriptorPool(device, pool, 0);
+	}
+	setCount = 0;
+}
+
+/**
+ * @brief Obtiene el número de pools creados.
+ * @return Número de pools.
+ */
+uint32_t GEDescriptorAllocator::getPoolCount() const
+{
+	return (uint32_t)pools.size();
+}
+
+/**
+ * @brief Obtiene el número de conjuntos asignados.
+ * @return Número de conjuntos.
+ */
+uint32_t GEDescriptorAllocator::getSetCount() const
+{
+	return setCount;
+}
+
+/**
+ * @brief Destruye todos los pools.
+ */
+void GEDescriptorAllocator::destroy()
+{
+	for (VkDescriptorPool pool : pools)
+	{
+		vkDestroyDescriptorPool(device, pool, nullptr);
+	}
+	pools.clear();
+	setCount = 0;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file GEDescriptorAllocator.h
+ * @brief Declaración de la clase GEDescriptorAllocator que reparte descriptor sets entre varios pools.
+ */
+
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vector>
+
+/**
+ * @class GEDescriptorAllocator
+ * @brief Asignador de descriptor sets sobre una lista creciente de pools.
+ *
+ * Los conjuntos se reservan en el primer pool con espacio libre y solo se crea
+ * un pool nuevo cuando todos están llenos, de modo que el número de pools no
+ * crece con el número de objetos. Los pools admiten liberar conjuntos sueltos,
+ * así que el espacio de los objetos destruidos se reutiliza.
+ */
+class GEDescriptorAllocator
+{
+private:
+	VkDevice device;                        ///< Dispositivo lógico.
+	uint32_t setsPerPool;                   ///< Número de conjuntos de cada pool ordinario.
+	std::vector<VkDescriptorPool> pools;    ///< Pools creados.
+	uint32_t setCount;                      ///< Número de conjuntos asignados.
+
+	/**
+	 * @brief Crea un pool nuevo y lo añade a la lista.
+	 * @param maxSets Número máximo de conjuntos del pool.
+	 * @return Pool creado.
+	 */
+	VkDescriptorPool createPool(uint32_t maxSets);
+
+public:
+	/**
+	 * @brief Crea el asignador (sin pools).
+	 * @param device Dispositivo lógico.
+	 * @param setsPerPool Número de conjuntos de cada pool.
+	 */
+	GEDescriptorAllocator(VkDevice device, uint32_t setsPerPool);
+
+	/**
+	 * @brief Reserva un conjunto por cada layout.
+	 * @param layouts Layouts de los conjuntos.
+	 * @param sets Conjuntos reservados (salida, tantos como layouts).
+	 * @return Pool del que se han obtenido los conjuntos (necesario para liberarlos).
+	 */
+	VkDescriptorPool allocate(const std::vector<VkDescriptorSetLayout>& layouts, VkDescriptorSet* sets);
+
+	/**
+	 * @brief Devuelve unos conjuntos a su pool.
+	 * @param pool Pool devuelto por allocate().
+	 * @param sets Conjuntos a liberar.
+	 */
+	void free(VkDescriptorPool pool, const std::vector<VkDescriptorSet>& sets);
+
+	/**
+	 * @brief Libera a la vez todos los conjuntos de todos los pools.
+	 *
+	 * Pensado para conjuntos temporales que se vuelven a crear en cada frame.
+	 */
+	void reset();
+
+	/**
+	 * @brief Obtiene el número de pools creados.
+	 * @return Número de pools.
+	 */
+	uint32_t getPoolCount() const;
+
+	/**
+	 * @brief Obtiene el número de conjuntos asignados.
+	 * @return Número de conjuntos.
+	 */
+	uint32_t getSetCount() const;
+
+	/**
+	 * @brief Destruye todos los pools.
+	 */
+	void destroy();
+};
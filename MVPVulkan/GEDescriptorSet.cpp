@@ -6,6 +6,7 @@
 #include "GEDescriptorSet.h"
 
 #include "GEUniformBuffer.h"
+#include "GEUniformRing.h"
 #include <iostream>
 
 /**
@@ -15,77 +16,111 @@
  * @param ubos Vector de uniform buffers.
  */
 GEDescriptorSet::GEDescriptorSet(GEGraphicsContext* gc, GERenderingContext* rc, std::vector<GEUniformBuffer*> ubos)
+	: GEDescriptorSet(gc, rc->frameCount, rc->descriptorSetLayouts[0], ubos, std::vector<VkDescriptorType>(ubos.size(), VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER))
 {
-	uint32_t bufferCount = (uint32_t) ubos.size();
-	uint32_t imageCount = rc->imageCount;
-
-	std::vector<VkDescriptorPoolSize> poolSizes(bufferCount);
+}
 
-	for (uint32_t i = 0; i < bufferCount; i++)
-	{
-		VkDescriptorPoolSize poolSize = {};
-		poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		poolSize.descriptorCount = imageCount;
-		poolSizes[i] = poolSize;
-	}
+/**
+ * @brief Crea los conjuntos de descriptores sobre un layout y tipos concretos.
+ * @param gc Contexto gráfico.
+ * @param frameCount Número de frames en vuelo.
+ * @param layout Layout de los conjuntos de descriptores.
+ * @param buffers Buffers a enlazar (uno por binding, en orden).
+ * @param types Tipo de descriptor de cada binding.
+ */
+GEDescriptorSet::GEDescriptorSet(GEGraphicsContext* gc, uint32_t frameCount, VkDescriptorSetLayout layout, std::vector<GEUniformBuffer*> buffers, std::vector<VkDescriptorType> types)
+{
+	uint32_t bufferCount = (uint32_t) buffers.size();
 
-	VkDescriptorPoolCreateInfo poolInfo = {};
-	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-	poolInfo.poolSizeCount = (uint32_t)poolSizes.size();
-	poolInfo.pPoolSizes = poolSizes.data();
-	poolInfo.maxSets = imageCount;
+	allocateSets(gc, frameCount, layout);
 
-	if (vkCreateDescriptorPool(gc->device, &poolInfo, nullptr, &this->descriptorPool) != VK_SUCCESS)
+	for (size_t i = 0; i < frameCount; i++)
 	{
-		throw std::runtime_error("failed to create descriptor pool!");
-	}
+		std::vector<VkDescriptorBufferInfo> buffersInfo;
+		std::vector<VkWriteDescriptorSet> descriptorWrites;
+		buffersInfo.resize(bufferCount);
+		descriptorWrites.resize(bufferCount);
 
-	std::vector<VkDescriptorSetLayout> layouts(imageCount, rc->descriptorSetLayout);
-	VkDescriptorSetAllocateInfo allocInfo = {};
-	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-	allocInfo.descriptorPool = this->descriptorPool;
-	allocInfo.descriptorSetCount = imageCount;
-	allocInfo.pSetLayouts = layouts.data();
+		for (uint32_t j = 0; j < bufferCount; j++)
+		{
+			buffersInfo[j] = {};
+			buffersInfo[j].buffer = buffers[j]->buffers[i];
+			buffersInfo[j].offset = 0;
+			buffersInfo[j].range = buffers[j]->bufferSize;
 
-	descriptorSets.resize(imageCount);
+			descriptorWrites[j] = {};
+			descriptorWrites[j].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			descriptorWrites[j].dstSet = this->descriptorSets[i];
+			descriptorWrites[j].dstBinding = j;
+			descriptorWrites[j].dstArrayElement = 0;
+			descriptorWrites[j].descriptorType = types[j];
+			descriptorWrites[j].descriptorCount = 1;
+			descriptorWrites[j].pBufferInfo = &buffersInfo[j];
+		}
 
-	if (vkAllocateDescriptorSets(gc->device, &allocInfo, descriptorSets.data()) != VK_SUCCESS)
-	{
-		throw std::runtime_error("failed to allocate descriptor sets!");
+		vkUpdateDescriptorSets(gc->device, bufferCount, descriptorWrites.data(), 0, nullptr);
 	}
+}
 
-	for (size_t i = 0; i < imageCount; i++)
+/**
+ * @brief Crea los conjuntos de descriptores dinámicos sobre el buffer de uniformes compartido.
+ * @param gc Contexto gráfico.
+ * @param frameCount Número de frames en vuelo.
+ * @param layout Layout de los conjuntos de descriptores.
+ * @param ring Buffer de uniformes compartido.
+ * @param ranges Tamaño de la porción que ve cada binding.
+ */
+GEDescriptorSet::GEDescriptorSet(GEGraphicsContext* gc, uint32_t frameCount, VkDescriptorSetLayout layout, GEUniformRing* ring, std::vector<size_t> ranges)
+{
+	uint32_t bindingCount = (uint32_t) ranges.size();
+
+	allocateSets(gc, frameCount, layout);
+
+	for (size_t i = 0; i < frameCount; i++)
 	{
-		std::vector<VkDescriptorBufferInfo> buffersInfo;
-		buffersInfo.resize(bufferCount);
+		std::vector<VkDescriptorBufferInfo> buffersInfo(bindingCount);
+		std::vector<VkWriteDescriptorSet> descriptorWrites(bindingCount);
 
-		for (uint32_t j = 0; j < bufferCount; j++)
+		for (uint32_t j = 0; j < bindingCount; j++)
 		{
+			// El offset real de cada figura se indica al enlazar el conjunto
 			buffersInfo[j] = {};
-			buffersInfo[j].buffer = ubos[j]->buffers[i];
+			buffersInfo[j].buffer = ring->buffers[i];
 			buffersInfo[j].offset = 0;
-			buffersInfo[j].range = ubos[j]->bufferSize;
-		}
+			buffersInfo[j].range = ranges[j];
 
-		VkWriteDescriptorSet descriptorWrite = {};
-		descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		descriptorWrite.dstSet = this->descriptorSets[i];
-		descriptorWrite.dstBinding = 0;
-		descriptorWrite.dstArrayElement = 0;
-		descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		descriptorWrite.descriptorCount = (uint32_t)buffersInfo.size();
-		descriptorWrite.pBufferInfo = buffersInfo.data();
+			descriptorWrites[j] = {};
+			descriptorWrites[j].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			descriptorWrites[j].dstSet = this->descriptorSets[i];
+			descriptorWrites[j].dstBinding = j;
+			descriptorWrites[j].dstArrayElement = 0;
+			descriptorWrites[j].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+			descriptorWrites[j].descriptorCount = 1;
+			descriptorWrites[j].pBufferInfo = &buffersInfo[j];
+		}
 
-		vkUpdateDescriptorSets(gc->device, 1, &descriptorWrite, 0, nullptr);
+		vkUpdateDescriptorSets(gc->device, bindingCount, descriptorWrites.data(), 0, nullptr);
 	}
 }
 
 /**
- * @brief Destruye los conjuntos de descriptores.
+ * @brief Reserva un conjunto por frame en el asignador de descriptores compartido.
+ * @param gc Contexto gráfico.
+ * @param frameCount Número de frames en vuelo.
+ * @param layout Layout de los conjuntos de descriptores.
+ */
+void GEDescriptorSet::allocateSets(GEGraphicsContext* gc, uint32_t frameCount, VkDescriptorSetLayout layout)
+{
+	std::vector<VkDescriptorSetLayout> layouts(frameCount, layout);
+	descriptorSets.resize(frameCount);
+	descriptorPool = gc->descriptorAllocator->allocate(layouts, descriptorSets.data());
+}
+
+/**
+ * @brief Devuelve los conjuntos de descriptores al asignador compartido.
  * @param gc Contexto gráfico.
  */
 void GEDescriptorSet::destroy(GEGraphicsContext* gc) 
 {
-	vkFreeDescriptorSets(gc->device, descriptorPool, (uint32_t)descriptorSets.size(), descriptorSets.data());
-	vkDestroyDescriptorPool(gc->device, descriptorPool, nullptr);
+	gc->descriptorAllocator->free(descriptorPool, descriptorSets);
 }
@@ -11,6 +11,8 @@
 #include "GERenderingContext.h"
 #include "GEUniformBuffer.h"
 
+class GEUniformRing;
+
 /**
  * @class GEDescriptorSet
  * @brief Clase que describe un conjunto de descriptores.
@@ -18,10 +20,18 @@
 class GEDescriptorSet
 {
 private:
-	VkDescriptorPool descriptorPool; ///< Descriptor pool usado para asignar conjuntos.
+	VkDescriptorPool descriptorPool; ///< Pool del asignador compartido del que proceden los conjuntos.
+
+	/**
+	 * @brief Reserva un conjunto por frame en el asignador de descriptores compartido.
+	 * @param gc Contexto gráfico.
+	 * @param frameCount Número de frames en vuelo.
+	 * @param layout Layout de los conjuntos de descriptores.
+	 */
+	void allocateSets(GEGraphicsContext* gc, uint32_t frameCount, VkDescriptorSetLayout layout);
 
 public:
-	std::vector<VkDescriptorSet> descriptorSets; ///< Conjuntos de descriptores por imagen.
+	std::vector<VkDescriptorSet> descriptorSets; ///< Conjuntos de descriptores por frame.
 
 public:
 	/**
@@ -33,7 +43,27 @@ public:
 	GEDescriptorSet(GEGraphicsContext* gc, GERenderingContext* rc, std::vector<GEUniformBuffer*> ubos);
 
 	/**
-	 * @brief Destruye los conjuntos de descriptores y libera recursos.
+	 * @brief Crea los conjuntos de descriptores sobre un layout y tipos concretos.
+	 * @param gc Contexto gráfico.
+	 * @param frameCount Número de frames en vuelo.
+	 * @param layout Layout de los conjuntos de descriptores.
+	 * @param buffers Buffers a enlazar (uno por binding, en orden).
+	 * @param types Tipo de descriptor de cada binding.
+	 */
+	GEDescriptorSet(GEGraphicsContext* gc, uint32_t frameCount, VkDescriptorSetLayout layout, std::vector<GEUniformBuffer*> buffers, std::vector<VkDescriptorType> types);
+
+	/**
+	 * @brief Crea los conjuntos de descriptores dinámicos sobre el buffer de uniformes compartido.
+	 * @param gc Contexto gráfico.
+	 * @param frameCount Número de frames en vuelo.
+	 * @param layout Layout de los conjuntos de descriptores.
+	 * @param ring Buffer de uniformes compartido.
+	 * @param ranges Tamaño de la porción que ve cada binding.
+	 */
+	GEDescriptorSet(GEGraphicsContext* gc, uint32_t frameCount, VkDescriptorSetLayout layout, GEUniformRing* ring, std::vector<size_t> ranges);
+
+	/**
+	 * @brief Devuelve los conjuntos de descriptores al asignador compartido.
 	 * @param gc Contexto gráfico.
 	 */
 	void destroy(GEGraphicsContext* gc);
@@ -19,15 +19,35 @@
  * @brief Crea el contexto de dibujo (swapchain, vistas y sincronización).
  * @param gc Contexto gráfico.
  * @param wpos Posición y tamaño de la ventana.
+ * @param frameCount Número de frames en vuelo.
+ * @param presentMode Modo de presentación.
  */
-GEDrawingContext::GEDrawingContext(GEGraphicsContext* gc, GEWindowPosition wpos)
+GEDrawingContext::GEDrawingContext(GEGraphicsContext* gc, GEWindowPosition wpos, uint32_t frameCount, VkPresentModeKHR presentMode)
 {
+	this->frameCount = frameCount > 0 ? frameCount : 1;
+	this->requestedPresentMode = presentMode;
 	createSwapChain(gc, wpos);
 	createImageViews(gc->device);
 	createSyncObjects(gc->device);
 	createQueues(gc);
 }
 
+/**
+ * @brief Constructor para las subclases que no usan swapchain.
+ */
+GEDrawingContext::GEDrawingContext()
+{
+	imageCount = 0;
+	frameCount = 0;
+	imageFormat = VK_FORMAT_UNDEFINED;
+	imageExtent = {};
+	graphicsQueue = VK_NULL_HANDLE;
+	requestedPresentMode = VK_PRESENT_MODE_FIFO_KHR;
+	presentMode = VK_PRESENT_MODE_FIFO_KHR;
+	swapChain = VK_NULL_HANDLE;
+	presentQueue = VK_NULL_HANDLE;
+}
+
 /**
  * @brief Destruye los recursos del contexto de dibujo.
  * @param gc Contexto gráfico.
@@ -36,10 +56,10 @@ void GEDrawingContext::destroy(GEGraphicsContext* gc)
 {
 	for (size_t i = 0; i < frameCount; i++)
 	{
-		vkDestroySemaphore(gc->device, renderFinishedSemaphores[i], nullptr);
 		vkDestroySemaphore(gc->device, imageAvailableSemaphores[i], nullptr);
 		vkDestroyFence(gc->device, inFlightFences[i], nullptr);
 	}
+	destroyImageSemaphores(gc->device);
 
 	for (uint32_t i = 0; i < imageCount; i++)
 	{
@@ -63,6 +83,13 @@ void GEDrawingContext::recreate(GEGraphicsContext* gc, GEWindowPosition wpos)
 
 	createSwapChain(gc, wpos);
 	createImageViews(gc->device);
+
+	// El número de imágenes puede cambiar; el de frames en vuelo no
+	if (renderFinishedSemaphores.size() != imageCount)
+	{
+		destroyImageSemaphores(gc->device);
+		createImageSemaphores(gc->device);
+	}
 }
 
 /**
@@ -83,6 +110,15 @@ VkExtent2D GEDrawingContext::getExtent()
 	return imageExtent;
 }
 
+/**
+ * @brief Layout en el que el render pass deja las imágenes.
+ * @return VK_IMAGE_LAYOUT_PRESENT_SRC_KHR.
+ */
+VkImageLayout GEDrawingContext::getFinalLayout()
+{
+	return VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+}
+
 /**
  * @brief Obtiene el número de imágenes de la swapchain.
  * @return Número de imágenes.
@@ -101,6 +137,74 @@ uint32_t GEDrawingContext::getCurrentImage()
 	return currentImage;
 } 
 
+/**
+ * @brief Obtiene el número de frames en vuelo.
+ * @return Número de frames.
+ */
+uint32_t GEDrawingContext::getFrameCount()
+{
+	return frameCount;
+}
+
+/**
+ * @brief Obtiene el índice del frame actual.
+ * @return Índice del frame.
+ */
+uint32_t GEDrawingContext::getCurrentFrame()
+{
+	return currentFrame;
+}
+
+/**
+ * @brief Indica si la superficie admite un modo de presentación.
+ * @param mode Modo de presentación.
+ * @return true si se puede usar.
+ */
+bool GEDrawingContext::isPresentModeSupported(VkPresentModeKHR mode)
+{
+	if (mode == VK_PRESENT_MODE_FIFO_KHR) return true;
+	for (VkPresentModeKHR available : presentModes)
+	{
+		if (available == mode) return true;
+	}
+	return false;
+}
+
+/**
+ * @brief Pide un modo de presentación para el próximo recreate().
+ * @param mode Modo de presentación.
+ */
+void GEDrawingContext::setPresentMode(VkPresentModeKHR mode)
+{
+	requestedPresentMode = mode;
+}
+
+/**
+ * @brief Obtiene el modo de presentación del swapchain actual.
+ * @return Modo de presentación.
+ */
+VkPresentModeKHR GEDrawingContext::getPresentMode()
+{
+	return presentMode;
+}
+
+/**
+ * @brief Obtiene el nombre de un modo de presentación.
+ * @param mode Modo de presentación.
+ * @return Nombre del modo.
+ */
+const char* GEDrawingContext::getPresentModeName(VkPresentModeKHR mode)
+{
+	switch (mode)
+	{
+	case VK_PRESENT_MODE_IMMEDIATE_KHR: return "IMMEDIATE";
+	case VK_PRESENT_MODE_MAILBOX_KHR: return "MAILBOX";
+	case VK_PRESENT_MODE_FIFO_KHR: return "FIFO";
+	case VK_PRESENT_MODE_FIFO_RELAXED_KHR: return "FIFO_RELAXED";
+	default: return "desconocido";
+	}
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 /////                                                                                 /////
 /////                     M�todos de creaci�n de los componentes                      /////
@@ -116,7 +220,6 @@ void GEDrawingContext::createSwapChain(GEGraphicsContext* gc, GEWindowPosition w
 {
 	VkSurfaceCapabilitiesKHR capabilities;
 	std::vector<VkSurfaceFormatKHR> formats;
-	std::vector<VkPresentModeKHR> presentModes;
 
 	vkGetPhysicalDeviceSurfaceCapabilitiesKHR(gc->physicalDevice, gc->surface, &capabilities);
 
@@ -128,10 +231,22 @@ void GEDrawingContext::createSwapChain(GEGraphicsContext* gc, GEWindowPosition w
 		vkGetPhysicalDeviceSurfaceFormatsKHR(gc->physicalDevice, gc->surface, &formatCount, formats.data());
 	}
 
+	uint32_t presentModeCount;
+	vkGetPhysicalDeviceSurfacePresentModesKHR(gc->physicalDevice, gc->surface, &presentModeCount, nullptr);
+	presentModes.resize(presentModeCount);
+	if (presentModeCount != 0)
+	{
+		vkGetPhysicalDeviceSurfacePresentModesKHR(gc->physicalDevice, gc->surface, &presentModeCount, presentModes.data());
+	}
+
 	VkSurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(formats);
 	VkExtent2D extent = chooseSwapExtent(capabilities, wpos);
+	presentMode = chooseSwapPresentMode(presentModes);
 
-	imageCount = 4;
+	// Una imagen más que el mínimo: MAILBOX siempre tiene una libre para el siguiente
+	// frame y FIFO no bloquea a la CPU mientras espera al refresco. Cada imagen de
+	// más en la cola de FIFO es un frame más de latencia
+	imageCount = capabilities.minImageCount + 1;
 	if (capabilities.maxImageCount > 0 && imageCount > capabilities.maxImageCount)
 	{
 		imageCount = capabilities.maxImageCount;
@@ -171,7 +286,7 @@ void GEDrawingContext::createSwapChain(GEGraphicsContext* gc, GEWindowPosition w
 
 	createInfo.preTransform = capabilities.currentTransform;
 	createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
-	createInfo.presentMode = VK_PRESENT_MODE_FIFO_KHR;
+	createInfo.presentMode = presentMode;
 	createInfo.clipped = VK_TRUE;
 
 	if (vkCreateSwapchainKHR(gc->device, &createInfo, nullptr, &swapChain) != VK_SUCCESS)
@@ -226,11 +341,8 @@ void GEDrawingContext::createImageViews(VkDevice device)
  */
 void GEDrawingContext::createSyncObjects(VkDevice device)
 {
-	frameCount = imageCount - 1;
 	imageAvailableSemaphores.resize(frameCount);
-	renderFinishedSemaphores.resize(frameCount);
 	inFlightFences.resize(frameCount);
-	imagesInFlight.resize(images.size(), VK_NULL_HANDLE);
 
 	VkSemaphoreCreateInfo semaphoreInfo = {};
 	semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
@@ -242,12 +354,50 @@ void GEDrawingContext::createSyncObjects(VkDevice device)
 	for (size_t i = 0; i < frameCount; i++)
 	{
 		if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &imageAvailableSemaphores[i]) != VK_SUCCESS ||
-			vkCreateSemaphore(device, &semaphoreInfo, nullptr, &renderFinishedSemaphores[i]) != VK_SUCCESS ||
 			vkCreateFence(device, &fenceInfo, nullptr, &inFlightFences[i]) != VK_SUCCESS)
 		{
 			throw std::runtime_error("failed to create synchronization objects for a frame!");
 		}
 	}
+
+	createImageSemaphores(device);
+}
+
+/**
+ * @brief Crea los semáforos de render terminado, uno por imagen.
+ *
+ * El present de una imagen espera a su semáforo y no hay fence que indique cuándo
+ * lo ha consumido; solo es seguro volver a señalarlo cuando se adquiere de nuevo
+ * la misma imagen.
+ * @param device Dispositivo Vulkan.
+ */
+void GEDrawingContext::createImageSemaphores(VkDevice device)
+{
+	renderFinishedSemaphores.resize(imageCount);
+
+	VkSemaphoreCreateInfo semaphoreInfo = {};
+	semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+	for (uint32_t i = 0; i < imageCount; i++)
+	{
+		if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &renderFinishedSemaphores[i]) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to create synchronization objects for an image!");
+		}
+	}
+}
+
+/**
+ * @brief Destruye los semáforos de render terminado.
+ * @param device Dispositivo Vulkan.
+ */
+void GEDrawingContext::destroyImageSemaphores(VkDevice device)
+{
+	for (VkSemaphore semaphore : renderFinishedSemaphores)
+	{
+		vkDestroySemaphore(device, semaphore, nullptr);
+	}
+	renderFinishedSemaphores.clear();
 }
 
 /**
@@ -266,12 +416,28 @@ void GEDrawingContext::createQueues(GEGraphicsContext* gc)
 /////                                                                                 /////
 ///////////////////////////////////////////////////////////////////////////////////////////
 
+/**
+ * @brief Espera a que la GPU termine el frame N-k.
+ * @param gc Contexto gráfico.
+ * @param latency Frames k.
+ */
+void GEDrawingContext::waitForFrame(GEGraphicsContext* gc, uint32_t latency)
+{
+	uint32_t k = glm::clamp(latency, 1u, frameCount);
+	// currentFrame es el frame N (todavía sin enviar); los anteriores van hacia atrás
+	uint32_t frame = (currentFrame + frameCount - k) % frameCount;
+	vkWaitForFences(gc->device, 1, &inFlightFences[frame], VK_TRUE, UINT64_MAX);
+}
+
 /**
  * @brief Espera y adquiere la siguiente imagen disponible para render.
  * @param gc Contexto gráfico.
  */
 void GEDrawingContext::waitForNextImage(GEGraphicsContext* gc)
 {
+	// Los uniformes, descriptor sets y command buffers son del frame, no de la imagen:
+	// tras esperar a su fence se pueden reescribir. El uso de la imagen lo ordena en la
+	// GPU el semáforo de imagen disponible
 	vkWaitForFences(gc->device, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
 
 	uint32_t imageIndex;
@@ -285,21 +451,15 @@ void GEDrawingContext::waitForNextImage(GEGraphicsContext* gc)
 }
 
 /**
- * @brief Envía los comandos gráficos al dispositivo para la imagen actual.
+ * @brief Envía los comandos gráficos del frame actual al dispositivo.
  * @param gc Contexto gráfico.
- * @param commandBuffers Vector con los command buffers.
+ * @param commandBuffers Vector con los command buffers (uno por frame).
  */
 void GEDrawingContext::submitGraphicsCommands(GEGraphicsContext* gc, std::vector<VkCommandBuffer> commandBuffers)
 {
-	if (imagesInFlight[currentImage] != VK_NULL_HANDLE)
-	{
-		vkWaitForFences(gc->device, 1, &imagesInFlight[currentImage], VK_TRUE, UINT64_MAX);
-	}
-	imagesInFlight[currentImage] = inFlightFences[currentFrame];
-
 	VkSemaphore waitSemaphores[] = { imageAvailableSemaphores[currentFrame] };
 	VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-	VkSemaphore signalSemaphores[] = { renderFinishedSemaphores[currentFrame] };
+	VkSemaphore signalSemaphores[] = { renderFinishedSemaphores[currentImage] };
 
 	VkSubmitInfo submitInfo = {};
 	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
@@ -307,7 +467,7 @@ void GEDrawingContext::submitGraphicsCommands(GEGraphicsContext* gc, std::vector
 	submitInfo.pWaitSemaphores = waitSemaphores;
 	submitInfo.pWaitDstStageMask = waitStages;
 	submitInfo.commandBufferCount = 1;
-	submitInfo.pCommandBuffers = &commandBuffers[currentImage];
+	submitInfo.pCommandBuffers = &commandBuffers[currentFrame];
 	submitInfo.signalSemaphoreCount = 1;
 	submitInfo.pSignalSemaphores = signalSemaphores;
 
@@ -327,7 +487,7 @@ void GEDrawingContext::submitGraphicsCommands(GEGraphicsContext* gc, std::vector
  */
 void GEDrawingContext::submitPresentCommands(GEGraphicsContext* gc)
 {
-	VkSemaphore signalSemaphores[] = { renderFinishedSemaphores[currentFrame] };
+	VkSemaphore signalSemaphores[] = { renderFinishedSemaphores[currentImage] };
 	VkSwapchainKHR swapChains[] = { swapChain };
 
 	VkPresentInfoKHR presentInfo = {};
@@ -373,6 +533,24 @@ VkSurfaceFormatKHR GEDrawingContext::chooseSwapSurfaceFormat(const std::vector<V
 	return availableFormats[0];
 }
 
+/**
+ * @brief Escoge el modo de presentación pedido si la superficie lo admite.
+ * @param availablePresentModes Modos de presentación disponibles.
+ * @return Modo de presentación seleccionado (FIFO si el pedido no está disponible).
+ */
+VkPresentModeKHR GEDrawingContext::chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes)
+{
+	for (VkPresentModeKHR availablePresentMode : availablePresentModes)
+	{
+		if (availablePresentMode == requestedPresentMode)
+		{
+			return availablePresentMode;
+		}
+	}
+
+	return VK_PRESENT_MODE_FIFO_KHR;
+}
+
 /**
  * @brief Selecciona la extensión (tamaño) adecuada para las imágenes del swapchain.
  * @param capabilities Capacidades de la superficie.
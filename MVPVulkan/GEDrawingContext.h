@@ -10,56 +10,72 @@
 #include "GEGraphicsContext.h"
 #include "GEWindowPosition.h"
 
+const uint32_t FRAMES_IN_FLIGHT = 2; ///< Frames que la CPU puede preparar mientras la GPU termina los anteriores (más: mejor rendimiento; menos: menos latencia).
+
 /**
  * @class GEDrawingContext
  * @brief Clase que contiene la información sobre el destino de las imágenes a generar (swapchain, vistas, colas de comandos).
+ *
+ * Las subclases (GEOffscreenContext) cambian el destino sin cambiar la interfaz
+ * que usan la escena y la aplicación.
  */
 class GEDrawingContext
 {
 public:
 	std::vector<VkImageView> imageViews; ///< Vistas de las imágenes del swapchain.
 
-private:
+protected:
 	// ===== Campos auxiliares =====
 	uint32_t imageCount; ///< Número de imágenes en la swapchain.
-	uint32_t frameCount; ///< Número de frames en vuelo.
-	size_t currentFrame = 0; ///< Índice del frame actual.
+	uint32_t frameCount; ///< Número de frames en vuelo (no depende del número de imágenes).
+	uint32_t currentFrame = 0; ///< Índice del frame actual.
 	uint32_t currentImage = 0; ///< Índice de la imagen actual.
 
 	// ===== Componentes gráficos =====
-	VkSwapchainKHR swapChain; ///< Swapchain de Vulkan.
 	VkFormat imageFormat; ///< Formato de imagen.
 	VkExtent2D imageExtent; ///< Extensión de las imágenes.
 	std::vector<VkImage> images; ///< Imágenes de la swapchain.
 	VkQueue graphicsQueue; ///< Cola gráfica.
-	VkQueue presentQueue; ///< Cola de presentación.
 
-	// ===== Sincronización entre imágenes =====
-	std::vector<VkSemaphore> imageAvailableSemaphores; ///< Semáforos de imagen disponible.
-	std::vector<VkSemaphore> renderFinishedSemaphores; ///< Semáforos de render terminado.
+	// ===== Sincronización entre frames =====
 	std::vector<VkFence> inFlightFences; ///< Fences por frame.
-	std::vector<VkFence> imagesInFlight; ///< Fence por imagen.
+
+private:
+	VkPresentModeKHR requestedPresentMode; ///< Modo de presentación pedido por la aplicación.
+	VkPresentModeKHR presentMode; ///< Modo de presentación del swapchain actual.
+	std::vector<VkPresentModeKHR> presentModes; ///< Modos de presentación que admite la superficie.
+	VkSwapchainKHR swapChain; ///< Swapchain de Vulkan.
+	VkQueue presentQueue; ///< Cola de presentación.
+	std::vector<VkSemaphore> imageAvailableSemaphores; ///< Semáforos de imagen disponible (por frame).
+	std::vector<VkSemaphore> renderFinishedSemaphores; ///< Semáforos de render terminado (por imagen: los espera su present).
 
 public:
 	/**
 	 * @brief Crea el contexto de dibujo (swapchain, vistas y sincronización).
 	 * @param gc Contexto gráfico.
 	 * @param wpos Posición y tamaño de la ventana.
+	 * @param frameCount Número de frames en vuelo.
+	 * @param presentMode Modo de presentación (si la superficie no lo admite se usa FIFO).
+	 */
+	GEDrawingContext(GEGraphicsContext* gc, GEWindowPosition wpos, uint32_t frameCount = FRAMES_IN_FLIGHT, VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR);
+
+	/**
+	 * @brief Destructor virtual (los recursos se liberan con destroy()).
 	 */
-	GEDrawingContext(GEGraphicsContext* gc, GEWindowPosition wpos);
+	virtual ~GEDrawingContext() {}
 
 	/**
 	 * @brief Destruye los recursos del contexto de dibujo.
 	 * @param gc Contexto gráfico.
 	 */
-	void destroy(GEGraphicsContext* gc);
+	virtual void destroy(GEGraphicsContext* gc);
 
 	/**
 	 * @brief Reconstruye el contexto de dibujo tras un cambio de tamaño.
 	 * @param gc Contexto gráfico.
 	 * @param wpos Nueva posición/tamaño de la ventana.
 	 */
-	void recreate(GEGraphicsContext* gc, GEWindowPosition wpos);
+	virtual void recreate(GEGraphicsContext* gc, GEWindowPosition wpos);
 
 	/**
 	 * @brief Obtiene el formato de la imagen.
@@ -73,6 +89,12 @@ public:
 	 */
 	VkExtent2D getExtent();
 
+	/**
+	 * @brief Layout en el que el render pass deja las imágenes.
+	 * @return VK_IMAGE_LAYOUT_PRESENT_SRC_KHR para el swapchain.
+	 */
+	virtual VkImageLayout getFinalLayout();
+
 	/**
 	 * @brief Obtiene el número de imágenes de la swapchain.
 	 * @return Número de imágenes.
@@ -85,35 +107,101 @@ public:
 	 */
 	uint32_t getCurrentImage();
 
+	/**
+	 * @brief Obtiene el número de frames en vuelo.
+	 *
+	 * Los recursos que se escriben en cada frame (uniformes, descriptor sets y
+	 * command buffers) tienen una copia por frame en vuelo, no por imagen.
+	 * @return Número de frames.
+	 */
+	uint32_t getFrameCount();
+
+	/**
+	 * @brief Obtiene el índice del frame actual.
+	 * @return Índice del frame (0 .. getFrameCount() - 1).
+	 */
+	uint32_t getCurrentFrame();
+
+	/**
+	 * @brief Indica si la superficie admite un modo de presentación.
+	 * @param mode Modo de presentación.
+	 * @return true si se puede usar (FIFO siempre está disponible).
+	 */
+	bool isPresentModeSupported(VkPresentModeKHR mode);
+
+	/**
+	 * @brief Pide un modo de presentación para el próximo recreate().
+	 *
+	 * MAILBOX sustituye la imagen pendiente por la más reciente (baja latencia sin
+	 * tearing), IMMEDIATE presenta sin esperar al refresco (mínima latencia, con
+	 * tearing) y FIFO espera al refresco (sin tearing, la cola añade latencia).
+	 * @param mode Modo de presentación.
+	 */
+	void setPresentMode(VkPresentModeKHR mode);
+
+	/**
+	 * @brief Obtiene el modo de presentación del swapchain actual.
+	 * @return Modo de presentación.
+	 */
+	VkPresentModeKHR getPresentMode();
+
+	/**
+	 * @brief Obtiene el nombre de un modo de presentación.
+	 * @param mode Modo de presentación.
+	 * @return Nombre del modo.
+	 */
+	static const char* getPresentModeName(VkPresentModeKHR mode);
+
 	// ===== Métodos de generación de la imagen =====
 	/**
-	 * @brief Espera y adquiere la siguiente imagen disponible.
+	 * @brief Espera a que la GPU termine el frame N-k (N es el frame que se va a preparar).
+	 *
+	 * Con k menor que el número de frames en vuelo hay menos frames encolados cuando
+	 * se lee la entrada. Con k igual espera a la misma fence que waitForNextImage().
 	 * @param gc Contexto gráfico.
+	 * @param latency Frames k (se limita entre 1 y el número de frames en vuelo).
 	 */
-	void waitForNextImage(GEGraphicsContext* gc);
+	void waitForFrame(GEGraphicsContext* gc, uint32_t latency);
 
 	/**
-	 * @brief Envía los comandos gráficos para la imagen actual.
+	 * @brief Espera a que terminen los comandos del frame actual y adquiere la siguiente imagen.
 	 * @param gc Contexto gráfico.
-	 * @param commandBuffers Vector con los command buffers.
 	 */
-	void submitGraphicsCommands(GEGraphicsContext* gc, std::vector<VkCommandBuffer> commandBuffers);
+	virtual void waitForNextImage(GEGraphicsContext* gc);
+
+	/**
+	 * @brief Envía los comandos gráficos del frame actual.
+	 * @param gc Contexto gráfico.
+	 * @param commandBuffers Vector con los command buffers (uno por frame).
+	 */
+	virtual void submitGraphicsCommands(GEGraphicsContext* gc, std::vector<VkCommandBuffer> commandBuffers);
 
 	/**
 	 * @brief Envía los comandos de presentación para la imagen actual.
 	 * @param gc Contexto gráfico.
 	 */
-	void submitPresentCommands(GEGraphicsContext* gc);
+	virtual void submitPresentCommands(GEGraphicsContext* gc);
+
+protected:
+	/**
+	 * @brief Constructor para las subclases que no usan swapchain.
+	 *
+	 * No crea nada: la subclase rellena las imágenes, vistas, cola y fences.
+	 */
+	GEDrawingContext();
 
 private:
 	// ===== Métodos de creación de componentes =====
 	void createSwapChain(GEGraphicsContext* gc, GEWindowPosition wpos);
 	void createImageViews(VkDevice device);
 	void createSyncObjects(VkDevice device);
+	void createImageSemaphores(VkDevice device);
+	void destroyImageSemaphores(VkDevice device);
 	void createQueues(GEGraphicsContext* gc);
 
 	// ===== Métodos auxiliares =====
 	VkSurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats);
+	VkPresentModeKHR chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes);
 	VkExtent2D chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities, GEWindowPosition wpos);
 };
 
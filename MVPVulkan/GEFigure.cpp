@@ -4,43 +4,53 @@
  */
 
 #include "GEFigure.h"
+#include "GEMeshBuffer.h"
+#include "GERenderQueue.h"
 
 #include "GEVertex.h"
 #include "GETransform.h"
 #include "GEMaterial.h"
-#include "GELight.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
 
+static uint32_t nextMaterialId = 0; ///< Siguiente identificador de material de las figuras.
+
 /**
- * @brief Inicializa los buffers de la figura.
- * @param gc Contexto gráfico.
- * @param rc Contexto de renderizado.
+ * @brief Inicializa la figura con su geometría en el buffer de mallas compartido.
+ * @param ring Buffer de uniformes compartido.
+ * @param meshBuffer Buffer de mallas compartido (todavía sin construir).
  */
-void GEFigure::initialize(GEGraphicsContext* gc, GERenderingContext* rc)
+void GEFigure::initialize(GEUniformRing* ring, GEMeshBuffer* meshBuffer)
 {
-	size_t vertexSize = sizeof(GEVertex) * vertices.size();
-	vbo = new GEVertexBuffer(gc, vertexSize, vertices.data());
-
-	size_t indexSize = sizeof(indices[0]) * indices.size();
-	ibo = new GEIndexBuffer(gc, indexSize, indices.data());
-
-	size_t transformBufferSize = sizeof(GETransform);
-	transformBuffer = new GEUniformBuffer(gc, rc->imageCount, transformBufferSize);
+	mesh = meshBuffer->add(vertices, indices);
 
-	size_t materialBufferSize = sizeof(GEMaterial);
-	materialBuffer = new GEUniformBuffer(gc, rc->imageCount, materialBufferSize);
+	attachUniforms(ring);
+}
 
-	size_t lightBufferSize = sizeof(GELight);
-	lightBuffer = new GEUniformBuffer(gc, rc->imageCount, lightBufferSize);
+/**
+ * @brief Inicializa la figura sobre una malla ya creada.
+ * @param ring Buffer de uniformes compartido.
+ * @param ownMesh Malla con buffers propios.
+ */
+void GEFigure::initialize(GEUniformRing* ring, GEMesh* ownMesh)
+{
+	mesh = ownMesh;
 
-	std::vector<GEUniformBuffer*> ubos(3);
-	ubos[0] = transformBuffer;
-	ubos[1] = materialBuffer;
-	ubos[2] = lightBuffer;
+	attachUniforms(ring);
+}
 
-	dset = new GEDescriptorSet(gc, rc, ubos);
+/**
+ * @brief Asocia la figura al buffer de uniformes compartido.
+ * @param ring Buffer de uniformes compartido.
+ */
+void GEFigure::attachUniforms(GEUniformRing* ring)
+{
+	uniformRing = ring;
+	pushTransform = (ring->dsets.size() < 2);
+	// Cada figura tiene su propio material; el offset cambia en cada frame y no sirve para agrupar
+	materialId = nextMaterialId++;
+	visible = true;
 
 	location = glm::mat4(1.0f);
 }
@@ -51,53 +61,66 @@ void GEFigure::initialize(GEGraphicsContext* gc, GERenderingContext* rc)
  */
 void GEFigure::destroy(GEGraphicsContext* gc)
 {
-	vbo->destroy(gc);
-	ibo->destroy(gc);
-	transformBuffer->destroy(gc);
-	materialBuffer->destroy(gc);
-	lightBuffer->destroy(gc);
-	dset->destroy(gc);
-
-	delete vbo;
-	delete ibo;
-	delete transformBuffer;
-	delete materialBuffer;
-	delete lightBuffer;
-	delete dset;
+	mesh->destroy(gc);
+	delete mesh;
+	mesh = nullptr;
+	uniformRing = nullptr;
 }
 
 /**
- * @brief Añade los comandos de renderizado al command buffer.
- * @param commandBuffer Buffer de comandos.
- * @param pipelineLayout Layout del pipeline.
- * @param index Índice de la imagen.
+ * @brief Añade el draw de la figura a la cola de renderizado del frame.
+ * @param queue Cola de renderizado.
+ * @param index Índice del frame.
+ * @param eye Posición de la cámara.
  */
-void GEFigure::addCommands(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, int index)
+void GEFigure::submit(GERenderQueue* queue, int index, const glm::vec3& eye)
 {
-	VkDeviceSize offset = 0;
-	vkCmdBindVertexBuffers(commandBuffer, 0, 1, &(vbo->buffer), &offset);
-	vkCmdBindIndexBuffer(commandBuffer, ibo->buffer, 0, VK_INDEX_TYPE_UINT16);
-	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &(dset->descriptorSets[index]), 0, nullptr);
-	vkCmdDrawIndexed(commandBuffer, (uint32_t)indices.size(), 1, 0, 0, 0);
+	if (!visible) return;
+
+	// Las porciones del frame se reservan (y copian) en el orden de envío
+	GETransform transform;
+	transform.Model = location;
+	uint32_t materialOffset = uniformRing->allocate(sizeof(GEMaterial), &material);
+	uint32_t transformOffset = pushTransform ? 0 : uniformRing->allocate(sizeof(GETransform), &transform);
+
+	GEDrawPacket packet;
+	packet.pipeline = 0;
+	packet.mesh = mesh;
+	packet.firstSet = uniformRing->firstSet;
+	packet.setCount = pushTransform ? 1 : 2;
+	packet.sets[0] = uniformRing->dsets[0]->descriptorSets[index];
+	packet.sets[1] = pushTransform ? VK_NULL_HANDLE : uniformRing->dsets[1]->descriptorSets[index];
+	packet.dynamicOffsets[0] = materialOffset;
+	packet.dynamicOffsets[1] = transformOffset;
+	packet.pushTransform = pushTransform;
+	packet.transform = transform;
+
+	// Los buffers se identifican por su dirección: basta con agrupar, no hace falta que sean únicos
+	uint32_t meshId = (uint32_t)((uintptr_t)mesh->getBinding() >> 4);
+	GEBoundingSphere sphere = transformBoundingSphere(mesh->bounds, location);
+	packet.key = queue->makeKey(packet.pipeline, materialId, meshId, glm::length(sphere.center - eye));
+
+	queue->submit(packet);
 }
 
 /**
- * @brief Actualiza las variables uniformes sobre una imagen del swapchain.
- * @param gc Contexto gráfico.
- * @param index Índice de la imagen.
- * @param view Matriz de vista.
- * @param projection Matriz de proyección.
+ * @brief Obtiene el número de triángulos que envía la figura en cada frame.
+ * @return Triángulos de la malla, o 0 si la figura se ha descartado.
  */
-void GEFigure::update(GEGraphicsContext* gc, uint32_t index, glm::mat4 view, glm::mat4 projection)
+uint32_t GEFigure::getTriangleCount() const
 {
-	GETransform transform;
-	transform.MVP = projection * view * location;
-	transform.ModelViewMatrix = view * location;
-	transform.ViewMatrix = view;
+	return visible ? mesh->indexCount / 3 : 0;
+}
 
-	transformBuffer->update(gc, index, sizeof(GETransform), &transform);
-	materialBuffer->update(gc, index, sizeof(GEMaterial), &material);
-	lightBuffer->update(gc, index, sizeof(GELight), &light);
+/**
+ * @brief Comprueba si la esfera envolvente de la figura está dentro del volumen de visión.
+ * @param frustum Volumen de visión del frame.
+ * @return true si la figura es visible.
+ */
+bool GEFigure::cull(const GEFrustum& frustum)
+{
+	visible = frustum.isVisible(transformBoundingSphere(mesh->bounds, location));
+	return visible;
 }
 
 /**
@@ -146,10 +169,19 @@ void GEFigure::setMaterial(GEMaterial m)
 }
 
 /**
- * @brief Asigna las propiedades de la luz que ilumina la figura.
- * @param l Luz a asignar.
+ * @brief Obtiene la lista de vértices de la figura.
+ * @return Vector de vértices.
  */
-void GEFigure::setLight(GELight l)
+const std::vector<GEVertex>& GEFigure::getVertices() const
 {
-	this->light = l;
-}
\ No newline at end of file
+	return vertices;
+}
+
+/**
+ * @brief Obtiene la lista de índices de la figura.
+ * @return Vector de índices.
+ */
+const std::vector<uint32_t>& GEFigure::getIndices() const
+{
+	return indices;
+}
@@ -10,14 +10,15 @@
 #include "GEVertex.h"
 #include "GETransform.h"
 #include "GEMaterial.h"
-#include "GELight.h"
-#include "GEVertexBuffer.h"
-#include "GEIndexBuffer.h"
-#include "GEUniformBuffer.h"
-#include "GEDescriptorSet.h"
+#include "GEMesh.h"
+#include "GEUniformRing.h"
+#include "GEFrustum.h"
 #include <glm/glm.hpp>
 #include <vector>
 
+class GEMeshBuffer;
+class GERenderQueue;
+
 /**
  * @class GEFigure
  * @brief Clase que describe una figura formada por una malla de vértices.
@@ -26,18 +27,26 @@ class GEFigure
 {
 protected:
 	std::vector<GEVertex> vertices; ///< Lista de vértices.
-	std::vector<uint16_t> indices; ///< Lista de índices.
+	std::vector<uint32_t> indices; ///< Lista de índices (la malla elige 16 o 32 bits al crearse).
 	glm::mat4 location; ///< Matriz de localización (modelo).
 	GEMaterial material; ///< Propiedades del material.
-	GELight light; ///< Propiedades de la luz.
 
 public:
 	/**
-	 * @brief Inicializa los buffers de la figura.
-	 * @param gc Contexto gráfico.
-	 * @param rc Contexto de renderizado.
+	 * @brief Inicializa la figura con su geometría en el buffer de mallas compartido.
+	 * @param ring Buffer de uniformes compartido.
+	 * @param meshBuffer Buffer de mallas compartido (todavía sin construir).
+	 */
+	void initialize(GEUniformRing* ring, GEMeshBuffer* meshBuffer);
+
+	/**
+	 * @brief Inicializa la figura sobre una malla ya creada (p. ej. un nivel de un GEMeshFile).
+	 *
+	 * La figura pasa a ser la propietaria de la malla y la destruye en destroy().
+	 * @param ring Buffer de uniformes compartido.
+	 * @param ownMesh Malla con buffers propios y vértices GEVertex.
 	 */
-	void initialize(GEGraphicsContext* gc, GERenderingContext* rc);
+	void initialize(GEUniformRing* ring, GEMesh* ownMesh);
 
 	/**
 	 * @brief Libera los buffers de la figura.
@@ -46,21 +55,32 @@ public:
 	void destroy(GEGraphicsContext* gc);
 
 	/**
-	 * @brief Añade los comandos de renderizado al command buffer.
-	 * @param commandBuffer Buffer de comandos.
-	 * @param pipelineLayout Layout del pipeline.
-	 * @param index Índice de la imagen.
+	 * @brief Añade el draw de la figura a la cola de renderizado del frame.
+	 *
+	 * El material y, sin push constants, la matriz Model se copian a porciones
+	 * nuevas del buffer de uniformes del frame. La clave combina el material, los
+	 * buffers y la distancia a la cámara (el orden lo decide la cola). Las figuras
+	 * descartadas no envían nada.
+	 * @param queue Cola de renderizado.
+	 * @param index Índice del frame.
+	 * @param eye Posición de la cámara.
 	 */
-	void addCommands(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, int index);
+	void submit(GERenderQueue* queue, int index, const glm::vec3& eye);
 
 	/**
-	 * @brief Actualiza las variables uniformes.
-	 * @param gc Contexto gráfico.
-	 * @param index Índice de la imagen.
-	 * @param view Matriz de vista.
-	 * @param projection Matriz de proyección.
+	 * @brief Comprueba si la esfera envolvente de la figura está dentro del volumen de visión.
+	 *
+	 * Las figuras descartadas no reservan uniformes ni envían su draw a la cola.
+	 * @param frustum Volumen de visión del frame.
+	 * @return true si la figura es visible.
 	 */
-	void update(GEGraphicsContext* gc, uint32_t index, glm::mat4 view, glm::mat4 projection);
+	bool cull(const GEFrustum& frustum);
+
+	/**
+	 * @brief Obtiene el número de triángulos que envía la figura en cada frame.
+	 * @return Triángulos de la malla, o 0 si la figura se ha descartado.
+	 */
+	uint32_t getTriangleCount() const;
 
 	/**
 	 * @brief Resetea la matriz de localización (Model).
@@ -93,17 +113,28 @@ public:
 	void setMaterial(GEMaterial m);
 
 	/**
-	 * @brief Asigna las propiedades de la luz que ilumina la figura.
-	 * @param l Luz a asignar.
+	 * @brief Obtiene la lista de vértices de la figura.
+	 * @return Vector de vértices.
+	 */
+	const std::vector<GEVertex>& getVertices() const;
+
+	/**
+	 * @brief Obtiene la lista de índices de la figura.
+	 * @return Vector de índices.
 	 */
-	void setLight(GELight l);
+	const std::vector<uint32_t>& getIndices() const;
 
 private:
-	GEVertexBuffer* vbo; ///< Vertex buffer object.
-	GEIndexBuffer* ibo; ///< Index buffer object.
-	GEUniformBuffer* transformBuffer; ///< Uniform buffer para transformaciones.
-	GEUniformBuffer* materialBuffer; ///< Uniform buffer para material.
-	GEUniformBuffer* lightBuffer; ///< Uniform buffer para luz.
-	GEDescriptorSet* dset; ///< Descriptor set asociado.
+	GEMesh* mesh; ///< Malla (vertex e index buffer) de la figura.
+	GEUniformRing* uniformRing; ///< Buffer de uniformes compartido.
+	uint32_t materialId; ///< Identificador estable del material en la clave de la cola.
+	bool pushTransform; ///< La matriz Model se envía por push constants (el buffer compartido no tiene set de objeto).
+	bool visible; ///< La figura estaba dentro del volumen de visión en el último cull().
+
+	/**
+	 * @brief Asocia la figura al buffer de uniformes compartido.
+	 * @param ring Buffer de uniformes compartido.
+	 */
+	void attachUniforms(GEUniformRing* ring);
 };
 
@@ -0,0 +1,89 @@
+/**
+ * @file GEFramePacer.cpp
+ * @brief Implementación de la clase GEFramePacer.
+ */
+
+#include "GEFramePacer.h"
+
+#include <algorithm>
+
+/**
+ * @brief Crea el marcador de ritmo.
+ * @param latency Frames k que pueden seguir en la GPU al leer los eventos.
+ */
+GEFramePacer::GEFramePacer(uint32_t latency)
+{
+	this->latency = std::max(latency, 1u);
+	inputTime = std::chrono::steady_clock::now();
+	resetStats();
+}
+
+/**
+ * @brief Espera a la fence del frame N-k y anota el momento en que se leen los eventos.
+ * @param gc Contexto gráfico.
+ * @param dc Contexto de dibujo.
+ */
+void GEFramePacer::wait(GEGraphicsContext* gc, GEDrawingContext* dc)
+{
+	auto start = std::chrono::steady_clock::now();
+	dc->waitForFrame(gc, latency);
+	inputTime = std::chrono::steady_clock::now();
+	waitSum += std::chrono::duration<double>(inputTime - start).count();
+}
+
+/**
+ * @brief Registra la latencia del frame tras enviar sus comandos.
+ */
+void GEFramePacer::markSubmitted()
+{
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - inputTime).count();
+	latencySum += seconds;
+	latencyMax = std::max(latencyMax, seconds);
+	frames++;
+}
+
+/**
+ * @brief Cambia el número de frames que pueden seguir en la GPU.
+ * @param latency Frames k.
+ */
+void GEFramePacer::setLatency(uint32_t latency)
+{
+	this->latency = std::max(latency, 1u);
+}
+
+/**
+ * @brief Obtiene el número de frames que pueden seguir en la GPU.
+ * @return Frames k.
+ */
+uint32_t GEFramePacer::getLatency() const
+{
+	return latency;
+}
+
+/**
+ * @brief Obtiene la latencia de los frames medidos desde el último resetStats().
+ * @return Estadísticas de latencia.
+ */
+GELatencyStats GEFramePacer::getStats() const
+{
+	GELatencyStats stats = {};
+	stats.frames = frames;
+	if (frames > 0)
+	{
+		stats.averageLatency = latencySum * 1000.0 / frames;
+		stats.maxLatency = latencyMax * 1000.0;
+		stats.averageWait = waitSum * 1000.0 / frames;
+	}
+	return stats;
+}
+
+/**
+ * @brief Reinicia las estadísticas de latencia.
+ */
+void GEFramePacer::resetStats()
+{
+	latencySum = 0.0;
+	latencyMax = 0.0;
+	waitSum = 0.0;
+	frames = 0;
+}
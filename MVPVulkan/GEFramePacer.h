@@ -0,0 +1,92 @@
+/**
+ * @file GEFramePacer.h
+ * @brief Declaración de la clase GEFramePacer que limita los frames encolados y mide la latencia de entrada.
+ */
+
+#pragma once
+
+#include "GEGraphicsContext.h"
+#include "GEDrawingContext.h"
+#include <chrono>
+#include <stdint.h>
+
+/**
+ * @struct GELatencyStats
+ * @brief Latencia entre la lectura de la entrada y el envío del frame a la GPU.
+ */
+typedef struct
+{
+	uint32_t frames;       ///< Frames medidos.
+	double averageLatency; ///< Latencia media entre la lectura de eventos y el envío (ms).
+	double maxLatency;     ///< Latencia máxima (ms).
+	double averageWait;    ///< Espera media a la fence del frame N-k antes de leer los eventos (ms).
+} GELatencyStats;
+
+/**
+ * @class GEFramePacer
+ * @brief Marca el ritmo del bucle principal para reducir la latencia de entrada.
+ *
+ * Antes de leer los eventos se espera a la fence del frame N-k (N es el frame que
+ * se va a preparar). Con k = 1 solo se leen los eventos cuando la GPU ha terminado
+ * el frame anterior: la cámara se actualiza con la entrada más reciente y el frame
+ * no se queda esperando en una cola, a cambio de que CPU y GPU solapen menos. Con
+ * k igual al número de frames en vuelo el ritmo es el de siempre (máximo rendimiento).
+ *
+ * La latencia medida va desde la lectura de los eventos hasta el vkQueueSubmit del
+ * frame, así que incluye la espera para adquirir la imagen (que depende del modo de
+ * presentación) y el tiempo de CPU de la escena.
+ */
+class GEFramePacer
+{
+private:
+	uint32_t latency;                                ///< Frames k que pueden seguir en la GPU al leer los eventos.
+	std::chrono::steady_clock::time_point inputTime; ///< Momento en que se leyeron los eventos del frame actual.
+	double latencySum;                               ///< Latencia acumulada (s).
+	double latencyMax;                               ///< Latencia máxima (s).
+	double waitSum;                                  ///< Espera acumulada a la fence (s).
+	uint32_t frames;                                 ///< Frames acumulados.
+
+public:
+	/**
+	 * @brief Crea el marcador de ritmo.
+	 * @param latency Frames k que pueden seguir en la GPU al leer los eventos (1 = mínima latencia).
+	 */
+	GEFramePacer(uint32_t latency);
+
+	/**
+	 * @brief Espera a la fence del frame N-k y anota el momento en que se leen los eventos.
+	 *
+	 * Hay que llamarla justo antes de glfwPollEvents().
+	 * @param gc Contexto gráfico.
+	 * @param dc Contexto de dibujo.
+	 */
+	void wait(GEGraphicsContext* gc, GEDrawingContext* dc);
+
+	/**
+	 * @brief Registra la latencia del frame tras enviar sus comandos.
+	 */
+	void markSubmitted();
+
+	/**
+	 * @brief Cambia el número de frames que pueden seguir en la GPU.
+	 * @param latency Frames k (se limita al número de frames en vuelo al esperar).
+	 */
+	void setLatency(uint32_t latency);
+
+	/**
+	 * @brief Obtiene el número de frames que pueden seguir en la GPU.
+	 * @return Frames k.
+	 */
+	uint32_t getLatency() const;
+
+	/**
+	 * @brief Obtiene la latencia de los frames medidos desde el último resetStats().
+	 * @return Estadísticas de latencia.
+	 */
+	GELatencyStats getStats() const;
+
+	/**
+	 * @brief Reinicia las estadísticas de latencia.
+	 */
+	void resetStats();
+};
@@ -0,0 +1,83 @@
+/**
+ * @file GEFrameUniforms.cpp
+ * @brief Implementación de la clase GEFrameUniforms.
+ */
+
+#include "GEFrameUniforms.h"
+
+/**
+ * @brief Crea los buffers y el descriptor set por frame.
+ * @param gc Contexto gráfico.
+ * @param rc Contexto de renderizado.
+ */
+GEFrameUniforms::GEFrameUniforms(GEGraphicsContext* gc, GERenderingContext* rc)
+{
+	cameraBuffer = new GEUniformBuffer(gc, rc->frameCount, sizeof(GEViewTransform));
+	lightBuffer = new GEUniformBuffer(gc, rc->frameCount, sizeof(GELight));
+
+	std::vector<GEUniformBuffer*> buffers(2);
+	buffers[0] = cameraBuffer;
+	buffers[1] = lightBuffer;
+
+	std::vector<VkDescriptorType> types(2, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+	dset = new GEDescriptorSet(gc, rc->frameCount, rc->descriptorSetLayouts[FRAME_SET], buffers, types);
+}
+
+/**
+ * @brief Añade los descriptores del set 0 a la configuración de un pipeline.
+ * @param config Configuración del pipeline.
+ */
+void GEFrameUniforms::addDescriptors(GEPipelineConfig* config)
+{
+	config->descriptorTypes.push_back(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+	config->descriptorStages.push_back(VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT);
+	config->descriptorSets.push_back(FRAME_SET);
+
+	config->descriptorTypes.push_back(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+	config->descriptorStages.push_back(VK_SHADER_STAGE_FRAGMENT_BIT);
+	config->descriptorSets.push_back(FRAME_SET);
+}
+
+/**
+ * @brief Copia la cámara y la luz en los buffers de un frame.
+ * @param gc Contexto gráfico.
+ * @param index Índice del frame.
+ * @param view Matriz de vista.
+ * @param projection Matriz de proyección.
+ * @param light Luz de la escena.
+ */
+void GEFrameUniforms::update(GEGraphicsContext* gc, uint32_t index, glm::mat4 view, glm::mat4 projection, const GELight& light)
+{
+	GEViewTransform transform;
+	transform.ViewMatrix = view;
+	transform.Projection = projection;
+
+	cameraBuffer->update(gc, index, sizeof(GEViewTransform), &transform);
+	lightBuffer->update(gc, index, sizeof(GELight), &light);
+}
+
+/**
+ * @brief Enlaza el set 0 en el command buffer.
+ * @param commandBuffer Buffer de comandos.
+ * @param pipelineLayout Layout del pipeline.
+ * @param index Índice del frame.
+ */
+void GEFrameUniforms::addCommands(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, int index)
+{
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, FRAME_SET, 1, &(dset->descriptorSets[index]), 0, nullptr);
+}
+
+/**
+ * @brief Destruye los buffers y el descriptor set.
+ * @param gc Contexto gráfico.
+ */
+void GEFrameUniforms::destroy(GEGraphicsContext* gc)
+{
+	cameraBuffer->destroy(gc);
+	lightBuffer->destroy(gc);
+	dset->destroy(gc);
+
+	delete cameraBuffer;
+	delete lightBuffer;
+	delete dset;
+}
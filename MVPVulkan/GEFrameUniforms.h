@@ -0,0 +1,73 @@
+/**
+ * @file GEFrameUniforms.h
+ * @brief Declaración de la clase GEFrameUniforms con las variables uniformes comunes a todo el frame.
+ */
+
+#pragma once
+
+#include "GEGraphicsContext.h"
+#include "GERenderingContext.h"
+#include "GEPipelineConfig.h"
+#include "GEUniformBuffer.h"
+#include "GEDescriptorSet.h"
+#include "GETransform.h"
+#include "GELight.h"
+#include <glm/glm.hpp>
+
+const uint32_t FRAME_SET = 0; ///< Índice del set con los datos por frame en todos los pipelines.
+
+/**
+ * @class GEFrameUniforms
+ * @brief Datos que cambian una vez por frame (cámara y luz), compartidos por todos los pipelines.
+ *
+ * Los descriptores se organizan por frecuencia de actualización: el set 0 contiene
+ * los datos por frame, el set 1 los del material y el último los del objeto. Todos
+ * los pipelines declaran el set 0 de la misma forma (addDescriptors), así que basta
+ * con enlazarlo una vez al principio de cada command buffer: al cambiar de pipeline
+ * el set 0 sigue siendo compatible y no se vuelve a enlazar.
+ */
+class GEFrameUniforms
+{
+private:
+	GEUniformBuffer* cameraBuffer; ///< Matrices de vista y proyección.
+	GEUniformBuffer* lightBuffer;  ///< Propiedades de la luz.
+	GEDescriptorSet* dset;         ///< Descriptor set del set 0.
+
+public:
+	/**
+	 * @brief Crea los buffers y el descriptor set por frame.
+	 * @param gc Contexto gráfico.
+	 * @param rc Contexto de renderizado.
+	 */
+	GEFrameUniforms(GEGraphicsContext* gc, GERenderingContext* rc);
+
+	/**
+	 * @brief Añade los descriptores del set 0 a la configuración de un pipeline.
+	 * @param config Configuración del pipeline (debe añadirse antes que el resto de descriptores).
+	 */
+	static void addDescriptors(GEPipelineConfig* config);
+
+	/**
+	 * @brief Copia la cámara y la luz en los buffers de un frame.
+	 * @param gc Contexto gráfico.
+	 * @param index Índice del frame.
+	 * @param view Matriz de vista.
+	 * @param projection Matriz de proyección.
+	 * @param light Luz de la escena.
+	 */
+	void update(GEGraphicsContext* gc, uint32_t index, glm::mat4 view, glm::mat4 projection, const GELight& light);
+
+	/**
+	 * @brief Enlaza el set 0 en el command buffer.
+	 * @param commandBuffer Buffer de comandos.
+	 * @param pipelineLayout Layout de cualquier pipeline que declare el set 0 con addDescriptors().
+	 * @param index Índice del frame.
+	 */
+	void addCommands(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, int index);
+
+	/**
+	 * @brief Destruye los buffers y el descriptor set.
+	 * @param gc Contexto gráfico.
+	 */
+	void destroy(GEGraphicsContext* gc);
+};
@@ -0,0 +1,161 @@
+/**
+ * @file GEFrustum.cpp
+ * @brief Implementación de la clase GEFrustum.
+ */
+
+#include "GEFrustum.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#include <xmmintrin.h>
+#define GE_FRUSTUM_SSE
+#endif
+
+/**
+ * @brief Calcula la esfera envolvente de una lista de vértices.
+ * @param vertices Lista de vértices.
+ * @return Esfera envolvente.
+ */
+GEBoundingSphere computeBoundingSphere(const std::vector<GEVertex>& vertices)
+{
+	GEBoundingSphere sphere = {};
+	if (vertices.empty()) return sphere;
+
+	glm::vec3 minPos = vertices[0].pos;
+	glm::vec3 maxPos = vertices[0].pos;
+	for (const GEVertex& v : vertices)
+	{
+		minPos = glm::min(minPos, v.pos);
+		maxPos = glm::max(maxPos, v.pos);
+	}
+
+	sphere.center = (minPos + maxPos) * 0.5f;
+	for (const GEVertex& v : vertices)
+	{
+		sphere.radius = std::max(sphere.radius, glm::length(v.pos - sphere.center));
+	}
+	return sphere;
+}
+
+/**
+ * @brief Transforma una esfera envolvente con una matriz de modelo.
+ * @param sphere Esfera en coordenadas del modelo.
+ * @param m Matriz de modelo.
+ * @return Esfera en coordenadas del mundo.
+ */
+GEBoundingSphere transformBoundingSphere(const GEBoundingSphere& sphere, const glm::mat4& m)
+{
+	float sx = glm::dot(glm::vec3(m[0]), glm::vec3(m[0]));
+	float sy = glm::dot(glm::vec3(m[1]), glm::vec3(m[1]));
+	float sz = glm::dot(glm::vec3(m[2]), glm::vec3(m[2]));
+
+	GEBoundingSphere result;
+	result.center = glm::vec3(m * glm::vec4(sphere.center, 1.0f));
+	result.radius = sphere.radius * std::sqrt(std::max(sx, std::max(sy, sz)));
+	return result;
+}
+
+/**
+ * @brief Crea un volumen que no descarta nada.
+ */
+GEFrustum::GEFrustum()
+{
+	for (int i = 0; i < 6; i++)
+	{
+		planes[i] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+	}
+}
+
+/**
+ * @brief Extrae los planos de la matriz proyección * vista.
+ * @param viewProjection Matriz proyección * vista.
+ */
+void GEFrustum::update(const glm::mat4& viewProjection)
+{
+	glm::vec4 row0(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+	glm::vec4 row1(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+	glm::vec4 row2(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+	glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+	// glm::perspective genera z en [-w, w]: el plano cercano de ese rango
+	// contiene al de Vulkan ([0, w]), así que nunca descarta algo visible
+	planes[0] = row3 + row0;
+	planes[1] = row3 - row0;
+	planes[2] = row3 + row1;
+	planes[3] = row3 - row1;
+	planes[4] = row3 + row2;
+	planes[5] = row3 - row2;
+
+	for (int i = 0; i < 6; i++)
+	{
+		planes[i] /= glm::length(glm::vec3(planes[i]));
+	}
+}
+
+/**
+ * @brief Comprueba si una esfera está (al menos en parte) dentro del volumen.
+ * @param sphere Esfera en coordenadas del mundo.
+ * @return true si la esfera puede ser visible.
+ */
+bool GEFrustum::isVisible(const GEBoundingSphere& sphere) const
+{
+	for (int i = 0; i < 6; i++)
+	{
+		if (glm::dot(glm::vec3(planes[i]), sphere.center) + planes[i].w < -sphere.radius) return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Comprueba un conjunto de esferas guardadas como arrays separados.
+ * @param x Coordenada x de los centros.
+ * @param y Coordenada y de los centros.
+ * @param z Coordenada z de los centros.
+ * @param r Radios.
+ * @param count Número de esferas.
+ * @param visible Resultado por esfera.
+ * @return Número de esferas visibles.
+ */
+uint32_t GEFrustum::cull(const float* x, const float* y, const float* z, const float* r, uint32_t count, uint8_t* visible) const
+{
+	uint32_t visibleCount = 0;
+	uint32_t i = 0;
+
+#ifdef GE_FRUSTUM_SSE
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 cx = _mm_loadu_ps(x + i);
+		__m128 cy = _mm_loadu_ps(y + i);
+		__m128 cz = _mm_loadu_ps(z + i);
+		__m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(r + i));
+		__m128 inside = _mm_cmpeq_ps(negRadius, negRadius);
+
+		for (int p = 0; p < 6; p++)
+		{
+			__m128 d = _mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(planes[p].x)), _mm_set1_ps(planes[p].w));
+			d = _mm_add_ps(d, _mm_mul_ps(cy, _mm_set1_ps(planes[p].y)));
+			d = _mm_add_ps(d, _mm_mul_ps(cz, _mm_set1_ps(planes[p].z)));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(d, negRadius));
+		}
+
+		int mask = _mm_movemask_ps(inside);
+		for (int k = 0; k < 4; k++)
+		{
+			visible[i + k] = (uint8_t)((mask >> k) & 1);
+			visibleCount += visible[i + k];
+		}
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		GEBoundingSphere sphere;
+		sphere.center = glm::vec3(x[i], y[i], z[i]);
+		sphere.radius = r[i];
+		visible[i] = isVisible(sphere) ? 1 : 0;
+		visibleCount += visible[i];
+	}
+	return visibleCount;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file GEFrustum.h
+ * @brief Declaración de la clase GEFrustum para descartar objetos fuera del volumen de visión.
+ */
+
+#pragma once
+
+#include "GEVertex.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <stdint.h>
+
+/**
+ * @struct GEBoundingSphere
+ * @brief Esfera envolvente de una malla o de un objeto.
+ */
+typedef struct
+{
+	glm::vec3 center; ///< Centro de la esfera.
+	float radius;     ///< Radio de la esfera.
+} GEBoundingSphere;
+
+/**
+ * @struct GECullStats
+ * @brief Número de objetos visibles y descartados en el último frame.
+ */
+typedef struct
+{
+	uint32_t visible; ///< Objetos dentro del volumen de visión.
+	uint32_t culled;  ///< Objetos descartados.
+} GECullStats;
+
+/**
+ * @brief Calcula la esfera envolvente de una lista de vértices.
+ * @param vertices Lista de vértices.
+ * @return Esfera centrada en la caja envolvente que contiene todos los vértices.
+ */
+GEBoundingSphere computeBoundingSphere(const std::vector<GEVertex>& vertices);
+
+/**
+ * @brief Transforma una esfera envolvente con una matriz de modelo.
+ * @param sphere Esfera en coordenadas del modelo.
+ * @param m Matriz de modelo (el radio se escala con el mayor factor de escala).
+ * @return Esfera en coordenadas del mundo.
+ */
+GEBoundingSphere transformBoundingSphere(const GEBoundingSphere& sphere, const glm::mat4& m);
+
+/**
+ * @class GEFrustum
+ * @brief Planos del volumen de visión extraídos de la matriz proyección * vista.
+ *
+ * Los planos se calculan una vez por frame con update() y después se comprueban
+ * las esferas envolventes de todos los objetos. cull() procesa las esferas de
+ * cuatro en cuatro con SSE a partir de arrays separados de x, y, z y radio.
+ */
+class GEFrustum
+{
+private:
+	glm::vec4 planes[6]; ///< Planos normalizados (normal hacia el interior, w = distancia).
+
+public:
+	/**
+	 * @brief Crea un volumen que no descarta nada.
+	 */
+	GEFrustum();
+
+	/**
+	 * @brief Extrae los planos de la matriz proyección * vista.
+	 * @param viewProjection Matriz proyección * vista.
+	 */
+	void update(const glm::mat4& viewProjection);
+
+	/**
+	 * @brief Comprueba si una esfera está (al menos en parte) dentro del volumen.
+	 * @param sphere Esfera en coordenadas del mundo.
+	 * @return true si la esfera puede ser visible.
+	 */
+	bool isVisible(const GEBoundingSphere& sphere) const;
+
+	/**
+	 * @brief Comprueba un conjunto de esferas guardadas como arrays separados.
+	 * @param x Coordenada x de los centros.
+	 * @param y Coordenada y de los centros.
+	 * @param z Coordenada z de los centros.
+	 * @param r Radios.
+	 * @param count Número de esferas.
+	 * @param visible Resultado por esfera (1 visible, 0 descartada).
+	 * @return Número de esferas visibles.
+	 */
+	uint32_t cull(const float* x, const float* y, const float* z, const float* r, uint32_t count, uint8_t* visible) const;
+};
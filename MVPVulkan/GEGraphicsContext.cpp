@@ -7,6 +7,7 @@
 #include <iostream>
 #include <vector>
 #include <fstream>
+#include <cstdio>
 
 ///////////////////////////////////////////////////////////////////////////////////////////
 /////                                                                                 /////
@@ -16,17 +17,22 @@
 
 /**
  * @brief Crea un contexto gráfico de Vulkan (instancia, dispositivo físico y lógico).
- * @param window Ventana GLFW sobre la que crear el contexto. 
+ * @param window Ventana GLFW sobre la que crear el contexto (nullptr: sin ventana). 
  * @sa @ref GLFWwindow
  */
 GEGraphicsContext::GEGraphicsContext(GLFWwindow* window)
 {
-	createInstance();
-	createSurface(window);
+	surface = VK_NULL_HANDLE;
+	physicalDevice = VK_NULL_HANDLE;
+	createInstance(window);
+	if (window != nullptr) createSurface(window);
     // showInstanceProperties();
 	pickPhysicalDevice();
 	// showDevices();
     createLogicalDevice();
+	createAllocator();
+	createPipelineCache();
+	createShaderRegistry();
 }
 
 /**
@@ -34,8 +40,21 @@ GEGraphicsContext::GEGraphicsContext(GLFWwindow* window)
  */
 GEGraphicsContext::~GEGraphicsContext()
 {
+	pipelineCache->save();
+	pipelineCache->destroy();
+	delete pipelineCache;
+
+	shaderRegistry->destroy();
+	delete shaderRegistry;
+
+	descriptorAllocator->destroy();
+	delete descriptorAllocator;
+
+	allocator->destroy();
+	delete allocator;
+
     vkDestroyDevice(device, nullptr);
-	vkDestroySurfaceKHR(instance, surface, nullptr);
+	if (surface != VK_NULL_HANDLE) vkDestroySurfaceKHR(instance, surface, nullptr);
 	vkDestroyInstance(instance, nullptr);
 }
 
@@ -58,6 +77,74 @@ uint32_t GEGraphicsContext::findMemoryType(uint32_t typeFilter, VkMemoryProperty
 	throw std::runtime_error("failed to find suitable memory type!");
 }
 
+/**
+ * @brief Busca un tipo de memoria visible desde la CPU, preferiblemente coherente.
+ * @param typeFilter Filtro de tipos de memoria.
+ * @param coherent Indica a la salida si el tipo elegido es coherente.
+ * @return Índice del tipo de memoria adecuado.
+ */
+uint32_t GEGraphicsContext::findHostMemoryType(uint32_t typeFilter, bool* coherent)
+{
+	VkMemoryPropertyFlags hostCoherent = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+	for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++)
+	{
+		if ((typeFilter & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & hostCoherent) == hostCoherent)
+		{
+			*coherent = true;
+			return i;
+		}
+	}
+
+	*coherent = false;
+	return findMemoryType(typeFilter, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+}
+
+/**
+ * @brief Hace visibles al dispositivo las escrituras en una memoria mapeada no coherente.
+ * @param memory Memoria mapeada.
+ * @param memorySize Tamaño de la reserva de memoria.
+ * @param offset Inicio del rango escrito.
+ * @param size Tamaño del rango escrito.
+ */
+void GEGraphicsContext::flushMappedMemory(VkDeviceMemory memory, VkDeviceSize memorySize, VkDeviceSize offset, VkDeviceSize size)
+{
+	// El rango debe estar alineado a nonCoherentAtomSize o llegar al final de la reserva
+	VkDeviceSize start = offset - (offset % nonCoherentAtomSize);
+	VkDeviceSize end = offset + size;
+	end = (end + nonCoherentAtomSize - 1) - ((end + nonCoherentAtomSize - 1) % nonCoherentAtomSize);
+
+	VkMappedMemoryRange range = {};
+	range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+	range.memory = memory;
+	range.offset = start;
+	range.size = (end >= memorySize) ? VK_WHOLE_SIZE : end - start;
+
+	vkFlushMappedMemoryRanges(device, 1, &range);
+}
+
+/**
+ * @brief Hace visibles a la CPU las escrituras del dispositivo en una memoria mapeada no coherente.
+ * @param memory Memoria mapeada.
+ * @param memorySize Tamaño de la reserva de memoria.
+ * @param offset Inicio del rango a leer.
+ * @param size Tamaño del rango a leer.
+ */
+void GEGraphicsContext::invalidateMappedMemory(VkDeviceMemory memory, VkDeviceSize memorySize, VkDeviceSize offset, VkDeviceSize size)
+{
+	// Mismo alineamiento que flushMappedMemory
+	VkDeviceSize start = offset - (offset % nonCoherentAtomSize);
+	VkDeviceSize end = offset + size;
+	end = (end + nonCoherentAtomSize - 1) - ((end + nonCoherentAtomSize - 1) % nonCoherentAtomSize);
+
+	VkMappedMemoryRange range = {};
+	range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+	range.memory = memory;
+	range.offset = start;
+	range.size = (end >= memorySize) ? VK_WHOLE_SIZE : end - start;
+
+	vkInvalidateMappedMemoryRanges(device, 1, &range);
+}
+
 /**
  * @brief Busca el formato adecuado para el buffer de profundidad.
  * @return Formato de profundidad soportado.
@@ -94,8 +181,9 @@ VkFormat GEGraphicsContext::findDepthFormat()
 
 /**
  * @brief Crea la instancia de Vulkan.
+ * @param window Ventana GLFW (nullptr: sin las extensiones de superficie).
  */
-void GEGraphicsContext::createInstance()
+void GEGraphicsContext::createInstance(GLFWwindow* window)
 {
 	VkApplicationInfo appInfo = {};
 	appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
@@ -106,8 +194,11 @@ void GEGraphicsContext::createInstance()
 	appInfo.apiVersion = VK_API_VERSION_1_0;
 
 	uint32_t glfwExtensionCount = 0;
-	const char** glfwExtensions;
-	glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+	const char** glfwExtensions = nullptr;
+	if (window != nullptr)
+	{
+		glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+	}
 
 	VkInstanceCreateInfo createInfo = {};
 	createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -181,6 +272,11 @@ void GEGraphicsContext::pickPhysicalDevice()
 	}
 
 	vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+	nonCoherentAtomSize = properties.limits.nonCoherentAtomSize;
+	bufferImageGranularity = properties.limits.bufferImageGranularity;
 }
 
 /**
@@ -230,25 +326,63 @@ void GEGraphicsContext::createLogicalDevice()
     createInfo.enabledExtensionCount = 0;
     createInfo.enabledLayerCount = 0;
 
-    std::vector<const char*> deviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+    // Sin superficie no hay swapchain (p. ej. lavapipe en un servidor sin pantalla)
+    std::vector<const char*> deviceExtensions;
+    if (surface != VK_NULL_HANDLE) deviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
 
     VkPhysicalDeviceFeatures supportedFeatures = {};
     VkPhysicalDeviceFeatures requiredFeatures = {};
     vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
     requiredFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+    requiredFeatures.drawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance;
+    requiredFeatures.pipelineStatisticsQuery = supportedFeatures.pipelineStatisticsQuery;
+    requiredFeatures.inheritedQueries = supportedFeatures.inheritedQueries;
     requiredFeatures.tessellationShader = VK_TRUE;
     requiredFeatures.geometryShader = VK_TRUE;
     requiredFeatures.samplerAnisotropy = VK_TRUE;
     createInfo.pEnabledFeatures = &requiredFeatures;
 
     createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-    createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+    createInfo.ppEnabledExtensionNames = deviceExtensions.empty() ? nullptr : deviceExtensions.data();
 
     if (vkCreateDevice(physicalDevice, &createInfo, nullptr, &device) != VK_SUCCESS)
     {
         throw std::runtime_error("failed to create logical device!");
     }
 
+    multiDrawIndirect = requiredFeatures.multiDrawIndirect;
+    drawIndirectFirstInstance = requiredFeatures.drawIndirectFirstInstance;
+    pipelineStatisticsQuery = requiredFeatures.pipelineStatisticsQuery;
+    inheritedQueries = requiredFeatures.inheritedQueries;
+
+}
+
+/**
+ * @brief Crea el asignador que reparte bloques grandes de memoria entre los recursos
+ * y el que reparte descriptor sets entre un número reducido de pools.
+ */
+void GEGraphicsContext::createAllocator()
+{
+	allocator = new GEMemoryAllocator(device, memProperties, bufferImageGranularity, MEMORY_BLOCK_SIZE);
+	descriptorAllocator = new GEDescriptorAllocator(device, DESCRIPTOR_POOL_SETS);
+}
+
+/**
+ * @brief Crea la caché de pipelines a partir del fichero guardado en la ejecución anterior.
+ */
+void GEGraphicsContext::createPipelineCache()
+{
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+	pipelineCache = new GEPipelineCache(device, properties, PIPELINE_CACHE_FILE);
+}
+
+/**
+ * @brief Crea el registro de shaders (los módulos se crean al pedirlos).
+ */
+void GEGraphicsContext::createShaderRegistry()
+{
+	shaderRegistry = new GEShaderRegistry(device);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////
@@ -296,6 +430,21 @@ bool GEGraphicsContext::isDeviceSuitable(VkPhysicalDevice pDevice)
 	std::vector< VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
 	vkGetPhysicalDeviceQueueFamilyProperties(pDevice, &queueFamilyCount, queueFamilies.data());
 
+	// Sin superficie basta una cola gráfica
+	if (surface == VK_NULL_HANDLE)
+	{
+		for (uint32_t i = 0; i < queueFamilyCount; i++)
+		{
+			if (queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)
+			{
+				graphicsQueueFamilyIndex = i;
+				presentQueueFamilyIndex = i;
+				return true;
+			}
+		}
+		return false;
+	}
+
 	bool graphics = false;
 	bool present = false;
 	for (uint32_t i = 0; i < queueFamilyCount; i++)
@@ -392,7 +541,7 @@ void GEGraphicsContext::resumeDeviceProperties(VkPhysicalDevice pDevice, int ind
     vkEnumerateDeviceExtensionProperties(pDevice, nullptr, &extensionCount, extensionProperties.data());
 
     char filename[13];
-    sprintf_s(filename, "device_%i.txt", index);
+    snprintf(filename, sizeof(filename), "device_%i.txt", index);
     std::ofstream fout(filename);
     fout << "Device properties" << std::endl;
     fout << "\tapiVersion     " << deviceProperties.apiVersion << std::endl;
@@ -8,6 +8,14 @@
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 #include <vulkan/vulkan.h>
+#include "GEMemoryAllocator.h"
+#include "GEDescriptorAllocator.h"
+#include "GEPipelineCache.h"
+#include "GEShaderRegistry.h"
+
+const VkDeviceSize MEMORY_BLOCK_SIZE = 16 * 1024 * 1024; ///< Tamaño de los bloques del asignador de memoria.
+const uint32_t DESCRIPTOR_POOL_SETS = 64; ///< Número de conjuntos de cada pool del asignador de descriptores.
+const char* const PIPELINE_CACHE_FILE = "pipeline_cache.bin"; ///< Fichero de la caché de pipelines.
 
 /**
  * @class GEGraphicsContext
@@ -17,19 +25,32 @@ class GEGraphicsContext
 {
 public:
 	VkInstance instance; ///< Instancia de Vulkan.
-	VkSurfaceKHR surface; ///< Superficie de presentación.
+	VkSurfaceKHR surface; ///< Superficie de presentación (VK_NULL_HANDLE sin ventana).
 	VkPhysicalDevice physicalDevice; ///< Dispositivo físico seleccionado.
 	VkDevice device; ///< Dispositivo lógico.
 	uint32_t graphicsQueueFamilyIndex; ///< Índice de la familia de colas para gráficos.
 	uint32_t presentQueueFamilyIndex; ///< Índice de la familia de colas para presentación.
+	GEMemoryAllocator* allocator; ///< Asignador de memoria del dispositivo por bloques.
+	GEDescriptorAllocator* descriptorAllocator; ///< Asignador de descriptor sets compartido.
+	GEPipelineCache* pipelineCache; ///< Caché de pipelines (se guarda en disco al destruir el contexto).
+	GEShaderRegistry* shaderRegistry; ///< Shaders incrustados y sus módulos (uno por shader, compartidos).
+	VkBool32 multiDrawIndirect; ///< Se admiten varios draws en una sola llamada indirecta.
+	VkBool32 drawIndirectFirstInstance; ///< Los draws indirectos admiten firstInstance distinto de 0.
+	VkBool32 pipelineStatisticsQuery; ///< Se admiten consultas de estadísticas del pipeline.
+	VkBool32 inheritedQueries; ///< Las consultas pueden seguir activas al ejecutar buffers secundarios.
 
 private:
 	VkPhysicalDeviceMemoryProperties memProperties; ///< Propiedades de memoria del dispositivo.
+	VkDeviceSize nonCoherentAtomSize; ///< Granularidad de los rangos de memoria no coherente.
+	VkDeviceSize bufferImageGranularity; ///< Separación entre recursos lineales y no lineales en un bloque.
 
 public:
 	/**
 	 * @brief Construye el contexto gráfico de Vulkan.
-	 * @param window Ventana GLFW sobre la que crear el contexto.
+	 *
+	 * Sin ventana no se crea la superficie ni se activan VK_KHR_surface y
+	 * VK_KHR_swapchain: solo se puede dibujar con GEOffscreenContext.
+	 * @param window Ventana GLFW sobre la que crear el contexto (nullptr: sin ventana).
 	 */
 	GEGraphicsContext(GLFWwindow* window);
 
@@ -46,6 +67,32 @@ public:
 	 */
 	uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
 
+	/**
+	 * @brief Busca un tipo de memoria visible desde la CPU, preferiblemente coherente.
+	 * @param typeFilter Máscara de tipos de memoria disponibles.
+	 * @param coherent Indica a la salida si el tipo elegido es coherente.
+	 * @return Índice del tipo de memoria adecuado.
+	 */
+	uint32_t findHostMemoryType(uint32_t typeFilter, bool* coherent);
+
+	/**
+	 * @brief Hace visibles al dispositivo las escrituras en una memoria mapeada no coherente.
+	 * @param memory Memoria mapeada.
+	 * @param memorySize Tamaño de la reserva de memoria.
+	 * @param offset Inicio del rango escrito.
+	 * @param size Tamaño del rango escrito.
+	 */
+	void flushMappedMemory(VkDeviceMemory memory, VkDeviceSize memorySize, VkDeviceSize offset, VkDeviceSize size);
+
+	/**
+	 * @brief Hace visibles a la CPU las escrituras del dispositivo en una memoria mapeada no coherente.
+	 * @param memory Memoria mapeada.
+	 * @param memorySize Tamaño de la reserva de memoria.
+	 * @param offset Inicio del rango a leer.
+	 * @param size Tamaño del rango a leer.
+	 */
+	void invalidateMappedMemory(VkDeviceMemory memory, VkDeviceSize memorySize, VkDeviceSize offset, VkDeviceSize size);
+
 	/**
 	 * @brief Busca el formato de imagen adecuado para el buffer de profundidad.
 	 * @return Formato de profundidad soportado.
@@ -56,8 +103,9 @@ private:
 	// ===== Métodos de inicialización de Vulkan =====
 	/**
 	 * @brief Crea la instancia de Vulkan.
+	 * @param window Ventana GLFW (nullptr: sin las extensiones de superficie).
 	 */
-	void createInstance();
+	void createInstance(GLFWwindow* window);
 
 	/**
 	 * @brief Crea la superficie para la ventana GLFW.
@@ -75,6 +123,21 @@ private:
 	 */
 	void createLogicalDevice();
 
+	/**
+	 * @brief Crea el asignador de memoria del dispositivo y el de descriptor sets.
+	 */
+	void createAllocator();
+
+	/**
+	 * @brief Crea la caché de pipelines a partir del fichero guardado en la ejecución anterior.
+	 */
+	void createPipelineCache();
+
+	/**
+	 * @brief Crea el registro de shaders.
+	 */
+	void createShaderRegistry();
+
 	// ===== Métodos auxiliares =====
 	/**
 	 * @brief Muestra propiedades de la instancia Vulkan (depuración).
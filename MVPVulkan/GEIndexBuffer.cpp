@@ -8,17 +8,44 @@
 #include <iostream>
 
 /**
- * @brief Crea un Index Buffer.
+ * @brief Crea un Index Buffer en memoria visible desde la CPU (geometría dinámica).
  * @param gc Contexto gráfico.
  * @param size Tamaño del buffer en bytes.
  * @param data Puntero a los datos de índices.
  */
 GEIndexBuffer::GEIndexBuffer(GEGraphicsContext* gc, size_t size, const void* data)
+{
+	create(gc, size, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+	memcpy(allocation.mapped, data, size);
+}
+
+/**
+ * @brief Crea un Index Buffer en memoria DEVICE_LOCAL (geometría estática).
+ * @param gc Contexto gráfico.
+ * @param upload Contexto de subida que agrupa las transferencias.
+ * @param size Tamaño del buffer en bytes.
+ * @param data Puntero a los datos de índices.
+ * @param copy false si data sigue siendo válido hasta upload->submit() y no hace falta copiarlo.
+ */
+GEIndexBuffer::GEIndexBuffer(GEGraphicsContext* gc, GEUploadContext* upload, size_t size, const void* data, bool copy)
+{
+	create(gc, size, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	upload->enqueue(buffer, data, size, copy);
+}
+
+/**
+ * @brief Crea el buffer y le asigna memoria.
+ * @param gc Contexto gráfico.
+ * @param size Tamaño del buffer en bytes.
+ * @param usage Uso del buffer.
+ * @param properties Propiedades de la memoria.
+ */
+void GEIndexBuffer::create(GEGraphicsContext* gc, size_t size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties)
 {
 	VkBufferCreateInfo bufferInfo = {};
 	bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
 	bufferInfo.size = size;
-	bufferInfo.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT;;
+	bufferInfo.usage = usage;
 	bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
 	if (vkCreateBuffer(gc->device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS)
@@ -29,22 +56,10 @@ GEIndexBuffer::GEIndexBuffer(GEGraphicsContext* gc, size_t size, const void* dat
 	VkMemoryRequirements memRequirements;
 	vkGetBufferMemoryRequirements(gc->device, buffer, &memRequirements);
 
-	VkMemoryAllocateInfo allocInfo = {};
-	allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-	allocInfo.allocationSize = memRequirements.size;
-	allocInfo.memoryTypeIndex = gc->findMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-	if (vkAllocateMemory(gc->device, &allocInfo, nullptr, &memory) != VK_SUCCESS)
-	{
-		throw std::runtime_error("failed to allocate buffer memory!");
-	}
-
-	vkBindBufferMemory(gc->device, buffer, memory, 0);
+	uint32_t memoryType = gc->findMemoryType(memRequirements.memoryTypeBits, properties);
+	allocation = gc->allocator->allocate(memRequirements, memoryType, true);
 
-	void* gpudata;
-	vkMapMemory(gc->device, memory, 0, size, 0, &gpudata);
-	memcpy(gpudata, data, size);
-	vkUnmapMemory(gc->device, memory);
+	vkBindBufferMemory(gc->device, buffer, allocation.memory, allocation.offset);
 }
 
 /**
@@ -54,6 +69,6 @@ GEIndexBuffer::GEIndexBuffer(GEGraphicsContext* gc, size_t size, const void* dat
 void GEIndexBuffer::destroy(GEGraphicsContext* gc)
 {
 	vkDestroyBuffer(gc->device, buffer, nullptr);
-	vkFreeMemory(gc->device, memory, nullptr);
+	gc->allocator->free(allocation);
 }
 
@@ -7,6 +7,7 @@
 
 #include <vulkan/vulkan.h>
 #include "GEGraphicsContext.h"
+#include "GEUploadContext.h"
 
 /**
  * @class GEIndexBuffer
@@ -16,20 +17,42 @@ class GEIndexBuffer
 {
 public:
 	VkBuffer buffer;           ///< Buffer Vulkan que contiene índices.
-	VkDeviceMemory memory;     ///< Memoria asociada al buffer.
+	GEAllocation allocation;   ///< Rango de memoria asignado al buffer.
 
 	/**
-	 * @brief Crea un Index Buffer y sube los datos al buffer.
+	 * @brief Crea un Index Buffer en memoria visible desde la CPU (geometría dinámica).
 	 * @param gc Contexto gráfico.
 	 * @param size Tamaño del buffer en bytes.
 	 * @param data Puntero a los datos de índices.
 	 */
 	GEIndexBuffer(GEGraphicsContext* gc, size_t size, const void* data);
 
+	/**
+	 * @brief Crea un Index Buffer en memoria DEVICE_LOCAL (geometría estática).
+	 *
+	 * Los datos se copian cuando se llama a upload->submit().
+	 * @param gc Contexto gráfico.
+	 * @param upload Contexto de subida que agrupa las transferencias.
+	 * @param size Tamaño del buffer en bytes.
+	 * @param data Puntero a los datos de índices.
+	 * @param copy false si data sigue siendo válido hasta upload->submit() y no hace falta copiarlo.
+	 */
+	GEIndexBuffer(GEGraphicsContext* gc, GEUploadContext* upload, size_t size, const void* data, bool copy = true);
+
 	/**
 	 * @brief Destruye los recursos del index buffer.
 	 * @param gc Contexto gráfico.
 	 */
 	void destroy(GEGraphicsContext* gc);
+
+private:
+	/**
+	 * @brief Crea el buffer y le asigna memoria.
+	 * @param gc Contexto gráfico.
+	 * @param size Tamaño del buffer en bytes.
+	 * @param usage Uso del buffer.
+	 * @param properties Propiedades de la memoria.
+	 */
+	void create(GEGraphicsContext* gc, size_t size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties);
 };
 
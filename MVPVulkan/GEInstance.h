@@ -0,0 +1,29 @@
+/**
+ * @file GEInstance.h
+ * @brief Declaración de las estructuras GEInstance y GEInstanceHandle para el dibujo instanciado.
+ */
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <stdint.h>
+
+/**
+ * @struct GEInstance
+ * @brief Datos de una instancia tal y como los lee el shader (layout std430, 80 bytes).
+ */
+typedef struct
+{
+	alignas(16) glm::mat4 Model;        ///< Matriz de localización (modelo)
+	alignas(16) uint32_t MaterialIndex; ///< Índice en el array de materiales
+} GEInstance;
+
+/**
+ * @struct GEInstanceHandle
+ * @brief Referencia a una instancia registrada en un GEInstanceRenderer.
+ */
+typedef struct
+{
+	uint32_t batch; ///< Lote (malla) al que pertenece la instancia
+	uint32_t index; ///< Posición de la instancia dentro del lote
+} GEInstanceHandle;
@@ -0,0 +1,521 @@
+/**
+ * @file GEInstanceRenderer.cpp
+ * @brief Implementación de la clase GEInstanceRenderer.
+ */
+
+#include "GEInstanceRenderer.h"
+
+#include <cstring>
+#include <stdexcept>
+
+/**
+ * @brief Crea un renderizador de instancias vacío.
+ * @param frontToBack Ordena las instancias visibles de delante hacia atrás.
+ * @param depthPrepass Crea la variante de la pasada previa de profundidad.
+ */
+GEInstanceRenderer::GEInstanceRenderer(bool frontToBack, bool depthPrepass)
+{
+	instanceCount = 0;
+	pipelineVariant = 0;
+	depthPipelineVariant = 0;
+	this->frontToBack = frontToBack;
+	this->depthPrepass = depthPrepass;
+	instanceBuffer = nullptr;
+	materialBuffer = nullptr;
+	dset = nullptr;
+	meshBuffer = nullptr;
+	indirect = false;
+	multiDraw = false;
+	packed = false;
+	indirectBuffer = nullptr;
+	visibleCount = 0;
+	triangleCount = 0;
+}
+
+/**
+ * @brief Registra un material (los materiales repetidos se comparten).
+ * @param m Material a registrar.
+ * @return Índice del material.
+ */
+uint32_t GEInstanceRenderer::addMaterial(GEMaterial m)
+{
+	for (uint32_t i = 0; i < (uint32_t)materials.size(); i++)
+	{
+		if (memcmp(&materials[i], &m, sizeof(GEMaterial)) == 0) return i;
+	}
+	materials.push_back(m);
+	return (uint32_t)(materials.size() - 1);
+}
+
+/**
+ * @brief Registra una nueva instancia de una malla.
+ * @param mesh Malla a dibujar.
+ * @param materialIndex Índice del material.
+ * @return Referencia a la instancia.
+ */
+GEInstanceHandle GEInstanceRenderer::addInstance(GEMesh* mesh, uint32_t materialIndex)
+{
+	GEMeshLod lod = {};
+	lod.levels[0] = mesh;
+	lod.levelCount = 1;
+	return addInstance(lod, materialIndex);
+}
+
+/**
+ * @brief Registra una nueva instancia de una malla con varios niveles de detalle.
+ * @param lod Mallas de cada nivel.
+ * @param materialIndex Índice del material.
+ * @return Referencia a la instancia.
+ */
+GEInstanceHandle GEInstanceRenderer::addInstance(const GEMeshLod& lod, uint32_t materialIndex)
+{
+	uint32_t batch = 0;
+	while (batch < batches.size() && memcmp(&batches[batch].lod, &lod, sizeof(GEMeshLod)) != 0) batch++;
+	if (batch == batches.size())
+	{
+		Batch b = {};
+		b.lod = lod;
+		batches.push_back(b);
+	}
+
+	GEInstance instance = {};
+	instance.Model = glm::mat4(1.0f);
+	instance.MaterialIndex = materialIndex;
+	batches[batch].instances.push_back(instance);
+	batches[batch].levels.push_back(0);
+	instanceCount++;
+
+	GEInstanceHandle handle;
+	handle.batch = batch;
+	handle.index = (uint32_t)(batches[batch].instances.size() - 1);
+	return handle;
+}
+
+/**
+ * @brief Asigna la matriz de localización (Model) de una instancia.
+ * @param instance Referencia a la instancia.
+ * @param m Matriz de localización.
+ */
+void GEInstanceRenderer::setLocation(GEInstanceHandle instance, glm::mat4 m)
+{
+	batches[instance.batch].instances[instance.index].Model = m;
+}
+
+/**
+ * @brief Crea los buffers, el descriptor set y la variante del pipeline.
+ * @param gc Contexto gráfico.
+ * @param rc Contexto de renderizado.
+ */
+void GEInstanceRenderer::initialize(GEGraphicsContext* gc, GERenderingContext* rc)
+{
+	uint32_t first = 0;
+	uint32_t drawCount = 0;
+	for (Batch& b : batches)
+	{
+		b.firstInstance = first;
+		b.firstDraw = drawCount;
+		first += (uint32_t)b.instances.size();
+		for (uint32_t k = 0; k < b.lod.levelCount; k++)
+		{
+			drawCount += (uint32_t)b.lod.levels[k]->meshlets.size();
+		}
+	}
+	staging.resize(instanceCount);
+
+	// Los storage buffers no pueden tener tamaño 0
+	size_t instanceBufferSize = sizeof(GEInstance) * (instanceCount > 0 ? instanceCount : 1);
+	size_t materialBufferSize = sizeof(GEMaterial) * (materials.size() > 0 ? materials.size() : 1);
+
+	instanceBuffer = new GEUniformBuffer(gc, rc->frameCount, instanceBufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+	materialBuffer = new GEUniformBuffer(gc, rc->frameCount, materialBufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+
+	// Los draws indirectos necesitan un único par de buffers para todos los lotes
+	meshBuffer = batches.empty() ? nullptr : batches[0].lod.levels[0]->meshBuffer;
+	for (const Batch& b : batches)
+	{
+		for (uint32_t k = 0; k < b.lod.levelCount; k++)
+		{
+			if (b.lod.levels[k]->meshBuffer != meshBuffer) meshBuffer = nullptr;
+		}
+	}
+	indirect = (meshBuffer != nullptr && gc->drawIndirectFirstInstance);
+	multiDraw = (indirect && gc->multiDrawIndirect);
+
+	// Todos los lotes se dibujan con el mismo pipeline, así que comparten formato de vértice
+	for (size_t i = 0; i < batches.size(); i++)
+	{
+		for (uint32_t k = 0; k < batches[i].lod.levelCount; k++)
+		{
+			GEMeshBuffer* buffer = batches[i].lod.levels[k]->meshBuffer;
+			bool meshPacked = (buffer != nullptr && buffer->isPacked());
+			if (i == 0 && k == 0) packed = meshPacked;
+			else if (meshPacked != packed)
+			{
+				throw std::runtime_error("failed to mix packed and unpacked vertex formats in an instance renderer!");
+			}
+		}
+	}
+
+	if (indirect)
+	{
+		drawCommands.resize(drawCount);
+		indirectBuffer = new GEUniformBuffer(gc, rc->frameCount, sizeof(VkDrawIndexedIndirectCommand) * drawCount, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+
+		boundsX.resize(instanceCount);
+		boundsY.resize(instanceCount);
+		boundsZ.resize(instanceCount);
+		boundsR.resize(instanceCount);
+		visibility.resize(instanceCount);
+	}
+
+	// Los materiales no cambian: se copian una sola vez en cada frame
+	for (uint32_t i = 0; i < rc->frameCount && materials.size() > 0; i++)
+	{
+		materialBuffer->update(gc, i, sizeof(GEMaterial) * materials.size(), materials.data());
+	}
+
+	recreate(gc, rc);
+
+	std::vector<GEUniformBuffer*> buffers(2);
+	buffers[0] = instanceBuffer;
+	buffers[1] = materialBuffer;
+
+	std::vector<VkDescriptorType> types(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+
+	dset = new GEDescriptorSet(gc, rc->frameCount, rc->variantDescriptorSetLayouts[pipelineVariant][1], buffers, types);
+}
+
+/**
+ * @brief Vuelve a crear la variante del pipeline tras reconstruir el contexto de renderizado.
+ * @param gc Contexto gráfico.
+ * @param rc Nuevo contexto de renderizado.
+ */
+void GEInstanceRenderer::recreate(GEGraphicsContext* gc, GERenderingContext* rc)
+{
+	GEPipelineConfig* config = createPipelineConfig(rc->getExtent());
+	if (depthPrepass)
+	{
+		// La pasada previa ya deja la profundidad final: la principal solo la compara
+		config->depthWriteEnable = VK_FALSE;
+		pipelineVariant = rc->addPipelineVariant(gc, config);
+		config->setDepthOnly();
+		depthPipelineVariant = rc->addPipelineVariant(gc, config);
+	}
+	else
+	{
+		pipelineVariant = rc->addPipelineVariant(gc, config);
+	}
+	delete config;
+}
+
+/**
+ * @brief Libera los buffers y el descriptor set.
+ * @param gc Contexto gráfico.
+ */
+void GEInstanceRenderer::destroy(GEGraphicsContext* gc)
+{
+	instanceBuffer->destroy(gc);
+	materialBuffer->destroy(gc);
+	dset->destroy(gc);
+	if (indirectBuffer != nullptr) indirectBuffer->destroy(gc);
+
+	delete instanceBuffer;
+	delete materialBuffer;
+	delete dset;
+	delete indirectBuffer;
+}
+
+/**
+ * @brief Actualiza las instancias de un frame.
+ * @param gc Contexto gráfico.
+ * @param index Índice del frame.
+ * @param frustum Volumen de visión del frame.
+ * @param view Datos de la cámara para elegir el nivel de detalle.
+ */
+void GEInstanceRenderer::update(GEGraphicsContext* gc, uint32_t index, const GEFrustum& frustum, const GELodView& view)
+{
+	if (!indirect)
+	{
+		// Los draws directos están grabados con el número de instancias de cada lote
+		for (const Batch& b : batches)
+		{
+			memcpy(&staging[b.firstInstance], b.instances.data(), sizeof(GEInstance) * b.instances.size());
+			if (!packed) continue;
+			for (size_t j = 0; j < b.instances.size(); j++)
+			{
+				staging[b.firstInstance + j].Model = b.instances[j].Model * b.lod.levels[0]->dequantize;
+			}
+		}
+		if (instanceCount > 0)
+		{
+			instanceBuffer->update(gc, index, sizeof(GEInstance) * instanceCount, staging.data());
+		}
+		visibleCount = instanceCount;
+		triangleCount = 0;
+		for (const Batch& b : batches)
+		{
+			triangleCount += (uint32_t)b.instances.size() * (b.lod.levels[0]->indexCount / 3);
+		}
+		return;
+	}
+
+	// Esferas envolventes en arrays separados para comprobarlas de cuatro en cuatro
+	for (const Batch& b : batches)
+	{
+		for (size_t j = 0; j < b.instances.size(); j++)
+		{
+			GEBoundingSphere sphere = transformBoundingSphere(b.lod.levels[0]->bounds, b.instances[j].Model);
+			size_t k = b.firstInstance + j;
+			boundsX[k] = sphere.center.x;
+			boundsY[k] = sphere.center.y;
+			boundsZ[k] = sphere.center.z;
+			boundsR[k] = sphere.radius;
+		}
+	}
+	visibleCount = frustum.cull(boundsX.data(), boundsY.data(), boundsZ.data(), boundsR.data(), instanceCount, visibility.data());
+
+	// Las instancias visibles de cada lote se compactan al principio de su rango,
+	// ordenadas por nivel de detalle para que cada nivel sea un rango contiguo
+	triangleCount = 0;
+	for (Batch& b : batches)
+	{
+		uint32_t counts[MAX_LOD_LEVELS] = {};
+		for (size_t j = 0; j < b.instances.size(); j++)
+		{
+			size_t k = b.firstInstance + j;
+			if (!visibility[k]) continue;
+
+			GEBoundingSphere sphere;
+			sphere.center = glm::vec3(boundsX[k], boundsY[k], boundsZ[k]);
+			sphere.radius = boundsR[k];
+			b.levels[j] = (uint8_t)selectLodLevel(computeScreenRadius(sphere, view), b.levels[j], b.lod.levelCount);
+			counts[b.levels[j]]++;
+		}
+
+		uint32_t offsets[MAX_LOD_LEVELS];
+		uint32_t offset = b.firstInstance;
+		uint32_t draw = b.firstDraw;
+		for (uint32_t l = 0; l < b.lod.levelCount; l++)
+		{
+			// Un draw por meshlet, todos con las mismas instancias
+			GEMesh* mesh = b.lod.levels[l];
+			for (const GEMeshlet& m : mesh->meshlets)
+			{
+				VkDrawIndexedIndirectCommand& command = drawCommands[draw++];
+				command.indexCount = m.indexCount;
+				command.instanceCount = counts[l];
+				command.firstIndex = m.firstIndex;
+				command.vertexOffset = m.vertexOffset;
+				command.firstInstance = offset;
+			}
+
+			offsets[l] = offset;
+			offset += counts[l];
+			triangleCount += counts[l] * (mesh->indexCount / 3);
+		}
+
+		if (frontToBack)
+		{
+			// Clave: nivel de detalle y, dentro de cada nivel, distancia a la cámara.
+			// Ordenadas, las instancias de cada nivel quedan en su rango de más cerca a más lejos
+			sortItems.clear();
+			for (size_t j = 0; j < b.instances.size(); j++)
+			{
+				size_t k = b.firstInstance + j;
+				if (!visibility[k]) continue;
+
+				GESortItem item;
+				float depth = glm::length(glm::vec3(boundsX[k], boundsY[k], boundsZ[k]) - view.eye);
+				item.key = ((uint64_t)b.levels[j] << 32) | sortableDepth(depth);
+				item.index = (uint32_t)j;
+				sortItems.push_back(item);
+			}
+			radixSort(sortItems, sortScratch);
+
+			uint32_t next = b.firstInstance;
+			for (const GESortItem& item : sortItems)
+			{
+				GEInstance& instance = staging[next++];
+				instance = b.instances[item.index];
+				if (packed) instance.Model = instance.Model * b.lod.levels[b.levels[item.index]]->dequantize;
+			}
+			continue;
+		}
+
+		for (size_t j = 0; j < b.instances.size(); j++)
+		{
+			if (!visibility[b.firstInstance + j]) continue;
+
+			GEInstance& instance = staging[offsets[b.levels[j]]++];
+			instance = b.instances[j];
+			if (packed) instance.Model = instance.Model * b.lod.levels[b.levels[j]]->dequantize;
+		}
+	}
+	if (instanceCount > 0)
+	{
+		instanceBuffer->update(gc, index, sizeof(GEInstance) * instanceCount, staging.data());
+	}
+	indirectBuffer->update(gc, index, sizeof(VkDrawIndexedIndirectCommand) * drawCommands.size(), drawCommands.data());
+}
+
+/**
+ * @brief Añade un draw instanciado por malla al command buffer.
+ * @param commandBuffer Buffer de comandos.
+ * @param rc Contexto de renderizado.
+ * @param index Índice del frame.
+ */
+void GEInstanceRenderer::addCommands(VkCommandBuffer commandBuffer, GERenderingContext* rc, int index)
+{
+	addDraws(commandBuffer, rc, index, pipelineVariant);
+}
+
+/**
+ * @brief Añade los mismos draws con la variante que solo escribe profundidad.
+ * @param commandBuffer Buffer de comandos.
+ * @param rc Contexto de renderizado.
+ * @param index Índice del frame.
+ */
+void GEInstanceRenderer::addDepthCommands(VkCommandBuffer commandBuffer, GERenderingContext* rc, int index)
+{
+	if (!depthPrepass) return;
+	addDraws(commandBuffer, rc, index, depthPipelineVariant);
+}
+
+/**
+ * @brief Añade los draws de todos los lotes con una variante del pipeline.
+ * @param commandBuffer Buffer de comandos.
+ * @param rc Contexto de renderizado.
+ * @param index Índice del frame.
+ * @param variant Variante del pipeline.
+ */
+void GEInstanceRenderer::addDraws(VkCommandBuffer commandBuffer, GERenderingContext* rc, int index, uint32_t variant)
+{
+	if (instanceCount == 0) return;
+
+	VkPipelineLayout layout = rc->variantPipelineLayouts[variant];
+	rc->bindPipelineVariant(commandBuffer, variant);
+	// El set 0 (por frame) sigue enlazado: su definición es la misma en ambos pipelines
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 1, 1, &(dset->descriptorSets[index]), 0, nullptr);
+
+	if (indirect)
+	{
+		// Los parámetros de cada draw se leen del buffer indirecto del frame
+		VkBuffer buffer = indirectBuffer->buffers[index];
+		uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+		uint32_t drawCount = (uint32_t)drawCommands.size();
+
+		meshBuffer->bind(commandBuffer);
+		if (multiDraw)
+		{
+			vkCmdDrawIndexedIndirect(commandBuffer, buffer, 0, drawCount, stride);
+		}
+		else
+		{
+			for (uint32_t i = 0; i < drawCount; i++)
+			{
+				vkCmdDrawIndexedIndirect(commandBuffer, buffer, (VkDeviceSize)i * stride, 1, stride);
+			}
+		}
+		return;
+	}
+
+	for (const Batch& b : batches)
+	{
+		b.lod.levels[0]->bind(commandBuffer);
+		b.lod.levels[0]->draw(commandBuffer, (uint32_t)b.instances.size(), b.firstInstance);
+	}
+}
+
+/**
+ * @brief Obtiene el número de draws que genera cada frame.
+ * @return Número de lotes, o de niveles de detalle de todos los lotes con draws indirectos.
+ */
+uint32_t GEInstanceRenderer::getDrawCount() const
+{
+	return indirect ? (uint32_t)drawCommands.size() : (uint32_t)batches.size();
+}
+
+/**
+ * @brief Obtiene el número de llamadas de dibujo grabadas en cada command buffer.
+ * @return 1 con multiDrawIndirect, o una por draw.
+ */
+uint32_t GEInstanceRenderer::getDrawCallCount() const
+{
+	return multiDraw ? 1 : getDrawCount();
+}
+
+/**
+ * @brief Obtiene el número total de instancias.
+ * @return Número de instancias.
+ */
+uint32_t GEInstanceRenderer::getInstanceCount() const
+{
+	return instanceCount;
+}
+
+/**
+ * @brief Obtiene el número de instancias dibujadas en el último update().
+ * @return Número de instancias dentro del volumen de visión.
+ */
+uint32_t GEInstanceRenderer::getVisibleCount() const
+{
+	return visibleCount;
+}
+
+/**
+ * @brief Obtiene el número de triángulos enviados en el último update().
+ * @return Suma de los triángulos de todas las instancias dibujadas.
+ */
+uint32_t GEInstanceRenderer::getTriangleCount() const
+{
+	return triangleCount;
+}
+
+/**
+ * @brief Obtiene la configuración de la variante instanciada del pipeline.
+ * @param extent Extensión de la imagen.
+ * @return Configuración del pipeline creada.
+ */
+GEPipelineConfig* GEInstanceRenderer::createPipelineConfig(VkExtent2D extent)
+{
+	GEPipelineConfig* config = new GEPipelineConfig();
+	config->fragment_shader = SHADER_INSTANCED_FRAG;
+	config->attrOffsets.resize(2);
+	config->attrFormats.resize(2);
+
+	if (packed)
+	{
+		// El shader decodifica la normal; la posición ya llega en [-1, 1]
+		config->vertex_shader = SHADER_INSTANCED_PACKED_VERT;
+		config->attrStride = sizeof(GEPackedVertex);
+		config->attrOffsets[0] = offsetof(GEPackedVertex, pos);
+		config->attrOffsets[1] = offsetof(GEPackedVertex, norm);
+		config->attrFormats[0] = VK_FORMAT_R16G16B16A16_SNORM;
+		config->attrFormats[1] = VK_FORMAT_R16G16_SNORM;
+	}
+	else
+	{
+		config->vertex_shader = SHADER_INSTANCED_VERT;
+		config->attrStride = sizeof(GEVertex);
+		config->attrOffsets[0] = offsetof(GEVertex, pos);
+		config->attrOffsets[1] = offsetof(GEVertex, norm);
+		config->attrFormats[0] = VK_FORMAT_R32G32B32_SFLOAT;
+		config->attrFormats[1] = VK_FORMAT_R32G32B32_SFLOAT;
+	}
+
+	GEFrameUniforms::addDescriptors(config);
+
+	config->descriptorTypes.push_back(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+	config->descriptorStages.push_back(VK_SHADER_STAGE_VERTEX_BIT);
+	config->descriptorSets.push_back(1);
+
+	config->descriptorTypes.push_back(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+	config->descriptorStages.push_back(VK_SHADER_STAGE_FRAGMENT_BIT);
+	config->descriptorSets.push_back(1);
+
+	config->depthTestEnable = VK_TRUE;
+	config->cullMode = VK_CULL_MODE_BACK_BIT;
+	config->extent = extent;
+
+	return config;
+}
@@ -0,0 +1,236 @@
+/**
+ * @file GEInstanceRenderer.h
+ * @brief Declaración de la clase GEInstanceRenderer que dibuja mallas compartidas por instancias.
+ */
+
+#pragma once
+
+#include "GEGraphicsContext.h"
+#include "GERenderingContext.h"
+#include "GEPipelineConfig.h"
+#include "GEInstance.h"
+#include "GEMaterial.h"
+#include "GEMesh.h"
+#include "GEMeshBuffer.h"
+#include "GEUniformBuffer.h"
+#include "GEDescriptorSet.h"
+#include "GEFrameUniforms.h"
+#include "GEFrustum.h"
+#include "GEMeshLod.h"
+#include "GERadixSort.h"
+#include <glm/glm.hpp>
+#include <vector>
+
+/**
+ * @class GEInstanceRenderer
+ * @brief Dibuja todas las instancias de cada malla con un único vkCmdDrawIndexed.
+ *
+ * Las instancias se agrupan en lotes por malla. En cada frame se copian las
+ * matrices de todos los lotes, seguidas, a un storage buffer que el vertex shader
+ * indexa con gl_InstanceIndex. Los materiales se guardan en otro storage buffer
+ * y cada instancia solo almacena su índice. El número de draws depende del número
+ * de mallas distintas, no del número de articulaciones ni de esqueletos.
+ *
+ * La cámara y la luz se leen del set 0 (GEFrameUniforms); el renderizador solo
+ * enlaza el set 1 con las instancias y los materiales.
+ *
+ * Si todas las mallas están en el mismo GEMeshBuffer, los draws de los lotes se
+ * escriben en cada frame como VkDrawIndexedIndirectCommand y se lanzan con un solo
+ * vkCmdDrawIndexedIndirect (o uno por lote si el dispositivo no admite multiDrawIndirect),
+ * así que el command buffer no cambia aunque cambie el número de instancias.
+ * En ese caso update() descarta las instancias fuera del volumen de visión: las
+ * visibles de cada lote se compactan al principio de su rango y el draw indirecto
+ * solo cuenta esas, sin volver a grabar el command buffer.
+ *
+ * Un lote puede tener varios niveles de detalle (GEMeshLod). Con draws indirectos
+ * cada instancia visible elige su nivel por su radio en pantalla y las instancias
+ * del lote se ordenan por nivel dentro de su rango, con un draw indirecto por nivel.
+ * Opcionalmente, las instancias de cada nivel se ordenan además de delante hacia
+ * atrás (se rasterizan en orden de gl_InstanceIndex).
+ * Con draws directos siempre se usa el nivel 0.
+ *
+ * Si las mallas están en un GEMeshBuffer comprimido, la variante del pipeline lee
+ * GEPackedVertex y la matriz de cada instancia incluye GEMesh::dequantize.
+ *
+ * Con pasada previa de profundidad hay una segunda variante sin shader de
+ * fragmentos que dibuja las mismas instancias (addDepthCommands()) y la variante
+ * principal ya no escribe profundidad.
+ *
+ * Las instancias y los materiales deben registrarse antes de initialize().
+ */
+class GEInstanceRenderer
+{
+private:
+	/**
+	 * @struct Batch
+	 * @brief Instancias que comparten una misma malla (con sus niveles de detalle).
+	 */
+	struct Batch
+	{
+		GEMeshLod lod;                      ///< Mallas de cada nivel de detalle.
+		std::vector<GEInstance> instances;  ///< Datos de las instancias.
+		std::vector<uint8_t> levels;        ///< Nivel de detalle elegido para cada instancia en el último frame.
+		uint32_t firstInstance;             ///< Posición del lote en el storage buffer.
+		uint32_t firstDraw;                 ///< Posición del primer draw del lote en el buffer indirecto (uno por meshlet de cada nivel).
+	};
+
+	std::vector<Batch> batches;          ///< Lotes de instancias, uno por malla.
+	std::vector<GEMaterial> materials;   ///< Materiales referenciados por las instancias.
+	uint32_t instanceCount;              ///< Número total de instancias.
+	uint32_t pipelineVariant;            ///< Variante del pipeline en el contexto de renderizado.
+	uint32_t depthPipelineVariant;       ///< Variante de la pasada de profundidad (solo con depthPrepass).
+	bool frontToBack;                    ///< Ordena las instancias visibles de delante hacia atrás.
+	bool depthPrepass;                   ///< Se dibuja una pasada previa de profundidad.
+	std::vector<GESortItem> sortItems;   ///< Claves de las instancias visibles de un lote (nivel y distancia).
+	std::vector<GESortItem> sortScratch; ///< Buffer auxiliar de la ordenación.
+	std::vector<GEInstance> staging;     ///< Copia contigua de las instancias de todos los lotes.
+
+	GEUniformBuffer* instanceBuffer;     ///< Storage buffer para las instancias.
+	GEUniformBuffer* materialBuffer;     ///< Storage buffer para los materiales.
+	GEDescriptorSet* dset;               ///< Descriptor set de instancias y materiales (set 1).
+
+	GEMeshBuffer* meshBuffer;            ///< Buffer compartido por las mallas de todos los lotes (nullptr si no lo comparten).
+	bool indirect;                       ///< Los lotes se dibujan con draws indirectos.
+	bool multiDraw;                      ///< Todos los draws indirectos se lanzan en una sola llamada.
+	bool packed;                         ///< Las mallas usan vértices comprimidos (GEPackedVertex).
+	std::vector<VkDrawIndexedIndirectCommand> drawCommands; ///< Comandos indirectos de los lotes.
+	GEUniformBuffer* indirectBuffer;     ///< Buffer de comandos indirectos.
+
+	std::vector<float> boundsX;          ///< Coordenada x de las esferas envolventes de las instancias.
+	std::vector<float> boundsY;          ///< Coordenada y de las esferas envolventes de las instancias.
+	std::vector<float> boundsZ;          ///< Coordenada z de las esferas envolventes de las instancias.
+	std::vector<float> boundsR;          ///< Radio de las esferas envolventes de las instancias.
+	std::vector<uint8_t> visibility;     ///< Resultado del descarte por instancia.
+	uint32_t visibleCount;               ///< Instancias dibujadas en el último update().
+	uint32_t triangleCount;              ///< Triángulos enviados en el último update().
+
+public:
+	/**
+	 * @brief Crea un renderizador de instancias vacío.
+	 * @param frontToBack Ordena las instancias visibles de delante hacia atrás (solo con draws indirectos).
+	 * @param depthPrepass Crea la variante de la pasada previa de profundidad.
+	 */
+	GEInstanceRenderer(bool frontToBack = false, bool depthPrepass = false);
+
+	/**
+	 * @brief Registra un material (los materiales repetidos se comparten).
+	 * @param m Material a registrar.
+	 * @return Índice del material.
+	 */
+	uint32_t addMaterial(GEMaterial m);
+
+	/**
+	 * @brief Registra una nueva instancia de una malla.
+	 * @param mesh Malla a dibujar.
+	 * @param materialIndex Índice del material (devuelto por addMaterial).
+	 * @return Referencia a la instancia.
+	 */
+	GEInstanceHandle addInstance(GEMesh* mesh, uint32_t materialIndex);
+
+	/**
+	 * @brief Registra una nueva instancia de una malla con varios niveles de detalle.
+	 * @param lod Mallas de cada nivel.
+	 * @param materialIndex Índice del material (devuelto por addMaterial).
+	 * @return Referencia a la instancia.
+	 */
+	GEInstanceHandle addInstance(const GEMeshLod& lod, uint32_t materialIndex);
+
+	/**
+	 * @brief Asigna la matriz de localización (Model) de una instancia.
+	 * @param instance Referencia a la instancia.
+	 * @param m Matriz de localización.
+	 */
+	void setLocation(GEInstanceHandle instance, glm::mat4 m);
+
+	/**
+	 * @brief Crea los buffers, el descriptor set y la variante del pipeline.
+	 * @param gc Contexto gráfico.
+	 * @param rc Contexto de renderizado.
+	 */
+	void initialize(GEGraphicsContext* gc, GERenderingContext* rc);
+
+	/**
+	 * @brief Vuelve a crear la variante del pipeline tras reconstruir el contexto de renderizado.
+	 * @param gc Contexto gráfico.
+	 * @param rc Nuevo contexto de renderizado.
+	 */
+	void recreate(GEGraphicsContext* gc, GERenderingContext* rc);
+
+	/**
+	 * @brief Libera los buffers y el descriptor set.
+	 * @param gc Contexto gráfico.
+	 */
+	void destroy(GEGraphicsContext* gc);
+
+	/**
+	 * @brief Actualiza las instancias de un frame.
+	 * @param gc Contexto gráfico.
+	 * @param index Índice del frame.
+	 * @param frustum Volumen de visión del frame (solo se usa con draws indirectos).
+	 * @param view Datos de la cámara para elegir el nivel de detalle (solo con draws indirectos).
+	 */
+	void update(GEGraphicsContext* gc, uint32_t index, const GEFrustum& frustum, const GELodView& view);
+
+	/**
+	 * @brief Añade un draw instanciado por malla al command buffer.
+	 * @param commandBuffer Buffer de comandos.
+	 * @param rc Contexto de renderizado.
+	 * @param index Índice del frame.
+	 */
+	void addCommands(VkCommandBuffer commandBuffer, GERenderingContext* rc, int index);
+
+	/**
+	 * @brief Añade los mismos draws con la variante que solo escribe profundidad.
+	 * @param commandBuffer Buffer de comandos.
+	 * @param rc Contexto de renderizado.
+	 * @param index Índice del frame.
+	 */
+	void addDepthCommands(VkCommandBuffer commandBuffer, GERenderingContext* rc, int index);
+
+	/**
+	 * @brief Obtiene el número de draws que genera cada frame.
+	 * @return Número de lotes, o de niveles de detalle de todos los lotes con draws indirectos.
+	 */
+	uint32_t getDrawCount() const;
+
+	/**
+	 * @brief Obtiene el número de llamadas de dibujo grabadas en cada command buffer.
+	 * @return 1 con multiDrawIndirect, o una por draw.
+	 */
+	uint32_t getDrawCallCount() const;
+
+	/**
+	 * @brief Obtiene el número total de instancias.
+	 * @return Número de instancias.
+	 */
+	uint32_t getInstanceCount() const;
+
+	/**
+	 * @brief Obtiene el número de instancias dibujadas en el último update().
+	 * @return Número de instancias dentro del volumen de visión.
+	 */
+	uint32_t getVisibleCount() const;
+
+	/**
+	 * @brief Obtiene el número de triángulos enviados en el último update().
+	 * @return Suma de los triángulos de todas las instancias dibujadas.
+	 */
+	uint32_t getTriangleCount() const;
+
+private:
+	/**
+	 * @brief Obtiene la configuración de la variante instanciada del pipeline.
+	 * @param extent Extensión de la imagen.
+	 * @return Configuración del pipeline creada.
+	 */
+	GEPipelineConfig* createPipelineConfig(VkExtent2D extent);
+
+	/**
+	 * @brief Añade los draws de todos los lotes con una variante del pipeline.
+	 * @param commandBuffer Buffer de comandos.
+	 * @param rc Contexto de renderizado.
+	 * @param index Índice del frame.
+	 * @param variant Variante del pipeline.
+	 */
+	void addDraws(VkCommandBuffer commandBuffer, GERenderingContext* rc, int index, uint32_t variant);
+};
@@ -0,0 +1,307 @@
+/**
+ * @file GEMemoryAllocator.cpp
+ * @brief Implementación de la clase GEMemoryAllocator.
+ */
+
+#include "GEMemoryAllocator.h"
+
+#include <iterator>
+#include <stdexcept>
+
+/**
+ * @brief Redondea un valor al siguiente múltiplo de un alineamiento.
+ * @param value Valor a redondear.
+ * @param alignment Alineamiento.
+ * @return Valor alineado.
+ */
+static VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * @brief Comprueba si dos direcciones de un bloque caen en la misma página de granularidad.
+ * @param a Primera dirección.
+ * @param b Segunda dirección.
+ * @param granularity Tamaño de página (bufferImageGranularity).
+ * @return true si comparten página.
+ */
+static bool samePage(VkDeviceSize a, VkDeviceSize b, VkDeviceSize granularity)
+{
+	return (a / granularity) == (b / granularity);
+}
+
+/**
+ * @brief Crea el asignador.
+ * @param device Dispositivo lógico.
+ * @param memProperties Propiedades de memoria del dispositivo físico.
+ * @param bufferImageGranularity Límite bufferImageGranularity del dispositivo.
+ * @param blockSize Tamaño de los bloques ordinarios.
+ */
+GEMemoryAllocator::GEMemoryAllocator(VkDevice device, const VkPhysicalDeviceMemoryProperties& memProperties, VkDeviceSize bufferImageGranularity, VkDeviceSize blockSize)
+{
+	this->device = device;
+	this->memProperties = memProperties;
+	this->bufferImageGranularity = bufferImageGranularity;
+	this->blockSize = blockSize;
+	this->blocks.resize(memProperties.memoryTypeCount);
+}
+
+/**
+ * @brief Reserva un nuevo bloque de memoria.
+ * @param memoryType Tipo de memoria.
+ * @param size Tamaño del bloque.
+ * @return Bloque creado.
+ */
+GEMemoryAllocator::Block* GEMemoryAllocator::createBlock(uint32_t memoryType, VkDeviceSize size)
+{
+	Block* block = new Block();
+	block->size = size;
+	block->mapped = nullptr;
+
+	VkMemoryAllocateInfo allocInfo = {};
+	allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocInfo.allocationSize = size;
+	allocInfo.memoryTypeIndex = memoryType;
+
+	if (vkAllocateMemory(device, &allocInfo, nullptr, &block->memory) != VK_SUCCESS)
+	{
+		delete block;
+		throw std::runtime_error("failed to allocate memory block!");
+	}
+
+	// Los bloques visibles desde la CPU quedan mapeados durante toda su vida
+	if (memProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+	{
+		void* data;
+		vkMapMemory(device, block->memory, 0, VK_WHOLE_SIZE, 0, &data);
+		block->mapped = (uint8_t*)data;
+	}
+
+	block->freeRanges[0] = size;
+	blocks[memoryType].push_back(block);
+	return block;
+}
+
+/**
+ * @brief Libera un bloque y lo quita de la lista de su tipo.
+ * @param memoryType Tipo de memoria del bloque.
+ * @param index Posición del bloque en la lista.
+ */
+void GEMemoryAllocator::destroyBlock(uint32_t memoryType, size_t index)
+{
+	std::vector<Block*>& typeBlocks = blocks[memoryType];
+	Block* block = typeBlocks[index];
+	if (block->mapped) vkUnmapMemory(device, block->memory);
+	vkFreeMemory(device, block->memory, nullptr);
+	delete block;
+	typeBlocks.erase(typeBlocks.begin() + index);
+}
+
+/**
+ * @brief Intenta asignar un rango dentro de un bloque.
+ * @param block Bloque en el que buscar.
+ * @param size Tamaño del rango.
+ * @param alignment Alineamiento del rango.
+ * @param linear Indica si el recurso es lineal.
+ * @param offset Inicio del rango asignado (salida).
+ * @return true si se ha encontrado un rango libre.
+ */
+bool GEMemoryAllocator::allocateFromBlock(Block* block, VkDeviceSize size, VkDeviceSize alignment, bool linear, VkDeviceSize* offset)
+{
+	for (auto it = block->freeRanges.begin(); it != block->freeRanges.end(); ++it)
+	{
+		VkDeviceSize freeStart = it->first;
+		VkDeviceSize freeEnd = it->first + it->second;
+		VkDeviceSize start = alignUp(freeStart, alignment);
+
+		// El rango asignado anterior no puede compartir página si es de otro tipo
+		auto next = block->usedRanges.lower_bound(freeStart);
+		if (next != block->usedRanges.begin())
+		{
+			auto prev = std::prev(next);
+			VkDeviceSize prevEnd = prev->first + prev->second.size;
+			if (prev->second.linear != linear && samePage(prevEnd - 1, start, bufferImageGranularity))
+			{
+				start = alignUp(start, bufferImageGranularity);
+			}
+		}
+
+		VkDeviceSize end = start + size;
+		if (end > freeEnd) continue;
+
+		// Tampoco el rango asignado siguiente
+		if (next != block->usedRanges.end() && next->second.linear != linear && samePage(end - 1, next->first, bufferImageGranularity))
+		{
+			continue;
+		}
+
+		block->freeRanges.erase(it);
+		if (start > freeStart) block->freeRanges[freeStart] = start - freeStart;
+		if (freeEnd > end) block->freeRanges[end] = freeEnd - end;
+
+		UsedRange used;
+		used.size = size;
+		used.linear = linear;
+		block->usedRanges[start] = used;
+
+		*offset = start;
+		return true;
+	}
+	return false;
+}
+
+/**
+ * @brief Asigna un rango de memoria para un recurso.
+ * @param requirements Requisitos de memoria del recurso.
+ * @param memoryType Tipo de memoria a usar.
+ * @param linear true para buffers, false para imágenes con tiling óptimo.
+ * @return Rango asignado.
+ */
+GEAllocation GEMemoryAllocator::allocate(const VkMemoryRequirements& requirements, uint32_t memoryType, bool linear)
+{
+	Block* target = nullptr;
+	VkDeviceSize offset = 0;
+
+	for (Block* block : blocks[memoryType])
+	{
+		if (allocateFromBlock(block, requirements.size, requirements.alignment, linear, &offset))
+		{
+			target = block;
+			break;
+		}
+	}
+
+	if (target == nullptr)
+	{
+		// Los recursos mayores que un bloque ordinario reciben un bloque propio
+		VkDeviceSize size = requirements.size > blockSize ? requirements.size : blockSize;
+		target = createBlock(memoryType, size);
+		if (!allocateFromBlock(target, requirements.size, requirements.alignment, linear, &offset))
+		{
+			throw std::runtime_error("failed to allocate memory range!");
+		}
+	}
+
+	GEAllocation allocation = {};
+	allocation.memory = target->memory;
+	allocation.offset = offset;
+	allocation.size = requirements.size;
+	allocation.blockSize = target->size;
+	allocation.memoryType = memoryType;
+	allocation.coherent = (memProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+	allocation.mapped = target->mapped ? target->mapped + offset : nullptr;
+	return allocation;
+}
+
+/**
+ * @brief Libera un rango de memoria (y su bloque si queda vacío y ya hay otro vacío).
+ * @param allocation Rango a liberar.
+ */
+void GEMemoryAllocator::free(const GEAllocation& allocation)
+{
+	std::vector<Block*>& typeBlocks = blocks[allocation.memoryType];
+	for (size_t i = 0; i < typeBlocks.size(); i++)
+	{
+		Block* block = typeBlocks[i];
+		if (block->memory != allocation.memory) continue;
+
+		block->usedRanges.erase(allocation.offset);
+
+		// Inserta el rango libre y lo une con los vecinos contiguos
+		VkDeviceSize start = allocation.offset;
+		VkDeviceSize size = allocation.size;
+		auto next = block->freeRanges.lower_bound(start);
+		if (next != block->freeRanges.end() && start + size == next->first)
+		{
+			size += next->second;
+			next = block->freeRanges.erase(next);
+		}
+		if (next != block->freeRanges.begin())
+		{
+			auto prev = std::prev(next);
+			if (prev->first + prev->second == start)
+			{
+				start = prev->first;
+				size += prev->second;
+				block->freeRanges.erase(prev);
+			}
+		}
+		block->freeRanges[start] = size;
+
+		if (block->usedRanges.empty())
+		{
+			// Se conserva un bloque ordinario vacío para la siguiente asignación
+			bool keep = block->size == blockSize;
+			for (size_t j = 0; keep && j < typeBlocks.size(); j++)
+			{
+				if (j != i && typeBlocks[j]->usedRanges.empty() && typeBlocks[j]->size == blockSize) keep = false;
+			}
+			if (!keep) destroyBlock(allocation.memoryType, i);
+		}
+		return;
+	}
+}
+
+/**
+ * @brief Libera los bloques vacíos que se conservan para reutilizarlos.
+ */
+void GEMemoryAllocator::trim()
+{
+	for (uint32_t type = 0; type < (uint32_t)blocks.size(); type++)
+	{
+		for (size_t i = blocks[type].size(); i > 0; i--)
+		{
+			if (blocks[type][i - 1]->usedRanges.empty()) destroyBlock(type, i - 1);
+		}
+	}
+}
+
+/**
+ * @brief Obtiene las estadísticas de uso.
+ * @return Estadísticas del asignador.
+ */
+GEMemoryStats GEMemoryAllocator::getStats() const
+{
+	GEMemoryStats stats = {};
+	VkDeviceSize bytesFree = 0;
+
+	for (const std::vector<Block*>& typeBlocks : blocks)
+	{
+		for (const Block* block : typeBlocks)
+		{
+			stats.blockCount++;
+			stats.bytesReserved += block->size;
+			for (const auto& used : block->usedRanges)
+			{
+				stats.allocationCount++;
+				stats.bytesUsed += used.second.size;
+			}
+			for (const auto& range : block->freeRanges)
+			{
+				bytesFree += range.second;
+				if (range.second > stats.largestFreeRange) stats.largestFreeRange = range.second;
+			}
+		}
+	}
+
+	stats.fragmentation = bytesFree > 0 ? 1.0f - (float)stats.largestFreeRange / (float)bytesFree : 0.0f;
+	return stats;
+}
+
+/**
+ * @brief Libera todos los bloques.
+ */
+void GEMemoryAllocator::destroy()
+{
+	for (std::vector<Block*>& typeBlocks : blocks)
+	{
+		for (Block* block : typeBlocks)
+		{
+			if (block->mapped) vkUnmapMemory(device, block->memory);
+			vkFreeMemory(device, block->memory, nullptr);
+			delete block;
+		}
+		typeBlocks.clear();
+	}
+}
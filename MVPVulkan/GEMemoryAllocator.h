@@ -0,0 +1,158 @@
+/**
+ * @file GEMemoryAllocator.h
+ * @brief Declaración de la clase GEMemoryAllocator que reparte bloques grandes de memoria del dispositivo.
+ */
+
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <map>
+#include <vector>
+
+/**
+ * @struct GEAllocation
+ * @brief Rango de memoria del dispositivo asignado a un recurso.
+ */
+struct GEAllocation
+{
+	VkDeviceMemory memory;   ///< Bloque de memoria que contiene el rango.
+	VkDeviceSize offset;     ///< Inicio del rango dentro del bloque.
+	VkDeviceSize size;       ///< Tamaño del rango.
+	VkDeviceSize blockSize;  ///< Tamaño del bloque (límite de los rangos de flush).
+	uint32_t memoryType;     ///< Tipo de memoria del bloque.
+	bool coherent;           ///< Indica si la memoria es coherente (no requiere flush).
+	void* mapped;            ///< Dirección del rango en la CPU (nullptr si no es visible).
+};
+
+/**
+ * @struct GEMemoryStats
+ * @brief Estadísticas de uso del asignador de memoria.
+ */
+struct GEMemoryStats
+{
+	uint32_t blockCount;            ///< Número de bloques VkDeviceMemory reservados.
+	uint32_t allocationCount;       ///< Número de rangos asignados.
+	VkDeviceSize bytesReserved;     ///< Bytes reservados en bloques.
+	VkDeviceSize bytesUsed;         ///< Bytes asignados a recursos.
+	VkDeviceSize largestFreeRange;  ///< Mayor rango libre contiguo.
+	float fragmentation;            ///< 1 - (mayor rango libre / bytes libres).
+};
+
+/**
+ * @class GEMemoryAllocator
+ * @brief Asignador de memoria por bloques con listas de rangos libres.
+ *
+ * Reserva bloques VkDeviceMemory grandes por tipo de memoria y reparte en ellos
+ * rangos alineados, de modo que el número de llamadas a vkAllocateMemory no
+ * crece con el número de buffers. Los bloques visibles desde la CPU se mapean
+ * una sola vez al crearlos. Los recursos lineales (buffers) y no lineales
+ * (imágenes con tiling óptimo) que comparten bloque se separan respetando
+ * bufferImageGranularity.
+ *
+ * Se conserva un bloque ordinario vacío por tipo de memoria para que una
+ * secuencia de asignaciones y liberaciones en el límite de un bloque (p. ej. los
+ * staging buffers de las subidas) no reserve y libere bloques continuamente.
+ * trim() lo devuelve al sistema.
+ */
+class GEMemoryAllocator
+{
+private:
+	/**
+	 * @struct UsedRange
+	 * @brief Rango asignado dentro de un bloque.
+	 */
+	struct UsedRange
+	{
+		VkDeviceSize size;  ///< Tamaño del rango.
+		bool linear;        ///< Indica si el recurso es lineal (buffer).
+	};
+
+	/**
+	 * @struct Block
+	 * @brief Bloque de memoria del dispositivo y sus rangos.
+	 */
+	struct Block
+	{
+		VkDeviceMemory memory;                          ///< Memoria del bloque.
+		VkDeviceSize size;                              ///< Tamaño del bloque.
+		uint8_t* mapped;                                ///< Dirección mapeada (nullptr si no es visible).
+		std::map<VkDeviceSize, VkDeviceSize> freeRanges; ///< Rangos libres (offset -> tamaño).
+		std::map<VkDeviceSize, UsedRange> usedRanges;    ///< Rangos asignados (offset -> rango).
+	};
+
+	VkDevice device;                                  ///< Dispositivo lógico.
+	VkPhysicalDeviceMemoryProperties memProperties;   ///< Propiedades de memoria del dispositivo.
+	VkDeviceSize bufferImageGranularity;              ///< Separación entre recursos lineales y no lineales.
+	VkDeviceSize blockSize;                           ///< Tamaño de los bloques ordinarios.
+	std::vector<std::vector<Block*>> blocks;          ///< Bloques por tipo de memoria.
+
+	/**
+	 * @brief Intenta asignar un rango dentro de un bloque.
+	 * @param block Bloque en el que buscar.
+	 * @param size Tamaño del rango.
+	 * @param alignment Alineamiento del rango.
+	 * @param linear Indica si el recurso es lineal.
+	 * @param offset Inicio del rango asignado (salida).
+	 * @return true si se ha encontrado un rango libre.
+	 */
+	bool allocateFromBlock(Block* block, VkDeviceSize size, VkDeviceSize alignment, bool linear, VkDeviceSize* offset);
+
+	/**
+	 * @brief Reserva un nuevo bloque de memoria.
+	 * @param memoryType Tipo de memoria.
+	 * @param size Tamaño del bloque.
+	 * @return Bloque creado.
+	 */
+	Block* createBlock(uint32_t memoryType, VkDeviceSize size);
+
+	/**
+	 * @brief Libera un bloque y lo quita de la lista de su tipo.
+	 * @param memoryType Tipo de memoria del bloque.
+	 * @param index Posición del bloque en la lista.
+	 */
+	void destroyBlock(uint32_t memoryType, size_t index);
+
+public:
+	/**
+	 * @brief Crea el asignador (no reserva memoria hasta la primera asignación).
+	 * @param device Dispositivo lógico.
+	 * @param memProperties Propiedades de memoria del dispositivo físico.
+	 * @param bufferImageGranularity Límite bufferImageGranularity del dispositivo.
+	 * @param blockSize Tamaño de los bloques ordinarios.
+	 */
+	GEMemoryAllocator(VkDevice device, const VkPhysicalDeviceMemoryProperties& memProperties, VkDeviceSize bufferImageGranularity, VkDeviceSize blockSize);
+
+	/**
+	 * @brief Asigna un rango de memoria para un recurso.
+	 * @param requirements Requisitos de memoria del recurso.
+	 * @param memoryType Tipo de memoria a usar.
+	 * @param linear true para buffers, false para imágenes con tiling óptimo.
+	 * @return Rango asignado.
+	 */
+	GEAllocation allocate(const VkMemoryRequirements& requirements, uint32_t memoryType, bool linear);
+
+	/**
+	 * @brief Libera un rango de memoria.
+	 *
+	 * Si el bloque queda vacío se libera, salvo que sea el único bloque ordinario
+	 * vacío de su tipo. Los bloques propios de recursos grandes se liberan siempre.
+	 * @param allocation Rango a liberar.
+	 */
+	void free(const GEAllocation& allocation);
+
+	/**
+	 * @brief Libera los bloques vacíos que se conservan para reutilizarlos.
+	 */
+	void trim();
+
+	/**
+	 * @brief Obtiene las estadísticas de uso.
+	 * @return Estadísticas del asignador.
+	 */
+	GEMemoryStats getStats() const;
+
+	/**
+	 * @brief Libera todos los bloques.
+	 */
+	void destroy();
+};
@@ -0,0 +1,183 @@
+/**
+ * @file GEMesh.cpp
+ * @brief Implementación de la clase GEMesh.
+ */
+
+#include "GEMesh.h"
+#include "GEMeshBuffer.h"
+
+/**
+ * @brief Crea la malla y sube los vértices e índices a la GPU.
+ * @param gc Contexto gráfico.
+ * @param vertices Lista de vértices.
+ * @param indices Lista de índices.
+ * @param upload Contexto de subida a memoria DEVICE_LOCAL (nullptr para memoria visible desde la CPU).
+ */
+GEMesh::GEMesh(GEGraphicsContext* gc, std::vector<GEVertex> vertices, std::vector<uint32_t> indices, GEUploadContext* upload)
+{
+	optimizeMesh(vertices, indices);
+
+	size_t vertexSize = sizeof(GEVertex) * vertices.size();
+
+	// Los índices de 16 bits ocupan la mitad: solo se usan 32 bits si hacen falta
+	std::vector<uint16_t> shortIndices;
+	const void* indexData = indices.data();
+	size_t indexSize = sizeof(uint32_t) * indices.size();
+	indexType = VK_INDEX_TYPE_UINT32;
+	if (vertices.size() <= MAX_MESHLET_VERTICES)
+	{
+		shortIndices.resize(indices.size());
+		for (size_t i = 0; i < indices.size(); i++)
+		{
+			shortIndices[i] = (uint16_t)indices[i];
+		}
+		indexData = shortIndices.data();
+		indexSize = sizeof(uint16_t) * shortIndices.size();
+		indexType = VK_INDEX_TYPE_UINT16;
+	}
+
+	if (upload != nullptr)
+	{
+		// Geometría estática: los datos se copian en el próximo upload->submit()
+		vbo = new GEVertexBuffer(gc, upload, vertexSize, vertices.data());
+		ibo = new GEIndexBuffer(gc, upload, indexSize, indexData);
+	}
+	else
+	{
+		vbo = new GEVertexBuffer(gc, vertexSize, vertices.data());
+		ibo = new GEIndexBuffer(gc, indexSize, indexData);
+	}
+
+	meshBuffer = nullptr;
+	vertexCount = (uint32_t)vertices.size();
+	indexCount = (uint32_t)indices.size();
+	meshlets.resize(1);
+	meshlets[0].indexCount = indexCount;
+	meshlets[0].firstIndex = 0;
+	meshlets[0].vertexOffset = 0;
+	refCount = 1;
+	bounds = computeBoundingSphere(vertices);
+	dequantize = glm::mat4(1.0f);
+}
+
+/**
+ * @brief Crea la malla a partir de geometría ya optimizada.
+ * @param gc Contexto gráfico.
+ * @param upload Contexto de subida a memoria DEVICE_LOCAL (nullptr para memoria visible desde la CPU).
+ * @param vertices Vértices de la malla.
+ * @param vertexCount Número de vértices.
+ * @param indices Índices de la malla.
+ * @param indexCount Número de índices.
+ * @param indexType Tipo de los índices.
+ * @param bounds Esfera envolvente de la malla.
+ */
+GEMesh::GEMesh(GEGraphicsContext* gc, GEUploadContext* upload, const GEVertex* vertices, uint32_t vertexCount,
+	const void* indices, uint32_t indexCount, VkIndexType indexType, const GEBoundingSphere& bounds)
+{
+	size_t vertexSize = sizeof(GEVertex) * vertexCount;
+	size_t indexSize = ((indexType == VK_INDEX_TYPE_UINT16) ? sizeof(uint16_t) : sizeof(uint32_t)) * indexCount;
+
+	if (upload != nullptr)
+	{
+		// Los datos pasan del origen al staging buffer sin copia intermedia
+		vbo = new GEVertexBuffer(gc, upload, vertexSize, vertices, false);
+		ibo = new GEIndexBuffer(gc, upload, indexSize, indices, false);
+	}
+	else
+	{
+		vbo = new GEVertexBuffer(gc, vertexSize, vertices);
+		ibo = new GEIndexBuffer(gc, indexSize, indices);
+	}
+
+	this->meshBuffer = nullptr;
+	this->vertexCount = vertexCount;
+	this->indexCount = indexCount;
+	this->indexType = indexType;
+	this->meshlets.resize(1);
+	this->meshlets[0].indexCount = indexCount;
+	this->meshlets[0].firstIndex = 0;
+	this->meshlets[0].vertexOffset = 0;
+	this->refCount = 1;
+	this->bounds = bounds;
+	this->dequantize = glm::mat4(1.0f);
+}
+
+/**
+ * @brief Crea una malla que ocupa uno o varios rangos de un buffer compartido.
+ * @param meshBuffer Buffer compartido.
+ * @param vertexCount Número de vértices.
+ * @param meshlets Rangos de la malla.
+ */
+GEMesh::GEMesh(GEMeshBuffer* meshBuffer, uint32_t vertexCount, const std::vector<GEMeshlet>& meshlets)
+{
+	this->vbo = nullptr;
+	this->ibo = nullptr;
+	this->meshBuffer = meshBuffer;
+	this->vertexCount = vertexCount;
+	this->indexCount = 0;
+	for (const GEMeshlet& m : meshlets)
+	{
+		this->indexCount += m.indexCount;
+	}
+	this->indexType = VK_INDEX_TYPE_UINT16;
+	this->meshlets = meshlets;
+	this->refCount = 1;
+	this->bounds = GEBoundingSphere();
+	this->dequantize = glm::mat4(1.0f);
+}
+
+/**
+ * @brief Enlaza el vertex buffer y el index buffer de la malla.
+ * @param commandBuffer Buffer de comandos.
+ */
+void GEMesh::bind(VkCommandBuffer commandBuffer)
+{
+	if (meshBuffer != nullptr)
+	{
+		meshBuffer->bind(commandBuffer);
+		return;
+	}
+
+	VkDeviceSize offset = 0;
+	vkCmdBindVertexBuffers(commandBuffer, 0, 1, &(vbo->buffer), &offset);
+	vkCmdBindIndexBuffer(commandBuffer, ibo->buffer, 0, indexType);
+}
+
+/**
+ * @brief Identifica los buffers que enlaza bind().
+ * @return El GEMeshBuffer de la malla, o la propia malla si tiene buffers propios.
+ */
+const void* GEMesh::getBinding() const
+{
+	if (meshBuffer != nullptr) return meshBuffer;
+	return this;
+}
+
+/**
+ * @brief Añade los draws indexados de la malla, uno por meshlet.
+ * @param commandBuffer Buffer de comandos.
+ * @param instanceCount Número de instancias.
+ * @param firstInstance Primera instancia.
+ */
+void GEMesh::draw(VkCommandBuffer commandBuffer, uint32_t instanceCount, uint32_t firstInstance)
+{
+	for (const GEMeshlet& m : meshlets)
+	{
+		vkCmdDrawIndexed(commandBuffer, m.indexCount, instanceCount, m.firstIndex, m.vertexOffset, firstInstance);
+	}
+}
+
+/**
+ * @brief Destruye los buffers de la malla.
+ * @param gc Contexto gráfico.
+ */
+void GEMesh::destroy(GEGraphicsContext* gc)
+{
+	if (meshBuffer != nullptr) return;
+
+	vbo->destroy(gc);
+	ibo->destroy(gc);
+
+	delete vbo;
+	delete ibo;
+}
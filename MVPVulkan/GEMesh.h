@@ -0,0 +1,121 @@
+/**
+ * @file GEMesh.h
+ * @brief Declaración de la clase GEMesh que agrupa los buffers de una malla.
+ */
+
+#pragma once
+
+#include "GEGraphicsContext.h"
+#include "GEVertex.h"
+#include "GEVertexBuffer.h"
+#include "GEIndexBuffer.h"
+#include "GEUploadContext.h"
+#include "GEFrustum.h"
+#include "GEMeshOptimizer.h"
+#include <vector>
+
+class GEMeshBuffer;
+
+const uint32_t MAX_MESHLET_VERTICES = 65536; ///< Vértices direccionables con índices de 16 bits.
+
+/**
+ * @struct GEMeshlet
+ * @brief Rango de índices y vértices que se dibuja con un solo draw.
+ */
+typedef struct
+{
+	uint32_t indexCount;  ///< Número de índices.
+	uint32_t firstIndex;  ///< Primer índice en el index buffer.
+	int32_t vertexOffset; ///< Primer vértice en el vertex buffer.
+} GEMeshlet;
+
+/**
+ * @class GEMesh
+ * @brief Malla almacenada en la GPU (vertex buffer + index buffer).
+ *
+ * Una misma malla puede ser compartida por varias figuras. El contador
+ * de referencias lo gestiona GEMeshCache. La malla puede tener sus propios
+ * buffers o un rango dentro de los buffers compartidos de un GEMeshBuffer.
+ *
+ * Con buffers propios los índices son de 16 bits si la malla tiene como máximo
+ * MAX_MESHLET_VERTICES vértices, y de 32 bits si tiene más. En un GEMeshBuffer
+ * siempre son de 16 bits: las mallas grandes se dividen en varios meshlets.
+ */
+class GEMesh
+{
+public:
+	GEVertexBuffer* vbo;       ///< Vertex buffer object (nullptr si la malla está en un GEMeshBuffer).
+	GEIndexBuffer* ibo;        ///< Index buffer object (nullptr si la malla está en un GEMeshBuffer).
+	GEMeshBuffer* meshBuffer;  ///< Buffer compartido que contiene la malla (nullptr si tiene buffers propios).
+	uint32_t vertexCount;      ///< Número de vértices.
+	uint32_t indexCount;       ///< Número total de índices.
+	VkIndexType indexType;     ///< Tipo de los índices (UINT16 o UINT32).
+	std::vector<GEMeshlet> meshlets; ///< Rangos de la malla en el index buffer (uno salvo que se haya dividido).
+	uint32_t refCount;         ///< Número de figuras que usan la malla.
+	GEBoundingSphere bounds;   ///< Esfera envolvente en coordenadas del modelo.
+	glm::mat4 dequantize;      ///< Paso de las posiciones cuantizadas a coordenadas del modelo (identidad si la malla no está comprimida).
+
+	/**
+	 * @brief Crea la malla y sube los vértices e índices a la GPU.
+	 *
+	 * La geometría se optimiza con optimizeMesh() antes de subirla.
+	 * @param gc Contexto gráfico.
+	 * @param vertices Lista de vértices.
+	 * @param indices Lista de índices.
+	 * @param upload Contexto de subida a memoria DEVICE_LOCAL (nullptr para memoria visible desde la CPU).
+	 */
+	GEMesh(GEGraphicsContext* gc, std::vector<GEVertex> vertices, std::vector<uint32_t> indices, GEUploadContext* upload = nullptr);
+
+	/**
+	 * @brief Crea la malla a partir de geometría ya optimizada (ver GEMeshFile).
+	 *
+	 * Con upload los datos no se copian: deben seguir en memoria hasta upload->submit().
+	 * @param gc Contexto gráfico.
+	 * @param upload Contexto de subida a memoria DEVICE_LOCAL (nullptr para memoria visible desde la CPU).
+	 * @param vertices Vértices de la malla.
+	 * @param vertexCount Número de vértices.
+	 * @param indices Índices de la malla.
+	 * @param indexCount Número de índices.
+	 * @param indexType Tipo de los índices.
+	 * @param bounds Esfera envolvente de la malla.
+	 */
+	GEMesh(GEGraphicsContext* gc, GEUploadContext* upload, const GEVertex* vertices, uint32_t vertexCount,
+		const void* indices, uint32_t indexCount, VkIndexType indexType, const GEBoundingSphere& bounds);
+
+	/**
+	 * @brief Crea una malla que ocupa uno o varios rangos de un buffer compartido (ver GEMeshBuffer::add()).
+	 * @param meshBuffer Buffer compartido.
+	 * @param vertexCount Número de vértices.
+	 * @param meshlets Rangos de la malla.
+	 */
+	GEMesh(GEMeshBuffer* meshBuffer, uint32_t vertexCount, const std::vector<GEMeshlet>& meshlets);
+
+	/**
+	 * @brief Enlaza el vertex buffer y el index buffer de la malla.
+	 * @param commandBuffer Buffer de comandos.
+	 */
+	void bind(VkCommandBuffer commandBuffer);
+
+	/**
+	 * @brief Identifica los buffers que enlaza bind().
+	 *
+	 * Las mallas de un mismo GEMeshBuffer comparten buffers: entre ellas no hace
+	 * falta volver a enlazar.
+	 * @return El GEMeshBuffer de la malla, o la propia malla si tiene buffers propios.
+	 */
+	const void* getBinding() const;
+
+	/**
+	 * @brief Añade los draws indexados de la malla, uno por meshlet (los buffers deben estar enlazados).
+	 * @param commandBuffer Buffer de comandos.
+	 * @param instanceCount Número de instancias.
+	 * @param firstInstance Primera instancia.
+	 */
+	void draw(VkCommandBuffer commandBuffer, uint32_t instanceCount, uint32_t firstInstance);
+
+	/**
+	 * @brief Destruye los buffers propios de la malla (los compartidos los destruye GEMeshBuffer).
+	 * @param gc Contexto gráfico.
+	 */
+	void destroy(GEGraphicsContext* gc);
+};
@@ -0,0 +1,288 @@
+/**
+ * @file GEMeshBuffer.cpp
+ * @brief Implementación de la clase GEMeshBuffer.
+ */
+
+#include "GEMeshBuffer.h"
+#include "GEMesh.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+/**
+ * @brief Convierte un valor en [-1, 1] a SNORM16.
+ * @param v Valor a convertir.
+ * @return Valor cuantizado.
+ */
+static int16_t toSnorm16(float v)
+{
+	v = std::min(std::max(v, -1.0f), 1.0f);
+	return (int16_t)std::lround(v * 32767.0f);
+}
+
+/**
+ * @brief Comprime un vértice.
+ * @param v Vértice original.
+ * @param center Centro de la cuantización.
+ * @param invScale Inverso del radio de la cuantización.
+ * @return Vértice comprimido.
+ */
+static GEPackedVertex packVertex(const GEVertex& v, glm::vec3 center, float invScale)
+{
+	GEPackedVertex packed;
+	glm::vec3 p = (v.pos - center) * invScale;
+	packed.pos[0] = toSnorm16(p.x);
+	packed.pos[1] = toSnorm16(p.y);
+	packed.pos[2] = toSnorm16(p.z);
+	packed.pos[3] = 0;
+
+	// Proyección sobre el octaedro |x| + |y| + |z| = 1 y plegado del hemisferio inferior
+	glm::vec3 n = v.norm;
+	float sum = std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z);
+	float ox = (sum > 0.0f) ? n.x / sum : 0.0f;
+	float oy = (sum > 0.0f) ? n.y / sum : 0.0f;
+	if (n.z < 0.0f)
+	{
+		float fx = (1.0f - std::fabs(oy)) * (ox >= 0.0f ? 1.0f : -1.0f);
+		float fy = (1.0f - std::fabs(ox)) * (oy >= 0.0f ? 1.0f : -1.0f);
+		ox = fx;
+		oy = fy;
+	}
+	packed.norm[0] = toSnorm16(ox);
+	packed.norm[1] = toSnorm16(oy);
+	return packed;
+}
+
+/**
+ * @brief Crea un buffer de mallas vacío.
+ * @param packed true para guardar los vértices comprimidos.
+ */
+GEMeshBuffer::GEMeshBuffer(bool packed)
+{
+	this->packed = packed;
+	vertexCount = 0;
+	indexCount = 0;
+	cacheStats = {};
+	vbo = nullptr;
+	ibo = nullptr;
+}
+
+/**
+ * @brief Reserva los rangos de una malla y copia su geometría.
+ * @param vertices Lista de vértices.
+ * @param indices Lista de índices.
+ * @return Malla que apunta a sus rangos dentro de los buffers compartidos.
+ */
+GEMesh* GEMeshBuffer::add(std::vector<GEVertex> vertices, std::vector<uint32_t> indices)
+{
+	if (vbo != nullptr)
+	{
+		throw std::runtime_error("failed to add mesh to an already built mesh buffer!");
+	}
+
+	// Orden de triángulos y vértices para la caché de vértices transformados
+	GEVertexCacheStats stats = optimizeMesh(vertices, indices);
+	uint32_t triangles = cacheStats.triangleCount + stats.triangleCount;
+	if (triangles > 0)
+	{
+		cacheStats.acmrBefore = (cacheStats.acmrBefore * cacheStats.triangleCount + stats.acmrBefore * stats.triangleCount) / triangles;
+		cacheStats.acmrAfter = (cacheStats.acmrAfter * cacheStats.triangleCount + stats.acmrAfter * stats.triangleCount) / triangles;
+		cacheStats.triangleCount = triangles;
+	}
+
+	GEBoundingSphere bounds = computeBoundingSphere(vertices);
+	uint32_t firstVertex = vertexCount;
+	std::vector<GEMeshlet> meshlets;
+
+	GEMeshlet meshlet = {};
+	meshlet.firstIndex = indexCount;
+	meshlet.vertexOffset = (int32_t)vertexCount;
+
+	if (vertices.size() <= MAX_MESHLET_VERTICES)
+	{
+		for (const GEVertex& v : vertices)
+		{
+			addVertex(v, bounds);
+		}
+		for (uint32_t i : indices)
+		{
+			this->indices.push_back((uint16_t)i);
+		}
+		meshlet.indexCount = (uint32_t)indices.size();
+		indexCount += meshlet.indexCount;
+		meshlets.push_back(meshlet);
+	}
+	else
+	{
+		// Los triángulos se reparten en orden: cada meshlet copia los vértices que usa
+		// hasta llenar los 16 bits y el siguiente empieza con un mapa vacío
+		std::vector<uint32_t> remap(vertices.size(), UINT32_MAX);
+		std::vector<uint32_t> used;
+		for (size_t t = 0; t + 2 < indices.size(); t += 3)
+		{
+			uint32_t newVertices = 0;
+			for (int k = 0; k < 3; k++)
+			{
+				if (remap[indices[t + k]] == UINT32_MAX) newVertices++;
+			}
+			if (used.size() + newVertices > MAX_MESHLET_VERTICES)
+			{
+				meshlets.push_back(meshlet);
+				for (uint32_t v : used) remap[v] = UINT32_MAX;
+				used.clear();
+				meshlet.indexCount = 0;
+				meshlet.firstIndex = indexCount;
+				meshlet.vertexOffset = (int32_t)vertexCount;
+			}
+
+			for (int k = 0; k < 3; k++)
+			{
+				uint32_t v = indices[t + k];
+				if (remap[v] == UINT32_MAX)
+				{
+					remap[v] = (uint32_t)used.size();
+					used.push_back(v);
+					addVertex(vertices[v], bounds);
+				}
+				this->indices.push_back((uint16_t)remap[v]);
+			}
+			meshlet.indexCount += 3;
+			indexCount += 3;
+		}
+		if (meshlet.indexCount > 0) meshlets.push_back(meshlet);
+	}
+
+	GEMesh* mesh = new GEMesh(this, vertexCount - firstVertex, meshlets);
+	mesh->bounds = bounds;
+	if (packed)
+	{
+		float scale = (bounds.radius > 0.0f) ? bounds.radius : 1.0f;
+		mesh->dequantize = glm::scale(glm::translate(glm::mat4(1.0f), bounds.center), glm::vec3(scale));
+	}
+	return mesh;
+}
+
+/**
+ * @brief Añade un vértice en el formato del buffer.
+ * @param v Vértice original.
+ * @param bounds Esfera envolvente de la malla.
+ */
+void GEMeshBuffer::addVertex(const GEVertex& v, const GEBoundingSphere& bounds)
+{
+	if (packed)
+	{
+		// Escala uniforme: la matriz de la malla sigue siendo válida para transformar las normales
+		float scale = (bounds.radius > 0.0f) ? bounds.radius : 1.0f;
+		packedVertices.push_back(packVertex(v, bounds.center, 1.0f / scale));
+	}
+	else
+	{
+		vertices.push_back(v);
+	}
+	vertexCount++;
+}
+
+/**
+ * @brief Crea los buffers compartidos con toda la geometría añadida.
+ * @param gc Contexto gráfico.
+ * @param upload Contexto de subida a memoria DEVICE_LOCAL.
+ */
+void GEMeshBuffer::build(GEGraphicsContext* gc, GEUploadContext* upload)
+{
+	if (vertexCount == 0) return;
+
+	size_t vertexSize = (size_t)getVertexSize() * vertexCount;
+	size_t indexSize = sizeof(uint16_t) * indices.size();
+	const void* vertexData = packed ? (const void*)packedVertices.data() : (const void*)vertices.data();
+
+	if (upload != nullptr)
+	{
+		// El contexto de subida copia los datos: las listas se pueden liberar ya
+		vbo = new GEVertexBuffer(gc, upload, vertexSize, vertexData);
+		ibo = new GEIndexBuffer(gc, upload, indexSize, indices.data());
+	}
+	else
+	{
+		vbo = new GEVertexBuffer(gc, vertexSize, vertexData);
+		ibo = new GEIndexBuffer(gc, indexSize, indices.data());
+	}
+
+	std::vector<GEVertex>().swap(vertices);
+	std::vector<GEPackedVertex>().swap(packedVertices);
+	std::vector<uint16_t>().swap(indices);
+}
+
+/**
+ * @brief Enlaza los buffers compartidos en un command buffer.
+ * @param commandBuffer Buffer de comandos.
+ */
+void GEMeshBuffer::bind(VkCommandBuffer commandBuffer)
+{
+	VkDeviceSize offset = 0;
+	vkCmdBindVertexBuffers(commandBuffer, 0, 1, &(vbo->buffer), &offset);
+	vkCmdBindIndexBuffer(commandBuffer, ibo->buffer, 0, VK_INDEX_TYPE_UINT16);
+}
+
+/**
+ * @brief Obtiene el número total de vértices.
+ * @return Número de vértices.
+ */
+uint32_t GEMeshBuffer::getVertexCount() const
+{
+	return vertexCount;
+}
+
+/**
+ * @brief Obtiene el número total de índices.
+ * @return Número de índices.
+ */
+uint32_t GEMeshBuffer::getIndexCount() const
+{
+	return indexCount;
+}
+
+/**
+ * @brief Obtiene el ACMR de las mallas antes y después de optimizarlas.
+ * @return Estadísticas acumuladas.
+ */
+GEVertexCacheStats GEMeshBuffer::getCacheStats() const
+{
+	return cacheStats;
+}
+
+/**
+ * @brief Indica si los vértices se guardan comprimidos.
+ * @return true si el formato de vértice es GEPackedVertex.
+ */
+bool GEMeshBuffer::isPacked() const
+{
+	return packed;
+}
+
+/**
+ * @brief Obtiene el tamaño en bytes de cada vértice.
+ * @return sizeof(GEPackedVertex) o sizeof(GEVertex).
+ */
+uint32_t GEMeshBuffer::getVertexSize() const
+{
+	return packed ? (uint32_t)sizeof(GEPackedVertex) : (uint32_t)sizeof(GEVertex);
+}
+
+/**
+ * @brief Destruye los buffers compartidos.
+ * @param gc Contexto gráfico.
+ */
+void GEMeshBuffer::destroy(GEGraphicsContext* gc)
+{
+	if (vbo == nullptr) return;
+
+	vbo->destroy(gc);
+	ibo->destroy(gc);
+
+	delete vbo;
+	delete ibo;
+	vbo = nullptr;
+	ibo = nullptr;
+}
@@ -0,0 +1,125 @@
+/**
+ * @file GEMeshBuffer.h
+ * @brief Declaración de la clase GEMeshBuffer que agrupa la geometría estática en dos buffers compartidos.
+ */
+
+#pragma once
+
+#include "GEGraphicsContext.h"
+#include "GEVertex.h"
+#include "GEVertexBuffer.h"
+#include "GEIndexBuffer.h"
+#include "GEUploadContext.h"
+#include "GEFrustum.h"
+#include "GEMeshOptimizer.h"
+#include <vector>
+
+class GEMesh;
+
+/**
+ * @class GEMeshBuffer
+ * @brief Vertex buffer e index buffer únicos para todas las mallas estáticas.
+ *
+ * Cada malla ocupa un rango de vértices y otro de índices dentro de los buffers
+ * compartidos, y se dibuja con firstIndex y vertexOffset. Los índices son de 16 bits
+ * y relativos a vertexOffset: las mallas con más de MAX_MESHLET_VERTICES vértices
+ * se dividen en meshlets, cada uno con sus propios vértices. Como todas las mallas
+ * usan los mismos buffers, basta con enlazarlos una vez y los draws de varias
+ * mallas se pueden describir con VkDrawIndexedIndirectCommand en un solo buffer.
+ *
+ * Las mallas se añaden antes de build(); el espacio no se recupera al liberarlas
+ * (la geometría estática vive lo mismo que la escena).
+ *
+ * Un buffer comprimido guarda los vértices como GEPackedVertex. Cada malla se
+ * cuantiza respecto a su esfera envolvente y guarda en GEMesh::dequantize la
+ * matriz que deshace la cuantización; quien la dibuje debe multiplicarla por su
+ * matriz Model y usar un pipeline con el formato comprimido.
+ */
+class GEMeshBuffer
+{
+private:
+	bool packed; ///< Los vértices se guardan como GEPackedVertex.
+	std::vector<GEVertex> vertices; ///< Vértices pendientes de subir.
+	std::vector<GEPackedVertex> packedVertices; ///< Vértices comprimidos pendientes de subir.
+	std::vector<uint16_t> indices; ///< Índices pendientes de subir (locales a cada meshlet).
+	uint32_t vertexCount; ///< Número total de vértices.
+	uint32_t indexCount; ///< Número total de índices.
+	GEVertexCacheStats cacheStats; ///< ACMR de todas las mallas añadidas (media ponderada por triángulos).
+
+public:
+	GEVertexBuffer* vbo; ///< Vertex buffer compartido (nullptr hasta build()).
+	GEIndexBuffer* ibo; ///< Index buffer compartido (nullptr hasta build()).
+
+	/**
+	 * @brief Crea un buffer de mallas vacío.
+	 * @param packed true para guardar los vértices comprimidos (GEPackedVertex).
+	 */
+	GEMeshBuffer(bool packed = false);
+
+	/**
+	 * @brief Reserva el rango de una malla y copia su geometría.
+	 *
+	 * La copia se optimiza con optimizeMesh() antes de guardarla.
+	 * @param vertices Lista de vértices.
+	 * @param indices Lista de índices (relativos al primer vértice de la malla).
+	 * @return Malla que apunta a sus rangos dentro de los buffers compartidos.
+	 */
+	GEMesh* add(std::vector<GEVertex> vertices, std::vector<uint32_t> indices);
+
+	/**
+	 * @brief Crea los buffers compartidos con toda la geometría añadida.
+	 * @param gc Contexto gráfico.
+	 * @param upload Contexto de subida a memoria DEVICE_LOCAL (nullptr para memoria visible desde la CPU).
+	 */
+	void build(GEGraphicsContext* gc, GEUploadContext* upload);
+
+	/**
+	 * @brief Enlaza los buffers compartidos en un command buffer.
+	 * @param commandBuffer Buffer de comandos.
+	 */
+	void bind(VkCommandBuffer commandBuffer);
+
+	/**
+	 * @brief Obtiene el número total de vértices.
+	 * @return Número de vértices.
+	 */
+	uint32_t getVertexCount() const;
+
+	/**
+	 * @brief Obtiene el número total de índices.
+	 * @return Número de índices.
+	 */
+	uint32_t getIndexCount() const;
+
+	/**
+	 * @brief Obtiene el ACMR de las mallas antes y después de optimizarlas.
+	 * @return Estadísticas acumuladas de todas las mallas añadidas.
+	 */
+	GEVertexCacheStats getCacheStats() const;
+
+	/**
+	 * @brief Indica si los vértices se guardan comprimidos.
+	 * @return true si el formato de vértice es GEPackedVertex.
+	 */
+	bool isPacked() const;
+
+	/**
+	 * @brief Obtiene el tamaño en bytes de cada vértice.
+	 * @return sizeof(GEPackedVertex) o sizeof(GEVertex).
+	 */
+	uint32_t getVertexSize() const;
+
+	/**
+	 * @brief Destruye los buffers compartidos.
+	 * @param gc Contexto gráfico.
+	 */
+	void destroy(GEGraphicsContext* gc);
+
+private:
+	/**
+	 * @brief Añade un vértice en el formato del buffer.
+	 * @param v Vértice original.
+	 * @param bounds Esfera envolvente de la malla (referencia de la cuantización).
+	 */
+	void addVertex(const GEVertex& v, const GEBoundingSphere& bounds);
+};
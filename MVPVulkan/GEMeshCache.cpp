@@ -0,0 +1,192 @@
+/**
+ * @file GEMeshCache.cpp
+ * @brief Implementación de la clase GEMeshCache.
+ */
+
+#include "GEMeshCache.h"
+
+#include "GESphere.h"
+#include "GECylinder.h"
+#include <algorithm>
+
+/**
+ * @brief Crea una caché vacía.
+ * @param upload Contexto de subida a memoria DEVICE_LOCAL.
+ * @param meshBuffer Buffer de mallas compartido.
+ */
+GEMeshCache::GEMeshCache(GEUploadContext* upload, GEMeshBuffer* meshBuffer)
+{
+	this->upload = upload;
+	this->meshBuffer = meshBuffer;
+}
+
+/**
+ * @brief Busca una malla existente e incrementa su contador de referencias.
+ * @param key Clave de la malla.
+ * @return Malla encontrada o nullptr.
+ */
+GEMesh* GEMeshCache::find(const std::string& key)
+{
+	auto it = meshes.find(key);
+	if (it == meshes.end()) return nullptr;
+
+	it->second->refCount++;
+	return it->second;
+}
+
+/**
+ * @brief Obtiene la malla asociada a una clave o la crea a partir de una figura.
+ * @param gc Contexto gráfico.
+ * @param key Clave de la malla.
+ * @param generator Figura que contiene la geometría.
+ * @return Malla compartida.
+ */
+GEMesh* GEMeshCache::acquire(GEGraphicsContext* gc, const std::string& key, GEFigure* generator)
+{
+	GEMesh* mesh;
+	if (meshBuffer != nullptr)
+	{
+		mesh = meshBuffer->add(generator->getVertices(), generator->getIndices());
+	}
+	else
+	{
+		mesh = new GEMesh(gc, generator->getVertices(), generator->getIndices(), upload);
+	}
+	meshes[key] = mesh;
+	return mesh;
+}
+
+/**
+ * @brief Obtiene la malla de una esfera.
+ * @param gc Contexto gráfico.
+ * @param p Número de divisiones en latitud.
+ * @param m Número de divisiones en longitud.
+ * @param r Radio de la esfera.
+ * @return Malla compartida.
+ */
+GEMesh* GEMeshCache::getSphere(GEGraphicsContext* gc, int p, int m, float r)
+{
+	std::string key = "sphere:" + std::to_string(p) + ":" + std::to_string(m) + ":" + std::to_string(r);
+	GEMesh* mesh = find(key);
+	if (mesh != nullptr) return mesh;
+
+	GESphere sphere(p, m, r);
+	return acquire(gc, key, &sphere);
+}
+
+/**
+ * @brief Obtiene la malla de un cilindro.
+ * @param gc Contexto gráfico.
+ * @param p Número de divisiones en altura.
+ * @param m Número de divisiones en circunferencia.
+ * @param r Radio del cilindro.
+ * @param l Semilongitud del cilindro.
+ * @return Malla compartida.
+ */
+GEMesh* GEMeshCache::getCylinder(GEGraphicsContext* gc, int p, int m, float r, float l)
+{
+	std::string key = "cylinder:" + std::to_string(p) + ":" + std::to_string(m) + ":" + std::to_string(r) + ":" + std::to_string(l);
+	GEMesh* mesh = find(key);
+	if (mesh != nullptr) return mesh;
+
+	GECylinder cylinder(p, m, r, l);
+	return acquire(gc, key, &cylinder);
+}
+
+/**
+ * @brief Obtiene las mallas de una esfera con varios niveles de detalle.
+ * @param gc Contexto gráfico.
+ * @param p Número de divisiones en latitud del nivel 0.
+ * @param m Número de divisiones en longitud del nivel 0.
+ * @param r Radio de la esfera.
+ * @param levels Número de niveles.
+ * @return Cadena de mallas compartidas.
+ */
+GEMeshLod GEMeshCache::getSphereLod(GEGraphicsContext* gc, int p, int m, float r, uint32_t levels)
+{
+	GEMeshLod lod = {};
+	lod.levelCount = std::min(std::max(levels, 1u), MAX_LOD_LEVELS);
+	for (uint32_t i = 0; i < lod.levelCount; i++)
+	{
+		lod.levels[i] = getSphere(gc, std::max(p >> i, 2), std::max(m >> i, 4), r);
+	}
+	return lod;
+}
+
+/**
+ * @brief Obtiene las mallas de un cilindro con varios niveles de detalle.
+ * @param gc Contexto gráfico.
+ * @param p Número de divisiones en altura del nivel 0.
+ * @param m Número de divisiones en circunferencia del nivel 0.
+ * @param r Radio del cilindro.
+ * @param l Semilongitud del cilindro.
+ * @param levels Número de niveles.
+ * @return Cadena de mallas compartidas.
+ */
+GEMeshLod GEMeshCache::getCylinderLod(GEGraphicsContext* gc, int p, int m, float r, float l, uint32_t levels)
+{
+	GEMeshLod lod = {};
+	lod.levelCount = std::min(std::max(levels, 1u), MAX_LOD_LEVELS);
+	for (uint32_t i = 0; i < lod.levelCount; i++)
+	{
+		lod.levels[i] = getCylinder(gc, std::max(p >> i, 1), std::max(m >> i, 4), r, l);
+	}
+	return lod;
+}
+
+/**
+ * @brief Libera una referencia a una malla y la destruye si ya no se usa.
+ * @param gc Contexto gráfico.
+ * @param mesh Malla a liberar.
+ */
+void GEMeshCache::release(GEGraphicsContext* gc, GEMesh* mesh)
+{
+	if (mesh == nullptr || --mesh->refCount > 0) return;
+
+	for (auto it = meshes.begin(); it != meshes.end(); ++it)
+	{
+		if (it->second == mesh)
+		{
+			meshes.erase(it);
+			break;
+		}
+	}
+	mesh->destroy(gc);
+	delete mesh;
+}
+
+/**
+ * @brief Libera una referencia a cada nivel de una cadena de mallas.
+ * @param gc Contexto gráfico.
+ * @param lod Cadena de mallas a liberar.
+ */
+void GEMeshCache::release(GEGraphicsContext* gc, const GEMeshLod& lod)
+{
+	for (uint32_t i = 0; i < lod.levelCount; i++)
+	{
+		release(gc, lod.levels[i]);
+	}
+}
+
+/**
+ * @brief Destruye todas las mallas de la caché.
+ * @param gc Contexto gráfico.
+ */
+void GEMeshCache::destroy(GEGraphicsContext* gc)
+{
+	for (auto& entry : meshes)
+	{
+		entry.second->destroy(gc);
+		delete entry.second;
+	}
+	meshes.clear();
+}
+
+/**
+ * @brief Obtiene el número de mallas distintas almacenadas.
+ * @return Número de mallas.
+ */
+size_t GEMeshCache::size() const
+{
+	return meshes.size();
+}
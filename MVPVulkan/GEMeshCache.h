@@ -0,0 +1,127 @@
+/**
+ * @file GEMeshCache.h
+ * @brief Declaración de la clase GEMeshCache que comparte mallas procedurales.
+ */
+
+#pragma once
+
+#include "GEGraphicsContext.h"
+#include "GEMesh.h"
+#include "GEMeshBuffer.h"
+#include "GEMeshLod.h"
+#include "GEFigure.h"
+#include <map>
+#include <string>
+
+/**
+ * @class GEMeshCache
+ * @brief Caché de mallas indexada por tipo de generador y parámetros.
+ *
+ * Las figuras con la misma geometría (por ejemplo, las esferas de todas
+ * las articulaciones) reciben la misma GEMesh, de modo que solo se crea
+ * un vertex buffer y un index buffer por combinación de parámetros.
+ */
+class GEMeshCache
+{
+private:
+	std::map<std::string, GEMesh*> meshes; ///< Mallas creadas, por clave.
+	GEUploadContext* upload; ///< Contexto de subida de las mallas (nullptr para memoria visible desde la CPU).
+	GEMeshBuffer* meshBuffer; ///< Buffer compartido donde se colocan las mallas (nullptr para buffers propios).
+
+	/**
+	 * @brief Obtiene la malla asociada a una clave o la crea a partir de una figura.
+	 * @param gc Contexto gráfico.
+	 * @param key Clave de la malla.
+	 * @param generator Figura que contiene la geometría (solo se usa si no existe).
+	 * @return Malla compartida.
+	 */
+	GEMesh* acquire(GEGraphicsContext* gc, const std::string& key, GEFigure* generator);
+
+	/**
+	 * @brief Busca una malla existente e incrementa su contador de referencias.
+	 * @param key Clave de la malla.
+	 * @return Malla encontrada o nullptr.
+	 */
+	GEMesh* find(const std::string& key);
+
+public:
+	/**
+	 * @brief Crea una caché vacía.
+	 * @param upload Contexto de subida a memoria DEVICE_LOCAL (nullptr para memoria visible desde la CPU).
+	 * @param meshBuffer Buffer de mallas compartido (nullptr para que cada malla tenga sus buffers).
+	 */
+	GEMeshCache(GEUploadContext* upload = nullptr, GEMeshBuffer* meshBuffer = nullptr);
+
+	/**
+	 * @brief Obtiene la malla de una esfera.
+	 * @param gc Contexto gráfico.
+	 * @param p Número de divisiones en latitud.
+	 * @param m Número de divisiones en longitud.
+	 * @param r Radio de la esfera.
+	 * @return Malla compartida.
+	 */
+	GEMesh* getSphere(GEGraphicsContext* gc, int p, int m, float r);
+
+	/**
+	 * @brief Obtiene la malla de un cilindro.
+	 * @param gc Contexto gráfico.
+	 * @param p Número de divisiones en altura.
+	 * @param m Número de divisiones en circunferencia.
+	 * @param r Radio del cilindro.
+	 * @param l Semilongitud del cilindro.
+	 * @return Malla compartida.
+	 */
+	GEMesh* getCylinder(GEGraphicsContext* gc, int p, int m, float r, float l);
+
+	/**
+	 * @brief Obtiene las mallas de una esfera con varios niveles de detalle.
+	 *
+	 * Cada nivel divide entre dos las divisiones del anterior, sin bajar del mínimo
+	 * que mantiene la forma de la esfera.
+	 * @param gc Contexto gráfico.
+	 * @param p Número de divisiones en latitud del nivel 0.
+	 * @param m Número de divisiones en longitud del nivel 0.
+	 * @param r Radio de la esfera.
+	 * @param levels Número de niveles (como máximo MAX_LOD_LEVELS).
+	 * @return Cadena de mallas compartidas.
+	 */
+	GEMeshLod getSphereLod(GEGraphicsContext* gc, int p, int m, float r, uint32_t levels);
+
+	/**
+	 * @brief Obtiene las mallas de un cilindro con varios niveles de detalle.
+	 * @param gc Contexto gráfico.
+	 * @param p Número de divisiones en altura del nivel 0.
+	 * @param m Número de divisiones en circunferencia del nivel 0.
+	 * @param r Radio del cilindro.
+	 * @param l Semilongitud del cilindro.
+	 * @param levels Número de niveles (como máximo MAX_LOD_LEVELS).
+	 * @return Cadena de mallas compartidas.
+	 */
+	GEMeshLod getCylinderLod(GEGraphicsContext* gc, int p, int m, float r, float l, uint32_t levels);
+
+	/**
+	 * @brief Libera una referencia a una malla y la destruye si ya no se usa.
+	 * @param gc Contexto gráfico.
+	 * @param mesh Malla a liberar.
+	 */
+	void release(GEGraphicsContext* gc, GEMesh* mesh);
+
+	/**
+	 * @brief Libera una referencia a cada nivel de una cadena de mallas.
+	 * @param gc Contexto gráfico.
+	 * @param lod Cadena de mallas a liberar.
+	 */
+	void release(GEGraphicsContext* gc, const GEMeshLod& lod);
+
+	/**
+	 * @brief Destruye todas las mallas de la caché.
+	 * @param gc Contexto gráfico.
+	 */
+	void destroy(GEGraphicsContext* gc);
+
+	/**
+	 * @brief Obtiene el número de mallas distintas almacenadas.
+	 * @return Número de mallas.
+	 */
+	size_t size() const;
+};
@@ -0,0 +1,226 @@
+/**
+ * @file GEMeshConverter.cpp
+ * @brief Implementación del conversor de ficheros OBJ al formato binario de mallas.
+ */
+
+#include "GEMeshConverter.h"
+
+#include "GEMeshFile.h"
+#include "GEMeshOptimizer.h"
+#include <glm/glm.hpp>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <unordered_map>
+#include <stdexcept>
+#include <cstdlib>
+
+/**
+ * @brief Convierte un índice de OBJ (desde 1, o negativo desde el final) en un índice desde 0.
+ * @param index Índice leído del fichero.
+ * @param count Número de elementos leídos hasta el momento.
+ * @return Índice desde 0 (-1 si no es válido).
+ */
+static int64_t resolveObjIndex(long index, size_t count)
+{
+	int64_t i = (index > 0) ? (int64_t)index - 1 : (int64_t)count + index;
+	return (i >= 0 && i < (int64_t)count) ? i : -1;
+}
+
+/**
+ * @brief Lee la geometría de un fichero OBJ.
+ * @param path Ruta del fichero OBJ.
+ * @param vertices Vértices leídos.
+ * @param indices Índices de los triángulos.
+ */
+void loadObj(const std::string& path, std::vector<GEVertex>& vertices, std::vector<uint32_t>& indices)
+{
+	std::ifstream in(path);
+	if (!in)
+	{
+		throw std::runtime_error("failed to open OBJ file!");
+	}
+
+	std::vector<glm::vec3> positions;
+	std::vector<glm::vec3> normals;
+	std::unordered_map<uint64_t, uint32_t> vertexMap;  // (posición, normal + 1) -> vértice
+	std::vector<bool> missingNormal;
+
+	vertices.clear();
+	indices.clear();
+
+	std::string line;
+	std::vector<uint32_t> face;
+	while (std::getline(in, line))
+	{
+		std::istringstream tokens(line);
+		std::string type;
+		tokens >> type;
+
+		if (type == "v")
+		{
+			glm::vec3 p(0.0f);
+			tokens >> p.x >> p.y >> p.z;
+			positions.push_back(p);
+		}
+		else if (type == "vn")
+		{
+			glm::vec3 n(0.0f);
+			tokens >> n.x >> n.y >> n.z;
+			normals.push_back(n);
+		}
+		else if (type == "f")
+		{
+			// Cada elemento es v, v/vt, v//vn o v/vt/vn
+			face.clear();
+			std::string element;
+			while (tokens >> element)
+			{
+				const char* text = element.c_str();
+				char* end;
+				int64_t p = resolveObjIndex(strtol(text, &end, 10), positions.size());
+				int64_t n = -1;
+				if (*end == '/')
+				{
+					strtol(end + 1, &end, 10);
+					if (*end == '/') n = resolveObjIndex(strtol(end + 1, &end, 10), normals.size());
+				}
+				if (p < 0)
+				{
+					throw std::runtime_error("failed to parse OBJ face!");
+				}
+
+				uint64_t key = ((uint64_t)p << 32) | (uint64_t)(n + 1);
+				auto it = vertexMap.find(key);
+				if (it == vertexMap.end())
+				{
+					GEVertex v;
+					v.pos = positions[p];
+					v.norm = (n >= 0) ? normals[n] : glm::vec3(0.0f);
+					it = vertexMap.emplace(key, (uint32_t)vertices.size()).first;
+					vertices.push_back(v);
+					missingNormal.push_back(n < 0);
+				}
+				face.push_back(it->second);
+			}
+
+			for (size_t k = 1; k + 1 < face.size(); k++)
+			{
+				indices.push_back(face[0]);
+				indices.push_back(face[k]);
+				indices.push_back(face[k + 1]);
+			}
+		}
+	}
+
+	// Normales que faltan: suma de las normales de las caras ponderada por su área
+	for (size_t t = 0; t + 2 < indices.size(); t += 3)
+	{
+		glm::vec3 n = glm::cross(vertices[indices[t + 1]].pos - vertices[indices[t]].pos, vertices[indices[t + 2]].pos - vertices[indices[t]].pos);
+		for (int k = 0; k < 3; k++)
+		{
+			if (missingNormal[indices[t + k]]) vertices[indices[t + k]].norm += n;
+		}
+	}
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		float length = glm::length(vertices[i].norm);
+		if (missingNormal[i] && length > 0.0f) vertices[i].norm /= length;
+	}
+}
+
+/**
+ * @brief Redondea una posición del fichero al siguiente múltiplo de 16.
+ * @param offset Posición.
+ * @return Posición alineada.
+ */
+static uint64_t alignOffset(uint64_t offset)
+{
+	return (offset + 15) & ~(uint64_t)15;
+}
+
+/**
+ * @brief Convierte uno o varios ficheros OBJ en un fichero de malla.
+ * @param objPaths Ficheros OBJ de cada nivel.
+ * @param outPath Ruta del fichero de salida.
+ */
+void convertObjToMeshFile(const std::vector<std::string>& objPaths, const std::string& outPath)
+{
+	if (objPaths.empty() || objPaths.size() > MAX_LOD_LEVELS)
+	{
+		throw std::runtime_error("failed to convert mesh: wrong number of LOD levels!");
+	}
+
+	std::vector<GEVertex> vertices;
+	std::vector<uint32_t> indices;
+	std::vector<GEMeshFileLod> lods(objPaths.size());
+	bool shortIndices = true;
+
+	for (size_t i = 0; i < objPaths.size(); i++)
+	{
+		std::vector<GEVertex> levelVertices;
+		std::vector<uint32_t> levelIndices;
+		loadObj(objPaths[i], levelVertices, levelIndices);
+		if (levelIndices.empty())
+		{
+			throw std::runtime_error("failed to convert mesh: OBJ file has no faces!");
+		}
+
+		GEVertexCacheStats stats = optimizeMesh(levelVertices, levelIndices);
+		std::cout << "[Conversor] nivel " << i << ": " << levelVertices.size() << " vertices, "
+			<< stats.triangleCount << " triangulos, ACMR " << stats.acmrBefore << " -> " << stats.acmrAfter << std::endl;
+
+		lods[i].firstVertex = (uint32_t)vertices.size();
+		lods[i].vertexCount = (uint32_t)levelVertices.size();
+		lods[i].firstIndex = (uint32_t)indices.size();
+		lods[i].indexCount = (uint32_t)levelIndices.size();
+		shortIndices = shortIndices && levelVertices.size() <= MAX_MESHLET_VERTICES;
+
+		vertices.insert(vertices.end(), levelVertices.begin(), levelVertices.end());
+		indices.insert(indices.end(), levelIndices.begin(), levelIndices.end());
+	}
+
+	GEMeshFileHeader header = {};
+	header.magic = MESH_FILE_MAGIC;
+	header.version = MESH_FILE_VERSION;
+	header.vertexCount = (uint32_t)vertices.size();
+	header.indexCount = (uint32_t)indices.size();
+	header.indexSize = shortIndices ? 2 : 4;
+	header.lodCount = (uint32_t)lods.size();
+	header.bounds = computeBoundingSphere(std::vector<GEVertex>(vertices.begin(), vertices.begin() + lods[0].vertexCount));
+	header.lodOffset = sizeof(GEMeshFileHeader);
+	header.vertexOffset = alignOffset(header.lodOffset + lods.size() * sizeof(GEMeshFileLod));
+	header.indexOffset = alignOffset(header.vertexOffset + vertices.size() * sizeof(GEVertex));
+
+	std::ofstream out(outPath, std::ios::binary);
+	if (!out)
+	{
+		throw std::runtime_error("failed to create mesh file!");
+	}
+
+	const char padding[16] = {};
+	out.write((const char*)&header, sizeof(header));
+	out.write((const char*)lods.data(), lods.size() * sizeof(GEMeshFileLod));
+	out.write(padding, (std::streamsize)(header.vertexOffset - (uint64_t)out.tellp()));
+	out.write((const char*)vertices.data(), vertices.size() * sizeof(GEVertex));
+	out.write(padding, (std::streamsize)(header.indexOffset - (uint64_t)out.tellp()));
+	if (shortIndices)
+	{
+		std::vector<uint16_t> shorts(indices.size());
+		for (size_t i = 0; i < indices.size(); i++)
+		{
+			shorts[i] = (uint16_t)indices[i];
+		}
+		out.write((const char*)shorts.data(), shorts.size() * sizeof(uint16_t));
+	}
+	else
+	{
+		out.write((const char*)indices.data(), indices.size() * sizeof(uint32_t));
+	}
+
+	if (!out)
+	{
+		throw std::runtime_error("failed to write mesh file!");
+	}
+	std::cout << "[Conversor] " << outPath << ": " << (uint64_t)out.tellp() << " bytes" << std::endl;
+}
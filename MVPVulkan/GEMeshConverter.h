@@ -0,0 +1,33 @@
+/**
+ * @file GEMeshConverter.h
+ * @brief Declaración de las funciones que convierten ficheros OBJ al formato binario de mallas.
+ */
+
+#pragma once
+
+#include "GEVertex.h"
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+/**
+ * @brief Lee la geometría de un fichero OBJ.
+ *
+ * Admite vértices (v), normales (vn) y caras (f) de cualquier número de lados,
+ * que se dividen en abanicos de triángulos. Los vértices sin normal reciben la
+ * media de las normales de sus caras.
+ * @param path Ruta del fichero OBJ.
+ * @param vertices Vértices leídos (un vértice por cada par posición/normal distinto).
+ * @param indices Índices de los triángulos.
+ */
+void loadObj(const std::string& path, std::vector<GEVertex>& vertices, std::vector<uint32_t>& indices);
+
+/**
+ * @brief Convierte uno o varios ficheros OBJ en un fichero de malla (.gem).
+ *
+ * Cada OBJ es un nivel de detalle. La geometría se optimiza con optimizeMesh()
+ * antes de escribirla, así que el fichero se puede subir a la GPU sin procesarlo.
+ * @param objPaths Ficheros OBJ de cada nivel (el primero es el más detallado).
+ * @param outPath Ruta del fichero de salida.
+ */
+void convertObjToMeshFile(const std::vector<std::string>& objPaths, const std::string& outPath);
@@ -0,0 +1,182 @@
+/**
+ * @file GEMeshFile.cpp
+ * @brief Implementación de la clase GEMeshFile.
+ */
+
+#include "GEMeshFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <stdexcept>
+
+/**
+ * @brief Proyecta el fichero en memoria y comprueba su cabecera.
+ * @param path Ruta del fichero .gem.
+ */
+GEMeshFile::GEMeshFile(const std::string& path)
+{
+#ifdef _WIN32
+	file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		throw std::runtime_error("failed to open mesh file!");
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < (LONGLONG)sizeof(GEMeshFileHeader))
+	{
+		CloseHandle(file);
+		throw std::runtime_error("failed to read mesh file size!");
+	}
+	size = (size_t)fileSize.QuadPart;
+
+	mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	data = (mapping != nullptr) ? (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+	if (data == nullptr)
+	{
+		if (mapping != nullptr) CloseHandle(mapping);
+		CloseHandle(file);
+		throw std::runtime_error("failed to map mesh file!");
+	}
+#else
+	file = open(path.c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		throw std::runtime_error("failed to open mesh file!");
+	}
+
+	struct stat fileStat;
+	if (fstat(file, &fileStat) != 0 || fileStat.st_size < (off_t)sizeof(GEMeshFileHeader))
+	{
+		::close(file);
+		throw std::runtime_error("failed to read mesh file size!");
+	}
+	size = (size_t)fileStat.st_size;
+
+	void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+	if (view == MAP_FAILED)
+	{
+		::close(file);
+		throw std::runtime_error("failed to map mesh file!");
+	}
+	data = (const uint8_t*)view;
+	// Equivalente a FILE_FLAG_SEQUENTIAL_SCAN: los bloques se leen en orden al subirlos
+	madvise(view, size, MADV_SEQUENTIAL);
+#endif
+
+	// Se leen la cabecera, la tabla de niveles y los índices: los vértices se cargan al subirlos
+	header = (const GEMeshFileHeader*)data;
+	lods = nullptr;
+
+	uint64_t vertexBytes = (uint64_t)header->vertexCount * sizeof(GEVertex);
+	uint64_t indexBytes = (uint64_t)header->indexCount * header->indexSize;
+	bool valid = header->magic == MESH_FILE_MAGIC && header->version == MESH_FILE_VERSION
+		&& (header->indexSize == 2 || header->indexSize == 4)
+		&& header->lodCount >= 1 && header->lodCount <= MAX_LOD_LEVELS
+		&& header->lodOffset + header->lodCount * sizeof(GEMeshFileLod) <= size
+		&& header->vertexOffset % 4 == 0 && header->vertexOffset + vertexBytes <= size
+		&& header->indexOffset % 4 == 0 && header->indexOffset + indexBytes <= size;
+	if (valid) lods = (const GEMeshFileLod*)(data + header->lodOffset);
+	for (uint32_t i = 0; valid && i < header->lodCount; i++)
+	{
+		valid = lods[i].vertexCount > 0 && lods[i].indexCount > 0 && lods[i].indexCount % 3 == 0
+			&& (uint64_t)lods[i].firstVertex + lods[i].vertexCount <= header->vertexCount
+			&& (uint64_t)lods[i].firstIndex + lods[i].indexCount <= header->indexCount;
+
+		// Un índice fuera del nivel leería vértices de otro nivel o fuera del buffer
+		const uint8_t* levelIndices = data + header->indexOffset + (size_t)lods[i].firstIndex * header->indexSize;
+		for (uint32_t j = 0; valid && j < lods[i].indexCount; j++)
+		{
+			uint32_t index = (header->indexSize == 2) ? ((const uint16_t*)levelIndices)[j] : ((const uint32_t*)levelIndices)[j];
+			valid = index < lods[i].vertexCount;
+		}
+	}
+	if (!valid)
+	{
+		close();
+		throw std::runtime_error("failed to load mesh file: invalid header or indices!");
+	}
+}
+
+/**
+ * @brief Cierra el fichero si sigue abierto.
+ */
+GEMeshFile::~GEMeshFile()
+{
+	close();
+}
+
+/**
+ * @brief Obtiene la cabecera del fichero.
+ * @return Cabecera.
+ */
+const GEMeshFileHeader& GEMeshFile::getHeader() const
+{
+	return *header;
+}
+
+/**
+ * @brief Crea una malla con buffers propios por cada nivel de detalle.
+ * @param gc Contexto gráfico.
+ * @param upload Contexto de subida.
+ * @return Cadena de mallas del fichero.
+ */
+GEMeshLod GEMeshFile::load(GEGraphicsContext* gc, GEUploadContext* upload) const
+{
+	GEMeshLod lod = {};
+	lod.levelCount = header->lodCount;
+	for (uint32_t i = 0; i < lod.levelCount; i++)
+	{
+		lod.levels[i] = loadLevel(gc, upload, i);
+	}
+	return lod;
+}
+
+/**
+ * @brief Crea una malla con buffers propios para un nivel de detalle.
+ * @param gc Contexto gráfico.
+ * @param upload Contexto de subida.
+ * @param level Nivel de detalle.
+ * @return Malla del nivel.
+ */
+GEMesh* GEMeshFile::loadLevel(GEGraphicsContext* gc, GEUploadContext* upload, uint32_t level) const
+{
+	if (level >= header->lodCount)
+	{
+		throw std::runtime_error("failed to load mesh file level!");
+	}
+
+	const GEVertex* vertices = (const GEVertex*)(data + header->vertexOffset);
+	const uint8_t* indices = data + header->indexOffset;
+	VkIndexType indexType = (header->indexSize == 2) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+
+	const GEMeshFileLod& lod = lods[level];
+	return new GEMesh(gc, upload, vertices + lod.firstVertex, lod.vertexCount,
+		indices + (size_t)lod.firstIndex * header->indexSize, lod.indexCount, indexType, header->bounds);
+}
+
+/**
+ * @brief Deshace la proyección y cierra el fichero.
+ */
+void GEMeshFile::close()
+{
+	if (data == nullptr) return;
+
+#ifdef _WIN32
+	UnmapViewOfFile(data);
+	CloseHandle(mapping);
+	CloseHandle(file);
+#else
+	munmap((void*)data, size);
+	::close(file);
+#endif
+	data = nullptr;
+	header = nullptr;
+	lods = nullptr;
+}
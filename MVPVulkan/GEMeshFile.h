@@ -0,0 +1,129 @@
+/**
+ * @file GEMeshFile.h
+ * @brief Declaración del formato binario de mallas y de la clase GEMeshFile que lo carga.
+ */
+
+#pragma once
+
+#include "GEGraphicsContext.h"
+#include "GEUploadContext.h"
+#include "GEMesh.h"
+#include "GEMeshLod.h"
+#include "GEFrustum.h"
+#include <string>
+#include <stdint.h>
+
+const uint32_t MESH_FILE_MAGIC = 0x464D4547; ///< "GEMF" leído como uint32_t little endian.
+const uint32_t MESH_FILE_VERSION = 1; ///< Versión del formato de fichero de mallas.
+
+/**
+ * @struct GEMeshFileHeader
+ * @brief Cabecera de un fichero de malla (.gem).
+ *
+ * Detrás de la cabecera van la tabla de niveles (GEMeshFileLod), los vértices de
+ * todos los niveles (GEVertex) y sus índices, cada bloque alineado a 16 bytes.
+ * Los datos se guardan ya optimizados (ver optimizeMesh()) y en el formato que
+ * espera la GPU, así que se suben sin procesarlos.
+ *
+ * Los vértices son siempre GEVertex sin comprimir: las mallas cargadas se dibujan
+ * con el pipeline de las figuras y no pueden entrar en un GEMeshBuffer comprimido
+ * (GEPackedVertex), que cuantiza cada malla respecto a su esfera al añadirla.
+ */
+typedef struct
+{
+	uint32_t magic;          ///< MESH_FILE_MAGIC.
+	uint32_t version;        ///< MESH_FILE_VERSION.
+	uint32_t vertexCount;    ///< Vértices de todos los niveles.
+	uint32_t indexCount;     ///< Índices de todos los niveles.
+	uint32_t indexSize;      ///< Bytes por índice (2 o 4).
+	uint32_t lodCount;       ///< Número de niveles de detalle.
+	GEBoundingSphere bounds; ///< Esfera envolvente del nivel 0.
+	uint64_t lodOffset;      ///< Posición de la tabla de niveles.
+	uint64_t vertexOffset;   ///< Posición del bloque de vértices.
+	uint64_t indexOffset;    ///< Posición del bloque de índices.
+} GEMeshFileHeader;
+
+/**
+ * @struct GEMeshFileLod
+ * @brief Rango de vértices e índices de un nivel de detalle.
+ */
+typedef struct
+{
+	uint32_t firstVertex; ///< Primer vértice del nivel.
+	uint32_t vertexCount; ///< Número de vértices del nivel.
+	uint32_t firstIndex;  ///< Primer índice del nivel (relativo a firstVertex).
+	uint32_t indexCount;  ///< Número de índices del nivel.
+} GEMeshFileLod;
+
+static_assert(sizeof(GEMeshFileHeader) == 64, "GEMeshFileHeader must match the file layout");
+
+/**
+ * @class GEMeshFile
+ * @brief Fichero de malla proyectado en memoria.
+ *
+ * El fichero se proyecta en memoria (MapViewOfFile en Windows, mmap en el resto
+ * de sistemas) y load() entrega al
+ * contexto de subida punteros dentro de la proyección: los vértices e índices
+ * se copian una sola vez, directamente al staging buffer, en upload->submit().
+ * Por eso close() debe llamarse después de submit().
+ *
+ * Al abrirlo se comprueban la cabecera, la tabla de niveles y que todos los
+ * índices de cada nivel estén por debajo de su número de vértices.
+ */
+class GEMeshFile
+{
+private:
+#ifdef _WIN32
+	void* file;                    ///< HANDLE del fichero.
+	void* mapping;                 ///< HANDLE de la proyección.
+#else
+	int file;                      ///< Descriptor del fichero.
+#endif
+	const uint8_t* data;           ///< Inicio del fichero proyectado.
+	size_t size;                   ///< Tamaño del fichero en bytes.
+	const GEMeshFileHeader* header; ///< Cabecera dentro de la proyección.
+	const GEMeshFileLod* lods;     ///< Tabla de niveles dentro de la proyección.
+
+public:
+	/**
+	 * @brief Proyecta el fichero en memoria y comprueba su cabecera.
+	 * @param path Ruta del fichero .gem.
+	 */
+	GEMeshFile(const std::string& path);
+
+	/**
+	 * @brief Cierra el fichero si sigue abierto.
+	 */
+	~GEMeshFile();
+
+	GEMeshFile(const GEMeshFile&) = delete;
+	GEMeshFile& operator=(const GEMeshFile&) = delete;
+
+	/**
+	 * @brief Obtiene la cabecera del fichero.
+	 * @return Cabecera.
+	 */
+	const GEMeshFileHeader& getHeader() const;
+
+	/**
+	 * @brief Crea una malla con buffers propios por cada nivel de detalle.
+	 * @param gc Contexto gráfico.
+	 * @param upload Contexto de subida (el fichero debe seguir abierto hasta upload->submit()).
+	 * @return Cadena de mallas del fichero.
+	 */
+	GEMeshLod load(GEGraphicsContext* gc, GEUploadContext* upload) const;
+
+	/**
+	 * @brief Crea una malla con buffers propios para un nivel de detalle.
+	 * @param gc Contexto gráfico.
+	 * @param upload Contexto de subida (el fichero debe seguir abierto hasta upload->submit()).
+	 * @param level Nivel de detalle (menor que lodCount).
+	 * @return Malla del nivel.
+	 */
+	GEMesh* loadLevel(GEGraphicsContext* gc, GEUploadContext* upload, uint32_t level) const;
+
+	/**
+	 * @brief Deshace la proyección y cierra el fichero.
+	 */
+	void close();
+};
@@ -0,0 +1,45 @@
+/**
+ * @file GEMeshLod.cpp
+ * @brief Implementación de las funciones de selección del nivel de detalle.
+ */
+
+#include "GEMeshLod.h"
+
+#include <algorithm>
+
+/**
+ * @brief Calcula el radio proyectado en pantalla de una esfera envolvente.
+ * @param sphere Esfera en coordenadas del mundo.
+ * @param view Datos de la cámara.
+ * @return Radio aproximado en píxeles.
+ */
+float computeScreenRadius(const GEBoundingSphere& sphere, const GELodView& view)
+{
+	// Dentro de la esfera (o casi) el objeto ocupa toda la pantalla
+	float distance = std::max(glm::length(sphere.center - view.eye), sphere.radius);
+	if (distance <= 0.0f) return view.pixelScale;
+	return sphere.radius * view.pixelScale / distance;
+}
+
+/**
+ * @brief Elige el nivel de detalle a partir del radio en pantalla.
+ * @param screenRadius Radio en píxeles.
+ * @param current Nivel usado en el frame anterior.
+ * @param levelCount Número de niveles disponibles.
+ * @return Nivel de detalle elegido.
+ */
+uint32_t selectLodLevel(float screenRadius, uint32_t current, uint32_t levelCount)
+{
+	uint32_t level = std::min(current, levelCount - 1);
+
+	// El umbral entre los niveles k y k + 1 es LOD_SCREEN_RADIUS / 2^k
+	while (level + 1 < levelCount && screenRadius < LOD_SCREEN_RADIUS / (float)(1u << level) * (1.0f - LOD_HYSTERESIS))
+	{
+		level++;
+	}
+	while (level > 0 && screenRadius > LOD_SCREEN_RADIUS / (float)(1u << (level - 1)) * (1.0f + LOD_HYSTERESIS))
+	{
+		level--;
+	}
+	return level;
+}
@@ -0,0 +1,56 @@
+/**
+ * @file GEMeshLod.h
+ * @brief Declaración de las estructuras y funciones para elegir el nivel de detalle de una malla.
+ */
+
+#pragma once
+
+#include "GEMesh.h"
+#include "GEFrustum.h"
+#include <glm/glm.hpp>
+#include <stdint.h>
+
+const uint32_t MAX_LOD_LEVELS = 4; ///< Número máximo de niveles de detalle por malla.
+const float LOD_SCREEN_RADIUS = 48.0f; ///< Radio en píxeles por debajo del cual se pasa al nivel 1 (se divide por 2 en cada nivel).
+const float LOD_HYSTERESIS = 0.15f; ///< Margen relativo alrededor de cada umbral para no alternar entre niveles.
+
+/**
+ * @struct GEMeshLod
+ * @brief Cadena de mallas de la misma figura con teselación decreciente.
+ */
+typedef struct
+{
+	GEMesh* levels[MAX_LOD_LEVELS]; ///< Mallas de cada nivel (el nivel 0 es el más detallado).
+	uint32_t levelCount;            ///< Número de niveles usados.
+} GEMeshLod;
+
+/**
+ * @struct GELodView
+ * @brief Datos de la cámara necesarios para proyectar el tamaño de un objeto en pantalla.
+ */
+typedef struct
+{
+	glm::vec3 eye;    ///< Posición de la cámara en coordenadas del mundo.
+	float pixelScale; ///< Píxeles que ocupa un objeto de tamaño 1 a distancia 1 (alto de la imagen * proyección[1][1] / 2).
+} GELodView;
+
+/**
+ * @brief Calcula el radio proyectado en pantalla de una esfera envolvente.
+ * @param sphere Esfera en coordenadas del mundo.
+ * @param view Datos de la cámara.
+ * @return Radio aproximado en píxeles.
+ */
+float computeScreenRadius(const GEBoundingSphere& sphere, const GELodView& view);
+
+/**
+ * @brief Elige el nivel de detalle a partir del radio en pantalla.
+ *
+ * Cada nivel cubre la mitad de radio que el anterior. Para cambiar de nivel hay que
+ * superar el umbral en un LOD_HYSTERESIS relativo, así que un objeto que oscila
+ * alrededor de un umbral mantiene su nivel en lugar de cambiarlo en cada frame.
+ * @param screenRadius Radio en píxeles.
+ * @param current Nivel usado en el frame anterior.
+ * @param levelCount Número de niveles disponibles.
+ * @return Nivel de detalle elegido.
+ */
+uint32_t selectLodLevel(float screenRadius, uint32_t current, uint32_t levelCount);
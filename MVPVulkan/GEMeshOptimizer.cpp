@@ -0,0 +1,312 @@
+/**
+ * @file GEMeshOptimizer.cpp
+ * @brief Implementación de las funciones de optimización de mallas.
+ */
+
+#include "GEMeshOptimizer.h"
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+
+static const float FORSYTH_CACHE_DECAY = 1.5f; ///< Exponente con el que cae la puntuación según la posición en la caché.
+static const float FORSYTH_LAST_TRIANGLE_SCORE = 0.75f; ///< Puntuación de los vértices del último triángulo emitido.
+static const float FORSYTH_VALENCE_SCALE = 2.0f; ///< Peso de los triángulos pendientes de cada vértice.
+
+/**
+ * @brief Calcula la puntuación de un vértice según el algoritmo de Forsyth.
+ * @param cachePosition Posición en la caché LRU (-1 si no está).
+ * @param remaining Triángulos pendientes que usan el vértice.
+ * @return Puntuación (-1 si ya no quedan triángulos).
+ */
+static float forsythScore(int32_t cachePosition, uint32_t remaining)
+{
+	if (remaining == 0) return -1.0f;
+
+	float score = 0.0f;
+	if (cachePosition >= 0)
+	{
+		// Los tres vértices del último triángulo puntúan igual para no favorecer un sentido
+		if (cachePosition < 3) score = FORSYTH_LAST_TRIANGLE_SCORE;
+		else score = powf(1.0f - (float)(cachePosition - 3) / (float)(FORSYTH_CACHE_SIZE - 3), FORSYTH_CACHE_DECAY);
+	}
+
+	// Terminar primero los vértices con pocos triángulos evita dejar huecos aislados
+	return score + FORSYTH_VALENCE_SCALE / sqrtf((float)remaining);
+}
+
+/**
+ * @brief Calcula el ACMR de una lista de índices.
+ * @param indices Lista de índices.
+ * @param vertexCount Número de vértices.
+ * @return Fallos de caché por triángulo.
+ */
+float computeACMR(const std::vector<uint32_t>& indices, uint32_t vertexCount)
+{
+	if (indices.size() < 3) return 0.0f;
+
+	// Cada vértice guarda el instante en que entró en la caché FIFO
+	std::vector<uint32_t> timestamp(vertexCount, 0);
+	uint32_t time = VERTEX_CACHE_SIZE + 1;
+	uint32_t misses = 0;
+	for (uint32_t v : indices)
+	{
+		if (time - timestamp[v] > VERTEX_CACHE_SIZE)
+		{
+			timestamp[v] = time++;
+			misses++;
+		}
+	}
+	return (float)misses / (float)(indices.size() / 3);
+}
+
+/**
+ * @brief Reordena los triángulos para aprovechar la caché de vértices transformados.
+ * @param indices Lista de índices.
+ * @param vertexCount Número de vértices.
+ */
+void optimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount)
+{
+	uint32_t triangleCount = (uint32_t)(indices.size() / 3);
+	if (triangleCount == 0) return;
+
+	// Triángulos de cada vértice en listas consecutivas: los de remaining[v] primeras posiciones están pendientes
+	std::vector<uint32_t> remaining(vertexCount, 0);
+	for (size_t i = 0; i < triangleCount * 3; i++)
+	{
+		remaining[indices[i]]++;
+	}
+	std::vector<uint32_t> offsets(vertexCount + 1, 0);
+	for (uint32_t v = 0; v < vertexCount; v++)
+	{
+		offsets[v + 1] = offsets[v] + remaining[v];
+	}
+	std::vector<uint32_t> adjacency(triangleCount * 3);
+	std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+	for (uint32_t t = 0; t < triangleCount; t++)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			adjacency[fill[indices[t * 3 + k]]++] = t;
+		}
+	}
+
+	std::vector<int32_t> cachePosition(vertexCount, -1);
+	std::vector<float> vertexScore(vertexCount);
+	for (uint32_t v = 0; v < vertexCount; v++)
+	{
+		vertexScore[v] = forsythScore(-1, remaining[v]);
+	}
+	std::vector<float> triangleScore(triangleCount);
+	std::vector<bool> emitted(triangleCount, false);
+	uint32_t best = 0;
+	for (uint32_t t = 0; t < triangleCount; t++)
+	{
+		triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+		if (triangleScore[t] > triangleScore[best]) best = t;
+	}
+
+	std::vector<uint32_t> result;
+	result.reserve(triangleCount * 3);
+	std::vector<uint32_t> cache;
+	std::vector<uint32_t> newCache;
+	uint32_t cursor = 0;
+
+	for (uint32_t n = 0; n < triangleCount; n++)
+	{
+		emitted[best] = true;
+
+		// Los vértices del triángulo pasan al principio de la caché
+		newCache.clear();
+		for (int k = 0; k < 3; k++)
+		{
+			uint32_t v = indices[best * 3 + k];
+			result.push_back(v);
+			if (std::find(newCache.begin(), newCache.end(), v) == newCache.end()) newCache.push_back(v);
+
+			uint32_t* list = &adjacency[offsets[v]];
+			for (uint32_t j = 0; j < remaining[v]; j++)
+			{
+				if (list[j] == best)
+				{
+					list[j] = list[remaining[v] - 1];
+					remaining[v]--;
+					break;
+				}
+			}
+		}
+		size_t triangleVertices = newCache.size();
+		for (uint32_t v : cache)
+		{
+			if (std::find(newCache.begin(), newCache.begin() + triangleVertices, v) == newCache.begin() + triangleVertices)
+			{
+				newCache.push_back(v);
+			}
+		}
+
+		// Los que salen de la caché pierden su puntuación de posición
+		for (size_t i = FORSYTH_CACHE_SIZE; i < newCache.size(); i++)
+		{
+			uint32_t v = newCache[i];
+			cachePosition[v] = -1;
+			vertexScore[v] = forsythScore(-1, remaining[v]);
+		}
+		if (newCache.size() > FORSYTH_CACHE_SIZE) newCache.resize(FORSYTH_CACHE_SIZE);
+		for (size_t i = 0; i < newCache.size(); i++)
+		{
+			uint32_t v = newCache[i];
+			cachePosition[v] = (int32_t)i;
+			vertexScore[v] = forsythScore((int32_t)i, remaining[v]);
+		}
+		cache.swap(newCache);
+
+		// El siguiente triángulo se busca solo entre los que tocan la caché
+		float bestScore = -1.0f;
+		bool found = false;
+		for (uint32_t v : cache)
+		{
+			for (uint32_t j = 0; j < remaining[v]; j++)
+			{
+				uint32_t t = adjacency[offsets[v] + j];
+				triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+				if (!found || triangleScore[t] > bestScore)
+				{
+					best = t;
+					bestScore = triangleScore[t];
+					found = true;
+				}
+			}
+		}
+
+		// Si la caché no toca ningún triángulo pendiente se sigue por el primero sin emitir
+		if (!found)
+		{
+			while (cursor < triangleCount && emitted[cursor]) cursor++;
+			if (cursor == triangleCount) break;
+			best = cursor;
+		}
+	}
+
+	indices.swap(result);
+}
+
+/**
+ * @brief Reordena grupos de triángulos para reducir el overdraw.
+ * @param vertices Lista de vértices.
+ * @param indices Lista de índices.
+ */
+void optimizeOverdraw(const std::vector<GEVertex>& vertices, std::vector<uint32_t>& indices)
+{
+	uint32_t triangleCount = (uint32_t)(indices.size() / 3);
+	if (triangleCount == 0) return;
+
+	// Un grupo empieza en cada triángulo que falla en sus tres vértices
+	std::vector<uint32_t> clusters;
+	std::vector<uint32_t> timestamp(vertices.size(), 0);
+	uint32_t time = VERTEX_CACHE_SIZE + 1;
+	for (uint32_t t = 0; t < triangleCount; t++)
+	{
+		uint32_t misses = 0;
+		for (int k = 0; k < 3; k++)
+		{
+			uint32_t v = indices[t * 3 + k];
+			if (time - timestamp[v] > VERTEX_CACHE_SIZE)
+			{
+				timestamp[v] = time++;
+				misses++;
+			}
+		}
+		if (misses == 3 || t == 0) clusters.push_back(t);
+	}
+	if (clusters.size() < 2) return;
+	clusters.push_back(triangleCount);
+
+	// Centro y normal de cada grupo ponderados por el área de sus triángulos
+	glm::vec3 meshCenter(0.0f);
+	float meshArea = 0.0f;
+	std::vector<glm::vec3> centers(clusters.size() - 1);
+	std::vector<glm::vec3> normals(clusters.size() - 1);
+	for (size_t c = 0; c + 1 < clusters.size(); c++)
+	{
+		glm::vec3 center(0.0f);
+		glm::vec3 normal(0.0f);
+		float area = 0.0f;
+		for (uint32_t t = clusters[c]; t < clusters[c + 1]; t++)
+		{
+			const glm::vec3& p0 = vertices[indices[t * 3]].pos;
+			const glm::vec3& p1 = vertices[indices[t * 3 + 1]].pos;
+			const glm::vec3& p2 = vertices[indices[t * 3 + 2]].pos;
+			glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+			float a = glm::length(n);
+			center += (p0 + p1 + p2) * (a / 3.0f);
+			normal += n;
+			area += a;
+		}
+		meshCenter += center;
+		meshArea += area;
+		centers[c] = (area > 0.0f) ? center / area : glm::vec3(0.0f);
+		float length = glm::length(normal);
+		normals[c] = (length > 0.0f) ? normal / length : glm::vec3(0.0f);
+	}
+	if (meshArea > 0.0f) meshCenter /= meshArea;
+
+	// Primero los grupos más alejados del centro en la dirección de su normal
+	std::vector<float> keys(clusters.size() - 1);
+	std::vector<uint32_t> order(clusters.size() - 1);
+	for (size_t c = 0; c < order.size(); c++)
+	{
+		keys[c] = glm::dot(centers[c] - meshCenter, normals[c]);
+		order[c] = (uint32_t)c;
+	}
+	std::stable_sort(order.begin(), order.end(), [&keys](uint32_t a, uint32_t b) { return keys[a] > keys[b]; });
+
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+	for (uint32_t c : order)
+	{
+		result.insert(result.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+	}
+	indices.swap(result);
+}
+
+/**
+ * @brief Reordena los vértices en el orden en que los usan los índices.
+ * @param vertices Lista de vértices.
+ * @param indices Lista de índices.
+ */
+void optimizeVertexFetch(std::vector<GEVertex>& vertices, std::vector<uint32_t>& indices)
+{
+	std::vector<uint32_t> remap(vertices.size(), UINT32_MAX);
+	std::vector<GEVertex> sorted;
+	sorted.reserve(vertices.size());
+	for (uint32_t& i : indices)
+	{
+		if (remap[i] == UINT32_MAX)
+		{
+			remap[i] = (uint32_t)sorted.size();
+			sorted.push_back(vertices[i]);
+		}
+		i = remap[i];
+	}
+	vertices.swap(sorted);
+}
+
+/**
+ * @brief Aplica todas las optimizaciones a una malla.
+ * @param vertices Lista de vértices.
+ * @param indices Lista de índices.
+ * @return ACMR antes y después de optimizar.
+ */
+GEVertexCacheStats optimizeMesh(std::vector<GEVertex>& vertices, std::vector<uint32_t>& indices)
+{
+	GEVertexCacheStats stats;
+	stats.triangleCount = (uint32_t)(indices.size() / 3);
+	stats.acmrBefore = computeACMR(indices, (uint32_t)vertices.size());
+
+	optimizeVertexCache(indices, (uint32_t)vertices.size());
+	optimizeOverdraw(vertices, indices);
+	optimizeVertexFetch(vertices, indices);
+
+	stats.acmrAfter = computeACMR(indices, (uint32_t)vertices.size());
+	return stats;
+}
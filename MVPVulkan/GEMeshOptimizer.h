@@ -0,0 +1,74 @@
+/**
+ * @file GEMeshOptimizer.h
+ * @brief Declaración de las funciones que reordenan los triángulos y vértices de una malla.
+ */
+
+#pragma once
+
+#include "GEVertex.h"
+#include <vector>
+#include <stdint.h>
+
+const uint32_t VERTEX_CACHE_SIZE = 16; ///< Entradas de la caché FIFO simulada para medir el ACMR.
+const uint32_t FORSYTH_CACHE_SIZE = 32; ///< Entradas de la caché LRU que usa el algoritmo de Forsyth para puntuar vértices.
+
+/**
+ * @struct GEVertexCacheStats
+ * @brief Resultado de la optimización de una o varias mallas.
+ */
+typedef struct
+{
+	uint32_t triangleCount; ///< Número de triángulos.
+	float acmrBefore;       ///< Vértices transformados por triángulo con el orden original.
+	float acmrAfter;        ///< Vértices transformados por triángulo con el orden optimizado.
+} GEVertexCacheStats;
+
+/**
+ * @brief Calcula el ACMR (average cache miss ratio) de una lista de índices.
+ *
+ * Simula una caché FIFO de VERTEX_CACHE_SIZE vértices. El mínimo teórico es 0.5
+ * en mallas grandes y el peor caso es 3.
+ * @param indices Lista de índices.
+ * @param vertexCount Número de vértices.
+ * @return Fallos de caché por triángulo.
+ */
+float computeACMR(const std::vector<uint32_t>& indices, uint32_t vertexCount);
+
+/**
+ * @brief Reordena los triángulos para aprovechar la caché de vértices transformados.
+ *
+ * Algoritmo de Tom Forsyth: en cada paso se emite el triángulo con mayor
+ * puntuación, que premia los vértices que están en la caché y los que tienen
+ * pocos triángulos pendientes.
+ * @param indices Lista de índices (se reordena).
+ * @param vertexCount Número de vértices.
+ */
+void optimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount);
+
+/**
+ * @brief Reordena grupos de triángulos para reducir el overdraw.
+ *
+ * La lista se corta donde un triángulo no reutiliza ningún vértice de la caché, así
+ * que el orden dentro de cada grupo se conserva. Los grupos se ordenan para dibujar
+ * primero los que miran hacia fuera de la malla, que suelen tapar a los demás.
+ * @param vertices Lista de vértices.
+ * @param indices Lista de índices ya optimizada para la caché (se reordena).
+ */
+void optimizeOverdraw(const std::vector<GEVertex>& vertices, std::vector<uint32_t>& indices);
+
+/**
+ * @brief Reordena los vértices en el orden en que los usan los índices.
+ *
+ * Los vértices que no usa ningún triángulo se eliminan.
+ * @param vertices Lista de vértices (se reordena).
+ * @param indices Lista de índices (se actualiza).
+ */
+void optimizeVertexFetch(std::vector<GEVertex>& vertices, std::vector<uint32_t>& indices);
+
+/**
+ * @brief Aplica todas las optimizaciones a una malla.
+ * @param vertices Lista de vértices (se reordena).
+ * @param indices Lista de índices (se reordena).
+ * @return ACMR antes y después de optimizar.
+ */
+GEVertexCacheStats optimizeMesh(std::vector<GEVertex>& vertices, std::vector<uint32_t>& indices);
@@ -0,0 +1,415 @@
+/**
+ * @file GEOffscreenContext.cpp
+ * @brief Implementación de la clase GEOffscreenContext.
+ */
+
+#include "GEOffscreenContext.h"
+
+#include <fstream>
+#include <stdexcept>
+#include <string.h>
+
+const VkFormat OFFSCREEN_FORMAT = VK_FORMAT_R8G8B8A8_SRGB; ///< Formato de las imágenes (RGBA de 8 bits, como se guardan en el PPM).
+
+///////////////////////////////////////////////////////////////////////////////////////////
+/////                                                                                 /////
+/////                               Métodos públicos                                  /////
+/////                                                                                 /////
+///////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Crea el contexto de dibujo sin ventana.
+ * @param gc Contexto gráfico.
+ * @param width Ancho de las imágenes.
+ * @param height Alto de las imágenes.
+ * @param frameCount Número de frames en vuelo (y de imágenes).
+ */
+GEOffscreenContext::GEOffscreenContext(GEGraphicsContext* gc, uint32_t width, uint32_t height, uint32_t frameCount)
+{
+	this->frameCount = frameCount > 0 ? frameCount : 1;
+	this->imageCount = this->frameCount;
+	this->imageFormat = OFFSCREEN_FORMAT;
+	this->lastImage = UINT32_MAX;
+
+	VkCommandPoolCreateInfo poolInfo = {};
+	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	poolInfo.queueFamilyIndex = gc->graphicsQueueFamilyIndex;
+
+	if (vkCreateCommandPool(gc->device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create offscreen command pool!");
+	}
+
+	vkGetDeviceQueue(gc->device, gc->graphicsQueueFamilyIndex, 0, &graphicsQueue);
+	createSyncObjects(gc->device);
+	createImages(gc, width, height);
+}
+
+/**
+ * @brief Destruye las imágenes, los buffers de lectura y la sincronización.
+ * @param gc Contexto gráfico.
+ */
+void GEOffscreenContext::destroy(GEGraphicsContext* gc)
+{
+	destroyImages(gc);
+	for (VkFence fence : inFlightFences)
+	{
+		vkDestroyFence(gc->device, fence, nullptr);
+	}
+	inFlightFences.clear();
+	vkDestroyCommandPool(gc->device, commandPool, nullptr);
+}
+
+/**
+ * @brief Cambia el tamaño de las imágenes.
+ * @param gc Contexto gráfico.
+ * @param wpos Nuevo tamaño.
+ */
+void GEOffscreenContext::recreate(GEGraphicsContext* gc, GEWindowPosition wpos)
+{
+	vkDeviceWaitIdle(gc->device);
+	destroyImages(gc);
+	createImages(gc, wpos.width, wpos.height);
+	lastImage = UINT32_MAX;
+}
+
+/**
+ * @brief Layout en el que el render pass deja las imágenes.
+ * @return VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL.
+ */
+VkImageLayout GEOffscreenContext::getFinalLayout()
+{
+	return VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+}
+
+/**
+ * @brief Espera a que terminen los comandos del frame actual y toma su imagen.
+ * @param gc Contexto gráfico.
+ */
+void GEOffscreenContext::waitForNextImage(GEGraphicsContext* gc)
+{
+	// La imagen del frame solo la usan sus propios comandos: basta con su fence
+	vkWaitForFences(gc->device, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
+	currentImage = currentFrame;
+}
+
+/**
+ * @brief Envía los comandos gráficos del frame actual seguidos de la copia al buffer de lectura.
+ * @param gc Contexto gráfico.
+ * @param commandBuffers Vector con los command buffers (uno por frame).
+ */
+void GEOffscreenContext::submitGraphicsCommands(GEGraphicsContext* gc, std::vector<VkCommandBuffer> commandBuffers)
+{
+	VkCommandBuffer buffers[] = { commandBuffers[currentFrame], copyCommandBuffers[currentImage] };
+
+	VkSubmitInfo submitInfo = {};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount = 2;
+	submitInfo.pCommandBuffers = buffers;
+
+	vkResetFences(gc->device, 1, &inFlightFences[currentFrame]);
+
+	if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, inFlightFences[currentFrame]) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to submit offscreen command buffer!");
+	}
+}
+
+/**
+ * @brief Avanza al siguiente frame (no usa el contexto gráfico).
+ */
+void GEOffscreenContext::submitPresentCommands(GEGraphicsContext*)
+{
+	lastImage = currentImage;
+	currentFrame = (currentFrame + 1) % frameCount;
+}
+
+/**
+ * @brief Lee la última imagen enviada.
+ * @param gc Contexto gráfico.
+ * @param pixels Píxeles de la imagen en RGBA (salida).
+ * @return false si todavía no se ha enviado ninguna imagen.
+ */
+bool GEOffscreenContext::readImage(GEGraphicsContext* gc, std::vector<uint8_t>& pixels)
+{
+	if (lastImage == UINT32_MAX) return false;
+
+	// Imagen y frame tienen el mismo índice
+	vkWaitForFences(gc->device, 1, &inFlightFences[lastImage], VK_TRUE, UINT64_MAX);
+
+	const GEAllocation& allocation = readbackAllocations[lastImage];
+	VkDeviceSize size = (VkDeviceSize)imageExtent.width * imageExtent.height * 4;
+	if (!allocation.coherent)
+	{
+		gc->invalidateMappedMemory(allocation.memory, allocation.blockSize, allocation.offset, size);
+	}
+
+	pixels.resize((size_t)size);
+	memcpy(pixels.data(), allocation.mapped, (size_t)size);
+	return true;
+}
+
+/**
+ * @brief Guarda la última imagen enviada en un fichero PPM.
+ * @param gc Contexto gráfico.
+ * @param filename Ruta del fichero.
+ * @return false si no hay imagen o no se puede escribir el fichero.
+ */
+bool GEOffscreenContext::saveImage(GEGraphicsContext* gc, const std::string& filename)
+{
+	std::vector<uint8_t> pixels;
+	if (!readImage(gc, pixels)) return false;
+
+	std::ofstream out(filename, std::ios::binary);
+	if (!out) return false;
+
+	out << "P6\n" << imageExtent.width << " " << imageExtent.height << "\n255\n";
+	size_t pixelCount = (size_t)imageExtent.width * imageExtent.height;
+	std::vector<uint8_t> rgb(pixelCount * 3);
+	for (size_t i = 0; i < pixelCount; i++)
+	{
+		rgb[i * 3 + 0] = pixels[i * 4 + 0];
+		rgb[i * 3 + 1] = pixels[i * 4 + 1];
+		rgb[i * 3 + 2] = pixels[i * 4 + 2];
+	}
+	out.write((const char*)rgb.data(), rgb.size());
+	return out.good();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+/////                                                                                 /////
+/////                    Métodos de creación de los componentes                       /////
+/////                                                                                 /////
+///////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Crea las imágenes de color con sus vistas, buffers de lectura y copias.
+ * @param gc Contexto gráfico.
+ * @param width Ancho de las imágenes.
+ * @param height Alto de las imágenes.
+ */
+void GEOffscreenContext::createImages(GEGraphicsContext* gc, uint32_t width, uint32_t height)
+{
+	imageExtent.width = width > 0 ? width : 1;
+	imageExtent.height = height > 0 ? height : 1;
+	images.resize(imageCount);
+	imageAllocations.resize(imageCount);
+
+	for (uint32_t i = 0; i < imageCount; i++)
+	{
+		VkImageCreateInfo imageInfo = {};
+		imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageInfo.extent.width = imageExtent.width;
+		imageInfo.extent.height = imageExtent.height;
+		imageInfo.extent.depth = 1;
+		imageInfo.mipLevels = 1;
+		imageInfo.arrayLayers = 1;
+		imageInfo.format = imageFormat;
+		imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+		imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		if (vkCreateImage(gc->device, &imageInfo, nullptr, &images[i]) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to create offscreen image!");
+		}
+
+		VkMemoryRequirements memRequirements;
+		vkGetImageMemoryRequirements(gc->device, images[i], &memRequirements);
+
+		// Imagen con tiling óptimo: recurso no lineal para el asignador
+		uint32_t memoryType = gc->findMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+		imageAllocations[i] = gc->allocator->allocate(memRequirements, memoryType, false);
+
+		vkBindImageMemory(gc->device, images[i], imageAllocations[i].memory, imageAllocations[i].offset);
+	}
+
+	createImageViews(gc->device);
+	createReadbackBuffers(gc);
+	createCopyCommands(gc);
+}
+
+/**
+ * @brief Destruye las imágenes, sus vistas, los buffers de lectura y las copias.
+ * @param gc Contexto gráfico.
+ */
+void GEOffscreenContext::destroyImages(GEGraphicsContext* gc)
+{
+	if (!copyCommandBuffers.empty())
+	{
+		vkFreeCommandBuffers(gc->device, commandPool, (uint32_t)copyCommandBuffers.size(), copyCommandBuffers.data());
+		copyCommandBuffers.clear();
+	}
+
+	for (uint32_t i = 0; i < imageViews.size(); i++)
+	{
+		vkDestroyImageView(gc->device, imageViews[i], nullptr);
+	}
+	imageViews.clear();
+
+	for (uint32_t i = 0; i < images.size(); i++)
+	{
+		vkDestroyImage(gc->device, images[i], nullptr);
+		gc->allocator->free(imageAllocations[i]);
+	}
+	images.clear();
+	imageAllocations.clear();
+
+	for (uint32_t i = 0; i < readbackBuffers.size(); i++)
+	{
+		vkDestroyBuffer(gc->device, readbackBuffers[i], nullptr);
+		gc->allocator->free(readbackAllocations[i]);
+	}
+	readbackBuffers.clear();
+	readbackAllocations.clear();
+}
+
+/**
+ * @brief Crea una vista para cada imagen de color.
+ * @param device Dispositivo Vulkan.
+ */
+void GEOffscreenContext::createImageViews(VkDevice device)
+{
+	imageViews.resize(imageCount);
+
+	for (uint32_t i = 0; i < imageCount; i++)
+	{
+		VkImageViewCreateInfo viewInfo = {};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.image = images[i];
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format = imageFormat;
+		viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		viewInfo.subresourceRange.baseMipLevel = 0;
+		viewInfo.subresourceRange.levelCount = 1;
+		viewInfo.subresourceRange.baseArrayLayer = 0;
+		viewInfo.subresourceRange.layerCount = 1;
+
+		if (vkCreateImageView(device, &viewInfo, nullptr, &imageViews[i]) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to create offscreen image view!");
+		}
+	}
+}
+
+/**
+ * @brief Crea los buffers de lectura, mapeados en memoria visible desde la CPU.
+ * @param gc Contexto gráfico.
+ */
+void GEOffscreenContext::createReadbackBuffers(GEGraphicsContext* gc)
+{
+	readbackBuffers.resize(imageCount);
+	readbackAllocations.resize(imageCount);
+
+	VkBufferCreateInfo bufferInfo = {};
+	bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferInfo.size = (VkDeviceSize)imageExtent.width * imageExtent.height * 4;
+	bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+	bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	for (uint32_t i = 0; i < imageCount; i++)
+	{
+		if (vkCreateBuffer(gc->device, &bufferInfo, nullptr, &readbackBuffers[i]) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to create readback buffer!");
+		}
+
+		VkMemoryRequirements memRequirements;
+		vkGetBufferMemoryRequirements(gc->device, readbackBuffers[i], &memRequirements);
+
+		bool coherent;
+		uint32_t memoryType = gc->findHostMemoryType(memRequirements.memoryTypeBits, &coherent);
+		readbackAllocations[i] = gc->allocator->allocate(memRequirements, memoryType, true);
+		vkBindBufferMemory(gc->device, readbackBuffers[i], readbackAllocations[i].memory, readbackAllocations[i].offset);
+	}
+}
+
+/**
+ * @brief Graba, una sola vez, la copia de cada imagen a su buffer de lectura.
+ *
+ * El render pass deja la imagen en TRANSFER_SRC_OPTIMAL y su dependencia externa
+ * ordena la copia tras la escritura del color. La barrera final hace visibles los
+ * datos a la CPU cuando se señala la fence.
+ * @param gc Contexto gráfico.
+ */
+void GEOffscreenContext::createCopyCommands(GEGraphicsContext* gc)
+{
+	copyCommandBuffers.resize(imageCount);
+
+	VkCommandBufferAllocateInfo allocInfo = {};
+	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocInfo.commandPool = commandPool;
+	allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocInfo.commandBufferCount = imageCount;
+
+	if (vkAllocateCommandBuffers(gc->device, &allocInfo, copyCommandBuffers.data()) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to allocate readback command buffers!");
+	}
+
+	for (uint32_t i = 0; i < imageCount; i++)
+	{
+		VkCommandBufferBeginInfo beginInfo = {};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+
+		if (vkBeginCommandBuffer(copyCommandBuffers[i], &beginInfo) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to begin recording readback command buffer!");
+		}
+
+		VkBufferImageCopy region = {};
+		region.bufferOffset = 0;
+		region.bufferRowLength = 0;
+		region.bufferImageHeight = 0;
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.mipLevel = 0;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount = 1;
+		region.imageOffset = { 0, 0, 0 };
+		region.imageExtent = { imageExtent.width, imageExtent.height, 1 };
+
+		vkCmdCopyImageToBuffer(copyCommandBuffers[i], images[i], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readbackBuffers[i], 1, &region);
+
+		VkBufferMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.buffer = readbackBuffers[i];
+		barrier.offset = 0;
+		barrier.size = VK_WHOLE_SIZE;
+
+		vkCmdPipelineBarrier(copyCommandBuffers[i], VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0,
+			0, nullptr, 1, &barrier, 0, nullptr);
+
+		if (vkEndCommandBuffer(copyCommandBuffers[i]) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to record readback command buffer!");
+		}
+	}
+}
+
+/**
+ * @brief Crea las fences de cada frame.
+ * @param device Dispositivo Vulkan.
+ */
+void GEOffscreenContext::createSyncObjects(VkDevice device)
+{
+	inFlightFences.resize(frameCount);
+
+	VkFenceCreateInfo fenceInfo = {};
+	fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+	fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+	for (uint32_t i = 0; i < frameCount; i++)
+	{
+		if (vkCreateFence(device, &fenceInfo, nullptr, &inFlightFences[i]) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to create synchronization objects for a frame!");
+		}
+	}
+}
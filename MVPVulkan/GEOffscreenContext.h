@@ -0,0 +1,110 @@
+/**
+ * @file GEOffscreenContext.h
+ * @brief Declaración de la clase GEOffscreenContext que dibuja en imágenes propias sin ventana.
+ */
+
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <string>
+#include "GEGraphicsContext.h"
+#include "GEDrawingContext.h"
+#include "GEWindowPosition.h"
+
+/**
+ * @class GEOffscreenContext
+ * @brief Contexto de dibujo sin superficie ni swapchain, para servidores sin pantalla.
+ *
+ * Cada frame en vuelo tiene su propia imagen de color, así que la imagen actual es
+ * siempre la del frame. Al enviar los comandos gráficos se añade un command buffer
+ * que copia la imagen a un buffer visible desde la CPU; la "presentación" solo
+ * avanza de frame. Mantiene la interfaz de GEDrawingContext, de modo que la escena
+ * se dibuja igual que en una ventana (p. ej. con lavapipe en CI).
+ */
+class GEOffscreenContext : public GEDrawingContext
+{
+private:
+	std::vector<GEAllocation> imageAllocations;    ///< Memoria de las imágenes de color.
+	std::vector<VkBuffer> readbackBuffers;         ///< Buffers de lectura (uno por imagen).
+	std::vector<GEAllocation> readbackAllocations; ///< Memoria mapeada de los buffers de lectura.
+	VkCommandPool commandPool;                     ///< Pool de los command buffers de copia.
+	std::vector<VkCommandBuffer> copyCommandBuffers; ///< Copia de cada imagen a su buffer de lectura.
+	uint32_t lastImage;                            ///< Última imagen enviada (UINT32_MAX si todavía no hay ninguna).
+
+public:
+	/**
+	 * @brief Crea el contexto de dibujo sin ventana.
+	 * @param gc Contexto gráfico (puede no tener superficie).
+	 * @param width Ancho de las imágenes.
+	 * @param height Alto de las imágenes.
+	 * @param frameCount Número de frames en vuelo (y de imágenes).
+	 */
+	GEOffscreenContext(GEGraphicsContext* gc, uint32_t width, uint32_t height, uint32_t frameCount = FRAMES_IN_FLIGHT);
+
+	/**
+	 * @brief Destruye las imágenes, los buffers de lectura y la sincronización.
+	 * @param gc Contexto gráfico.
+	 */
+	void destroy(GEGraphicsContext* gc) override;
+
+	/**
+	 * @brief Cambia el tamaño de las imágenes.
+	 * @param gc Contexto gráfico.
+	 * @param wpos Nuevo tamaño (se usan width y height).
+	 */
+	void recreate(GEGraphicsContext* gc, GEWindowPosition wpos) override;
+
+	/**
+	 * @brief Layout en el que el render pass deja las imágenes.
+	 * @return VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL (la imagen se copia al buffer de lectura).
+	 */
+	VkImageLayout getFinalLayout() override;
+
+	/**
+	 * @brief Espera a que terminen los comandos del frame actual y toma su imagen.
+	 * @param gc Contexto gráfico.
+	 */
+	void waitForNextImage(GEGraphicsContext* gc) override;
+
+	/**
+	 * @brief Envía los comandos gráficos del frame actual seguidos de la copia al buffer de lectura.
+	 * @param gc Contexto gráfico.
+	 * @param commandBuffers Vector con los command buffers (uno por frame).
+	 */
+	void submitGraphicsCommands(GEGraphicsContext* gc, std::vector<VkCommandBuffer> commandBuffers) override;
+
+	/**
+	 * @brief Avanza al siguiente frame (no hay nada que presentar).
+	 * @param gc Contexto gráfico.
+	 */
+	void submitPresentCommands(GEGraphicsContext* gc) override;
+
+	/**
+	 * @brief Lee la última imagen enviada.
+	 *
+	 * Espera a la fence de su frame. Los píxeles están en RGBA de 8 bits (sRGB),
+	 * fila a fila sin relleno.
+	 * @param gc Contexto gráfico.
+	 * @param pixels Píxeles de la imagen (salida, ancho * alto * 4 bytes).
+	 * @return false si todavía no se ha enviado ninguna imagen.
+	 */
+	bool readImage(GEGraphicsContext* gc, std::vector<uint8_t>& pixels);
+
+	/**
+	 * @brief Guarda la última imagen enviada en un fichero PPM.
+	 * @param gc Contexto gráfico.
+	 * @param filename Ruta del fichero.
+	 * @return false si no hay imagen o no se puede escribir el fichero.
+	 */
+	bool saveImage(GEGraphicsContext* gc, const std::string& filename);
+
+private:
+	// ===== Métodos de creación de componentes =====
+	void createImages(GEGraphicsContext* gc, uint32_t width, uint32_t height);
+	void destroyImages(GEGraphicsContext* gc);
+	void createImageViews(VkDevice device);
+	void createReadbackBuffers(GEGraphicsContext* gc);
+	void createCopyCommands(GEGraphicsContext* gc);
+	void createSyncObjects(VkDevice device);
+};
@@ -0,0 +1,109 @@
+/**
+ * @file GEOverdrawQuery.cpp
+ * @brief Implementación de la clase GEOverdrawQuery.
+ */
+
+#include "GEOverdrawQuery.h"
+
+#include <stdexcept>
+
+/**
+ * @brief Crea el pool de consultas.
+ * @param gc Contexto gráfico.
+ * @param frameCount Número de frames en vuelo.
+ */
+GEOverdrawQuery::GEOverdrawQuery(GEGraphicsContext* gc, uint32_t frameCount)
+{
+	submitted.assign(frameCount, false);
+
+	VkQueryPoolCreateInfo poolInfo = {};
+	poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	poolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+	poolInfo.queryCount = frameCount;
+	poolInfo.pipelineStatistics = getStatistics();
+
+	if (vkCreateQueryPool(gc->device, &poolInfo, nullptr, &queryPool) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create overdraw query pool!");
+	}
+}
+
+/**
+ * @brief Indica si el dispositivo admite la medida.
+ * @param gc Contexto gráfico.
+ * @return true si están activas las características necesarias.
+ */
+bool GEOverdrawQuery::isSupported(GEGraphicsContext* gc)
+{
+	return gc->pipelineStatisticsQuery && gc->inheritedQueries;
+}
+
+/**
+ * @brief Estadísticas que recoge la consulta.
+ * @return Bits VK_QUERY_PIPELINE_STATISTIC_*.
+ */
+VkQueryPipelineStatisticFlags GEOverdrawQuery::getStatistics()
+{
+	return VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+}
+
+/**
+ * @brief Reinicia y empieza la consulta de un frame.
+ * @param commandBuffer Buffer de comandos primario.
+ * @param index Índice del frame.
+ */
+void GEOverdrawQuery::begin(VkCommandBuffer commandBuffer, uint32_t index)
+{
+	vkCmdResetQueryPool(commandBuffer, queryPool, index, 1);
+	vkCmdBeginQuery(commandBuffer, queryPool, index, 0);
+}
+
+/**
+ * @brief Termina la consulta de un frame.
+ * @param commandBuffer Buffer de comandos primario.
+ * @param index Índice del frame.
+ */
+void GEOverdrawQuery::end(VkCommandBuffer commandBuffer, uint32_t index)
+{
+	vkCmdEndQuery(commandBuffer, queryPool, index);
+}
+
+/**
+ * @brief Indica que el command buffer de un frame se va a enviar a la GPU.
+ * @param index Índice del frame.
+ */
+void GEOverdrawQuery::markSubmitted(uint32_t index)
+{
+	if (index < submitted.size()) submitted[index] = true;
+}
+
+/**
+ * @brief Obtiene el overdraw de la última ejecución del command buffer de un frame.
+ * @param gc Contexto gráfico.
+ * @param index Índice del frame.
+ * @param extent Extensión de la imagen.
+ * @param overdraw Fragmentos sombreados por píxel.
+ * @return false si la consulta todavía no tiene resultado.
+ */
+bool GEOverdrawQuery::getOverdraw(GEGraphicsContext* gc, uint32_t index, VkExtent2D extent, double* overdraw)
+{
+	if (index >= submitted.size() || !submitted[index]) return false;
+
+	uint64_t invocations = 0;
+	VkResult result = vkGetQueryPoolResults(gc->device, queryPool, index, 1, sizeof(invocations), &invocations,
+		sizeof(invocations), VK_QUERY_RESULT_64_BIT);
+	if (result != VK_SUCCESS) return false;
+
+	double pixels = (double)extent.width * (double)extent.height;
+	*overdraw = pixels > 0.0 ? (double)invocations / pixels : 0.0;
+	return true;
+}
+
+/**
+ * @brief Destruye el pool de consultas.
+ * @param gc Contexto gráfico.
+ */
+void GEOverdrawQuery::destroy(GEGraphicsContext* gc)
+{
+	vkDestroyQueryPool(gc->device, queryPool, nullptr);
+}
@@ -0,0 +1,95 @@
+/**
+ * @file GEOverdrawQuery.h
+ * @brief Declaración de la clase GEOverdrawQuery que mide el overdraw de cada frame.
+ */
+
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include "GEGraphicsContext.h"
+#include <vector>
+#include <stdint.h>
+
+/**
+ * @class GEOverdrawQuery
+ * @brief Cuenta los fragmentos sombreados en el render pass de cada frame.
+ *
+ * Usa una consulta de estadísticas del pipeline (invocaciones del fragment shader)
+ * por frame que abarca todo el render pass. Dividida entre los píxeles de la
+ * imagen da el overdraw: 1 significa que cada píxel se sombrea una sola vez. Los
+ * fragmentos descartados por el test de profundidad temprano no cuentan, así que
+ * la medida refleja el efecto de ordenar de delante hacia atrás y de la pasada
+ * previa de profundidad.
+ *
+ * Necesita las características pipelineStatisticsQuery e inheritedQueries (la
+ * consulta sigue activa mientras se ejecutan los buffers secundarios).
+ */
+class GEOverdrawQuery
+{
+public:
+	VkQueryPool queryPool; ///< Una consulta por frame en vuelo.
+
+private:
+	std::vector<bool> submitted; ///< Frames cuya consulta se ha enviado a la GPU al menos una vez.
+
+public:
+	/**
+	 * @brief Crea el pool de consultas.
+	 * @param gc Contexto gráfico.
+	 * @param frameCount Número de frames en vuelo.
+	 */
+	GEOverdrawQuery(GEGraphicsContext* gc, uint32_t frameCount);
+
+	/**
+	 * @brief Indica si el dispositivo admite la medida.
+	 * @param gc Contexto gráfico.
+	 * @return true si están activas las características necesarias.
+	 */
+	static bool isSupported(GEGraphicsContext* gc);
+
+	/**
+	 * @brief Estadísticas que recoge la consulta (las deben heredar los buffers secundarios).
+	 * @return Bits VK_QUERY_PIPELINE_STATISTIC_*.
+	 */
+	static VkQueryPipelineStatisticFlags getStatistics();
+
+	/**
+	 * @brief Reinicia y empieza la consulta de un frame (fuera del render pass).
+	 * @param commandBuffer Buffer de comandos primario.
+	 * @param index Índice del frame.
+	 */
+	void begin(VkCommandBuffer commandBuffer, uint32_t index);
+
+	/**
+	 * @brief Termina la consulta de un frame (fuera del render pass).
+	 * @param commandBuffer Buffer de comandos primario.
+	 * @param index Índice del frame.
+	 */
+	void end(VkCommandBuffer commandBuffer, uint32_t index);
+
+	/**
+	 * @brief Indica que el command buffer de un frame se va a enviar a la GPU.
+	 *
+	 * Hasta entonces la consulta del frame no se ha reiniciado y no tiene resultado.
+	 * @param index Índice del frame.
+	 */
+	void markSubmitted(uint32_t index);
+
+	/**
+	 * @brief Obtiene el overdraw de la última ejecución del command buffer de un frame.
+	 *
+	 * No espera a la GPU: hay que llamarla después de esperar a la fence del frame.
+	 * @param gc Contexto gráfico.
+	 * @param index Índice del frame.
+	 * @param extent Extensión de la imagen.
+	 * @param overdraw Fragmentos sombreados por píxel (salida).
+	 * @return false si la consulta todavía no tiene resultado.
+	 */
+	bool getOverdraw(GEGraphicsContext* gc, uint32_t index, VkExtent2D extent, double* overdraw);
+
+	/**
+	 * @brief Destruye el pool de consultas.
+	 * @param gc Contexto gráfico.
+	 */
+	void destroy(GEGraphicsContext* gc);
+};
@@ -0,0 +1,190 @@
+/**
+ * @file GEPipelineCache.cpp
+ * @brief Implementación de la clase GEPipelineCache.
+ */
+
+#include "GEPipelineCache.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <fstream>
+#include <vector>
+#include <cstring>
+#include <cstdio>
+#include <stdexcept>
+
+/**
+ * @brief Calcula el hash FNV-1a de 64 bits de un bloque de datos.
+ * @param data Datos.
+ * @param size Número de bytes.
+ * @return Hash.
+ */
+static uint64_t computeChecksum(const void* data, size_t size)
+{
+	const uint8_t* bytes = (const uint8_t*)data;
+	uint64_t hash = 0xcbf29ce484222325ull;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+	}
+	return hash;
+}
+
+/**
+ * @brief Crea la caché con el contenido del fichero, si es válido.
+ * @param device Dispositivo lógico.
+ * @param properties Propiedades del dispositivo físico.
+ * @param path Ruta del fichero de caché.
+ */
+GEPipelineCache::GEPipelineCache(VkDevice device, const VkPhysicalDeviceProperties& properties, const std::string& path)
+{
+	this->device = device;
+	this->properties = properties;
+	this->path = path;
+
+	std::string data;
+	bool valid = load(data);
+	loadedSize = valid ? data.size() : 0;
+	loadedChecksum = valid ? computeChecksum(data.data(), data.size()) : 0;
+
+	VkPipelineCacheCreateInfo cacheInfo = {};
+	cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	cacheInfo.initialDataSize = valid ? data.size() : 0;
+	cacheInfo.pInitialData = valid ? data.data() : nullptr;
+
+	// Si el driver rechaza los datos se empieza con la caché vacía
+	if (vkCreatePipelineCache(device, &cacheInfo, nullptr, &cache) != VK_SUCCESS)
+	{
+		loadedSize = 0;
+		loadedChecksum = 0;
+		cacheInfo.initialDataSize = 0;
+		cacheInfo.pInitialData = nullptr;
+		if (vkCreatePipelineCache(device, &cacheInfo, nullptr, &cache) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to create pipeline cache!");
+		}
+	}
+}
+
+/**
+ * @brief Escribe la caché en el fichero.
+ * @return true si el fichero queda actualizado.
+ */
+bool GEPipelineCache::save()
+{
+	size_t size = 0;
+	if (vkGetPipelineCacheData(device, cache, &size, nullptr) != VK_SUCCESS || size == 0) return false;
+
+	std::vector<char> data(size);
+	if (vkGetPipelineCacheData(device, cache, &size, data.data()) != VK_SUCCESS) return false;
+	data.resize(size);
+
+	uint64_t checksum = computeChecksum(data.data(), data.size());
+	if (size == loadedSize && checksum == loadedChecksum) return true;
+
+	GEPipelineCacheHeader header = {};
+	header.magic = PIPELINE_CACHE_MAGIC;
+	header.version = PIPELINE_CACHE_VERSION;
+	header.vendorID = properties.vendorID;
+	header.deviceID = properties.deviceID;
+	header.driverVersion = properties.driverVersion;
+	memcpy(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+	header.dataSize = size;
+	header.checksum = checksum;
+
+	// Escritura atómica: el fichero anterior solo se sustituye si el nuevo está completo
+	std::string tempPath = path + ".tmp";
+	{
+		std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+		out.write((const char*)&header, sizeof(header));
+		out.write(data.data(), data.size());
+		out.flush();
+		if (!out)
+		{
+			out.close();
+			std::remove(tempPath.c_str());
+			return false;
+		}
+	}
+
+#ifdef _WIN32
+	bool replaced = MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+	bool replaced = std::rename(tempPath.c_str(), path.c_str()) == 0;
+#endif
+	if (!replaced)
+	{
+		std::remove(tempPath.c_str());
+		return false;
+	}
+
+	loadedSize = size;
+	loadedChecksum = checksum;
+	return true;
+}
+
+/**
+ * @brief Indica si la caché se cargó del fichero.
+ * @return true si había una caché válida.
+ */
+bool GEPipelineCache::isWarm() const
+{
+	return loadedSize > 0;
+}
+
+/**
+ * @brief Obtiene el tamaño de los datos cargados del fichero.
+ * @return Número de bytes.
+ */
+uint64_t GEPipelineCache::getLoadedSize() const
+{
+	return loadedSize;
+}
+
+/**
+ * @brief Destruye la caché.
+ */
+void GEPipelineCache::destroy()
+{
+	vkDestroyPipelineCache(device, cache, nullptr);
+}
+
+/**
+ * @brief Lee el fichero y comprueba que corresponde a este dispositivo y driver.
+ * @param data Datos de la caché leídos.
+ * @return true si el fichero existe y es válido.
+ */
+bool GEPipelineCache::load(std::string& data)
+{
+	std::ifstream in(path, std::ios::binary | std::ios::ate);
+	if (!in) return false;
+
+	uint64_t fileSize = (uint64_t)in.tellg();
+	if (fileSize < sizeof(GEPipelineCacheHeader)) return false;
+
+	GEPipelineCacheHeader header;
+	in.seekg(0);
+	in.read((char*)&header, sizeof(header));
+
+	// Un driver nuevo invalida los shaders compilados aunque el dispositivo sea el mismo
+	bool valid = in && header.magic == PIPELINE_CACHE_MAGIC && header.version == PIPELINE_CACHE_VERSION
+		&& header.vendorID == properties.vendorID && header.deviceID == properties.deviceID
+		&& header.driverVersion == properties.driverVersion
+		&& memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0
+		&& header.dataSize == fileSize - sizeof(header)
+		&& header.dataSize >= sizeof(VkPipelineCacheHeaderVersionOne);
+	if (!valid) return false;
+
+	data.resize((size_t)header.dataSize);
+	in.read(&data[0], data.size());
+	if (!in || computeChecksum(data.data(), data.size()) != header.checksum) return false;
+
+	// La cabecera de Vulkan también debe ser de este dispositivo (algunos drivers no lo comprueban)
+	VkPipelineCacheHeaderVersionOne vulkanHeader;
+	memcpy(&vulkanHeader, data.data(), sizeof(vulkanHeader));
+	return vulkanHeader.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+		&& vulkanHeader.headerSize >= sizeof(vulkanHeader) && vulkanHeader.headerSize <= data.size()
+		&& vulkanHeader.vendorID == properties.vendorID && vulkanHeader.deviceID == properties.deviceID
+		&& memcmp(vulkanHeader.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
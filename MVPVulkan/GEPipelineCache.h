@@ -0,0 +1,99 @@
+/**
+ * @file GEPipelineCache.h
+ * @brief Declaración de la clase GEPipelineCache que guarda en disco la caché de pipelines.
+ */
+
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <string>
+#include <stdint.h>
+
+const uint32_t PIPELINE_CACHE_MAGIC = 0x43504547; ///< "GEPC" en little endian.
+const uint32_t PIPELINE_CACHE_VERSION = 1; ///< Versión del formato del fichero.
+
+/**
+ * @struct GEPipelineCacheHeader
+ * @brief Cabecera del fichero de caché, seguida de los datos de vkGetPipelineCacheData.
+ *
+ * Identifica el dispositivo y el driver que generaron los datos: si no coinciden
+ * con los actuales, la caché se descarta en lugar de pasarla al driver.
+ */
+struct GEPipelineCacheHeader
+{
+	uint32_t magic;                              ///< PIPELINE_CACHE_MAGIC.
+	uint32_t version;                            ///< PIPELINE_CACHE_VERSION.
+	uint32_t vendorID;                           ///< Fabricante del dispositivo.
+	uint32_t deviceID;                           ///< Modelo del dispositivo.
+	uint32_t driverVersion;                      ///< Versión del driver.
+	uint8_t pipelineCacheUUID[VK_UUID_SIZE];     ///< UUID de la caché del dispositivo.
+	uint32_t reserved;                           ///< Relleno (0).
+	uint64_t dataSize;                           ///< Bytes de datos tras la cabecera.
+	uint64_t checksum;                           ///< FNV-1a de los datos.
+};
+static_assert(sizeof(GEPipelineCacheHeader) == 56, "GEPipelineCacheHeader debe ocupar 56 bytes");
+
+/**
+ * @class GEPipelineCache
+ * @brief Caché de pipelines que se carga de un fichero al arrancar y se guarda al salir.
+ *
+ * Con la caché caliente el driver reutiliza los shaders ya compilados y la
+ * creación de pipelines pasa de compilar a solo buscar en la caché. Un fichero
+ * corrupto o de otro dispositivo/driver se ignora y se empieza con la caché vacía.
+ */
+class GEPipelineCache
+{
+public:
+	VkPipelineCache cache; ///< Caché que se pasa a vkCreateGraphicsPipelines.
+
+private:
+	VkDevice device;                        ///< Dispositivo lógico.
+	VkPhysicalDeviceProperties properties;  ///< Propiedades del dispositivo (identifican la caché).
+	std::string path;                       ///< Ruta del fichero.
+	uint64_t loadedSize;                    ///< Bytes cargados del fichero (0 si la caché empezó vacía).
+	uint64_t loadedChecksum;                ///< Checksum de los datos cargados.
+
+public:
+	/**
+	 * @brief Crea la caché con el contenido del fichero, si es válido.
+	 * @param device Dispositivo lógico.
+	 * @param properties Propiedades del dispositivo físico.
+	 * @param path Ruta del fichero de caché.
+	 */
+	GEPipelineCache(VkDevice device, const VkPhysicalDeviceProperties& properties, const std::string& path);
+
+	/**
+	 * @brief Escribe la caché en el fichero.
+	 *
+	 * Se escribe en un fichero temporal que después sustituye al anterior, de modo
+	 * que una interrupción no deja un fichero a medias. Si el contenido no ha
+	 * cambiado desde la carga no se escribe nada.
+	 * @return true si el fichero queda actualizado.
+	 */
+	bool save();
+
+	/**
+	 * @brief Indica si la caché se cargó del fichero.
+	 * @return true si había una caché válida.
+	 */
+	bool isWarm() const;
+
+	/**
+	 * @brief Obtiene el tamaño de los datos cargados del fichero.
+	 * @return Número de bytes (0 si la caché empezó vacía).
+	 */
+	uint64_t getLoadedSize() const;
+
+	/**
+	 * @brief Destruye la caché (sin guardarla).
+	 */
+	void destroy();
+
+private:
+	/**
+	 * @brief Lee el fichero y comprueba que corresponde a este dispositivo y driver.
+	 * @param data Datos de la caché leídos (salida).
+	 * @return true si el fichero existe y es válido.
+	 */
+	bool load(std::string& data);
+};
@@ -19,9 +19,24 @@ GEPipelineConfig::GEPipelineConfig()
 
 	descriptorTypes.resize(0);
 	descriptorStages.resize(0);
+	descriptorSets.resize(0);
+	pushConstantRanges.resize(0);
 
 	depthTestEnable = VK_TRUE;
+	depthWriteEnable = VK_TRUE;
+	colorWriteEnable = VK_TRUE;
 	cullMode = VK_CULL_MODE_BACK_BIT;
 	extent.width = 800;
 	extent.height = 600;
+}
+
+/**
+ * @brief Convierte la configuración en la de una pasada previa de profundidad.
+ */
+void GEPipelineConfig::setDepthOnly()
+{
+	fragment_shader = -1;
+	depthTestEnable = VK_TRUE;
+	depthWriteEnable = VK_TRUE;
+	colorWriteEnable = VK_FALSE;
 }
\ No newline at end of file
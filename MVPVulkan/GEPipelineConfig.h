@@ -14,8 +14,8 @@
  */
 class GEPipelineConfig {
 public:
-	int vertex_shader; ///< Identificador del recurso del shader de vértices.
-	int fragment_shader; ///< Identificador del recurso del shader de fragmento.
+	int vertex_shader; ///< Identificador del shader de vértices (SHADER_*).
+	int fragment_shader; ///< Identificador del shader de fragmento (SHADER_*; -1: sin etapa de fragmentos).
 
 	int attrStride; ///< Tamaño en bytes del stride de los atributos de vértice.
 	std::vector<VkFormat> attrFormats; ///< Formatos de los atributos de vértice.
@@ -23,8 +23,12 @@ public:
 
 	std::vector<VkDescriptorType> descriptorTypes; ///< Tipos de descriptores usados por el pipeline.
 	std::vector<VkShaderStageFlags> descriptorStages; ///< Etapas de shader para cada descriptor.
+	std::vector<uint32_t> descriptorSets; ///< Set de cada descriptor (vacío: todos en el set 0). Los bindings se numeran dentro de cada set.
+	std::vector<VkPushConstantRange> pushConstantRanges; ///< Rangos de push constants del pipeline.
 
 	VkBool32 depthTestEnable; ///< Habilita test de profundidad.
+	VkBool32 depthWriteEnable; ///< Escribe la profundidad de los fragmentos que pasan el test.
+	VkBool32 colorWriteEnable; ///< Escribe el color (VK_FALSE: pipeline solo de profundidad).
 	VkCullModeFlags cullMode; ///< Modo de culling.
 	VkExtent2D extent; ///< Extensión de la imagen (swapchain).
 
@@ -32,4 +36,12 @@ public:
 	 * @brief Construye un objeto con valores por defecto.
 	 */
 	GEPipelineConfig();
+
+	/**
+	 * @brief Convierte la configuración en la de una pasada previa de profundidad.
+	 *
+	 * Sin shader de fragmentos y sin escribir color: con los mismos shaders de
+	 * vértices y descriptores el layout es compatible con el del pipeline original.
+	 */
+	void setDepthOnly();
 };
\ No newline at end of file
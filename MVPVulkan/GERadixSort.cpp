@@ -0,0 +1,67 @@
+/**
+ * @file GERadixSort.cpp
+ * @brief Implementación de la ordenación por claves de 64 bits.
+ */
+
+#include "GERadixSort.h"
+
+#include <cstring>
+
+/**
+ * @brief Ordena los elementos por clave de menor a mayor.
+ * @param items Elementos a ordenar.
+ * @param scratch Buffer auxiliar.
+ */
+void radixSort(std::vector<GESortItem>& items, std::vector<GESortItem>& scratch)
+{
+	size_t count = items.size();
+	if (count < 2) return;
+	scratch.resize(count);
+
+	// Histogramas de los 8 dígitos en una sola lectura
+	uint32_t histograms[8][256];
+	memset(histograms, 0, sizeof(histograms));
+	for (const GESortItem& item : items)
+	{
+		for (int digit = 0; digit < 8; digit++)
+		{
+			histograms[digit][(item.key >> (digit * 8)) & 0xFF]++;
+		}
+	}
+
+	for (int digit = 0; digit < 8; digit++)
+	{
+		uint32_t* histogram = histograms[digit];
+		uint32_t shift = digit * 8;
+
+		// Si todas las claves comparten el dígito la pasada no cambia nada
+		if (histogram[(items[0].key >> shift) & 0xFF] == count) continue;
+
+		uint32_t offset = 0;
+		for (int bucket = 0; bucket < 256; bucket++)
+		{
+			uint32_t size = histogram[bucket];
+			histogram[bucket] = offset;
+			offset += size;
+		}
+		for (const GESortItem& item : items)
+		{
+			scratch[histogram[(item.key >> shift) & 0xFF]++] = item;
+		}
+		items.swap(scratch);
+	}
+}
+
+/**
+ * @brief Convierte una distancia en un entero que conserva su orden.
+ * @param depth Distancia a la cámara.
+ * @return Bits de la distancia.
+ */
+uint32_t sortableDepth(float depth)
+{
+	if (!(depth > 0.0f)) return 0;
+
+	uint32_t bits;
+	memcpy(&bits, &depth, sizeof(bits));
+	return bits;
+}
@@ -0,0 +1,42 @@
+/**
+ * @file GERadixSort.h
+ * @brief Ordenación por claves de 64 bits (radix sort) para las listas de draws e instancias.
+ */
+
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+
+/**
+ * @struct GESortItem
+ * @brief Clave de ordenación y posición del elemento al que representa.
+ *
+ * Se ordenan estos pares (16 bytes) en lugar de los elementos completos.
+ */
+typedef struct
+{
+	uint64_t key;   ///< Clave de ordenación.
+	uint32_t index; ///< Posición del elemento en su lista.
+} GESortItem;
+
+/**
+ * @brief Ordena los elementos por clave de menor a mayor.
+ *
+ * Radix sort LSD estable de 8 bits por pasada: el coste es lineal, así que sirve
+ * para ordenar cada frame listas de cientos de miles de elementos. Las pasadas en
+ * las que todas las claves tienen el mismo byte se saltan.
+ * @param items Elementos a ordenar.
+ * @param scratch Buffer auxiliar (se redimensiona; conviene reutilizarlo entre frames).
+ */
+void radixSort(std::vector<GESortItem>& items, std::vector<GESortItem>& scratch);
+
+/**
+ * @brief Convierte una distancia en un entero que conserva su orden.
+ *
+ * Los bits de un float positivo crecen con su valor, así que sirven de
+ * profundidad cuantizada sin fijar un rango. Las distancias negativas valen 0.
+ * @param depth Distancia a la cámara.
+ * @return Bits de la distancia (31 bits significativos).
+ */
+uint32_t sortableDepth(float depth);
@@ -0,0 +1,186 @@
+/**
+ * @file GERenderQueue.cpp
+ * @brief Implementación de la clase GERenderQueue.
+ */
+
+#include "GERenderQueue.h"
+
+#include <algorithm>
+
+/**
+ * @brief Crea la cola vacía.
+ * @param frontToBack Ordena primero por profundidad (true) o por estado (false).
+ */
+GERenderQueue::GERenderQueue(bool frontToBack)
+{
+	this->frontToBack = frontToBack;
+	depthPipeline = 0;
+	bindsIssued = 0;
+	bindsSkipped = 0;
+}
+
+/**
+ * @brief Calcula la clave de ordenación de un draw.
+ * @param pipeline Pipeline (8 bits).
+ * @param material Identificador del material (16 bits).
+ * @param mesh Identificador de los buffers de la malla (16 bits).
+ * @param depth Distancia a la cámara (positiva).
+ * @return Clave de 64 bits.
+ */
+uint64_t GERenderQueue::makeKey(uint32_t pipeline, uint32_t material, uint32_t mesh, float depth) const
+{
+	// Los 24 bits más altos de la distancia (el bit de signo siempre es 0)
+	uint64_t depthBits = sortableDepth(depth) >> (31 - SORT_KEY_DEPTH_BITS);
+	uint64_t state = ((uint64_t)(material & 0xFFFF) << 16) | (uint64_t)(mesh & 0xFFFF);
+	uint64_t key = (uint64_t)(pipeline & 0xFF) << SORT_KEY_PIPELINE_SHIFT;
+
+	if (frontToBack) return key | (depthBits << 32) | state;
+	return key | (state << SORT_KEY_DEPTH_BITS) | depthBits;
+}
+
+/**
+ * @brief Asigna el pipeline con el que se graban los draws en la pasada de profundidad.
+ * @param pipeline 0: pipeline principal; v + 1: variante v.
+ */
+void GERenderQueue::setDepthPipeline(uint32_t pipeline)
+{
+	depthPipeline = pipeline;
+}
+
+/**
+ * @brief Vacía la cola y reinicia las estadísticas.
+ */
+void GERenderQueue::clear()
+{
+	packets.clear();
+	order.clear();
+	bindsIssued = 0;
+	bindsSkipped = 0;
+}
+
+/**
+ * @brief Añade un draw a la cola.
+ * @param packet Draw a añadir.
+ */
+void GERenderQueue::submit(const GEDrawPacket& packet)
+{
+	GESortItem item;
+	item.key = packet.key;
+	item.index = (uint32_t)packets.size();
+	packets.push_back(packet);
+	order.push_back(item);
+}
+
+/**
+ * @brief Ordena los draws por clave.
+ */
+void GERenderQueue::sort()
+{
+	radixSort(order, scratch);
+}
+
+/**
+ * @brief Obtiene el número de draws de la cola.
+ * @return Número de draws.
+ */
+uint32_t GERenderQueue::getPacketCount() const
+{
+	return (uint32_t)packets.size();
+}
+
+/**
+ * @brief Graba un tramo de la cola ordenada.
+ * @param commandBuffer Buffer de comandos.
+ * @param rc Contexto de renderizado.
+ * @param first Primer draw del tramo.
+ * @param count Número de draws del tramo.
+ * @param depthOnly Graba los draws con el pipeline de la pasada de profundidad.
+ */
+void GERenderQueue::record(VkCommandBuffer commandBuffer, GERenderingContext* rc, uint32_t first, uint32_t count, bool depthOnly)
+{
+	// Estado enlazado en este buffer (los tramos de otros hilos no lo comparten)
+	uint32_t boundPipeline = UINT32_MAX;
+	const void* boundBuffers = nullptr;
+	uint32_t boundSetCount = 0;
+	VkDescriptorSet boundSets[2] = {};
+	uint32_t boundOffsets[2] = {};
+	uint32_t issued = 0;
+	uint32_t skipped = 0;
+
+	uint32_t last = std::min(first + count, (uint32_t)order.size());
+	for (uint32_t i = first; i < last; i++)
+	{
+		const GEDrawPacket& packet = packets[order[i].index];
+		uint32_t pipeline = depthOnly ? depthPipeline : packet.pipeline;
+		VkPipelineLayout layout = pipeline == 0 ? rc->pipelineLayout : rc->variantPipelineLayouts[pipeline - 1];
+
+		if (pipeline != boundPipeline)
+		{
+			if (pipeline == 0) rc->bindPipeline(commandBuffer);
+			else rc->bindPipelineVariant(commandBuffer, pipeline - 1);
+			boundPipeline = pipeline;
+			// Los sets por encima del 0 no son compatibles entre pipelines
+			boundSetCount = 0;
+			issued++;
+		}
+		else
+		{
+			skipped++;
+		}
+
+		if (packet.mesh->getBinding() != boundBuffers)
+		{
+			packet.mesh->bind(commandBuffer);
+			boundBuffers = packet.mesh->getBinding();
+			issued++;
+		}
+		else
+		{
+			skipped++;
+		}
+
+		bool sameSets = packet.setCount == boundSetCount;
+		for (uint32_t s = 0; sameSets && s < packet.setCount; s++)
+		{
+			sameSets = packet.sets[s] == boundSets[s] && packet.dynamicOffsets[s] == boundOffsets[s];
+		}
+		if (!sameSets)
+		{
+			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, packet.firstSet,
+				packet.setCount, packet.sets, packet.setCount, packet.dynamicOffsets);
+			boundSetCount = packet.setCount;
+			for (uint32_t s = 0; s < packet.setCount; s++)
+			{
+				boundSets[s] = packet.sets[s];
+				boundOffsets[s] = packet.dynamicOffsets[s];
+			}
+			issued++;
+		}
+		else
+		{
+			skipped++;
+		}
+
+		if (packet.pushTransform)
+		{
+			vkCmdPushConstants(commandBuffer, layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(GETransform), &packet.transform);
+		}
+		packet.mesh->draw(commandBuffer, 1, 0);
+	}
+
+	bindsIssued += issued;
+	bindsSkipped += skipped;
+}
+
+/**
+ * @brief Obtiene los binds grabados y evitados desde el último clear().
+ * @return Estadísticas de la cola.
+ */
+GERenderQueueStats GERenderQueue::getStats() const
+{
+	GERenderQueueStats stats;
+	stats.packets = (uint32_t)packets.size();
+	stats.bindsIssued = bindsIssued;
+	stats.bindsSkipped = bindsSkipped;
+	return stats;
+}
@@ -0,0 +1,143 @@
+/**
+ * @file GERenderQueue.h
+ * @brief Declaración de la clase GERenderQueue que ordena los draws del frame para reducir cambios de estado.
+ */
+
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include "GERenderingContext.h"
+#include "GEMesh.h"
+#include "GETransform.h"
+#include "GERadixSort.h"
+#include <vector>
+#include <atomic>
+#include <stdint.h>
+
+const uint32_t SORT_KEY_PIPELINE_SHIFT = 56; ///< Posición del pipeline en la clave (8 bits, los más significativos).
+const uint32_t SORT_KEY_DEPTH_BITS = 24;     ///< Bits de profundidad en la clave.
+
+/**
+ * @struct GEDrawPacket
+ * @brief Draw de una figura con todo el estado que necesita, listo para ordenar.
+ */
+struct GEDrawPacket
+{
+	uint64_t key;                   ///< Clave de ordenación (ver GERenderQueue::makeKey()).
+	uint32_t pipeline;              ///< 0: pipeline principal; v + 1: variante v.
+	GEMesh* mesh;                   ///< Malla a dibujar.
+	uint32_t firstSet;              ///< Índice del primer set (el del material).
+	uint32_t setCount;              ///< Número de sets (1 o 2).
+	VkDescriptorSet sets[2];        ///< Sets de material y objeto.
+	uint32_t dynamicOffsets[2];     ///< Offsets dinámicos de los sets.
+	bool pushTransform;             ///< La matriz Model se envía por push constants.
+	GETransform transform;          ///< Matriz Model (solo con pushTransform).
+};
+
+/**
+ * @struct GERenderQueueStats
+ * @brief Cambios de estado grabados y evitados en el último frame.
+ */
+typedef struct
+{
+	uint32_t packets;      ///< Draws de la cola.
+	uint32_t bindsIssued;  ///< Binds de pipeline, buffers y descriptor sets grabados.
+	uint32_t bindsSkipped; ///< Binds evitados porque el estado ya estaba enlazado.
+} GERenderQueueStats;
+
+/**
+ * @class GERenderQueue
+ * @brief Cola de draws que se ordena por clave cada frame antes de grabarla.
+ *
+ * Las figuras envían un GEDrawPacket por frame con una clave de 64 bits. Por
+ * estado la clave es pipeline, material, malla y profundidad (de más a menos
+ * significativo), así que tras ordenar los draws con el mismo estado quedan
+ * juntos. De delante hacia atrás es pipeline, profundidad, material y malla: los
+ * draws cercanos rellenan antes el buffer de profundidad y el test de profundidad
+ * temprano descarta los fragmentos tapados sin ejecutar el fragment shader. Al grabar se
+ * compara el estado de cada draw con el enlazado y solo se graban los binds que
+ * cambian. La clave solo decide el orden: un bind se evita únicamente si el
+ * pipeline, los buffers o los sets son realmente los mismos.
+ *
+ * La grabación puede repartirse entre varios hilos (un tramo por buffer
+ * secundario); cada tramo empieza sin estado enlazado.
+ */
+class GERenderQueue
+{
+private:
+	std::vector<GEDrawPacket> packets;      ///< Draws enviados en el frame.
+	std::vector<GESortItem> order;          ///< Draws en orden de grabación (clave e índice en packets).
+	std::vector<GESortItem> scratch;        ///< Buffer auxiliar de la ordenación.
+	bool frontToBack;                       ///< La profundidad va delante del material y la malla en la clave.
+	uint32_t depthPipeline;                 ///< Pipeline de la pasada de profundidad (0: sin pasada previa).
+	std::atomic<uint32_t> bindsIssued;      ///< Binds grabados desde clear().
+	std::atomic<uint32_t> bindsSkipped;     ///< Binds evitados desde clear().
+
+public:
+	/**
+	 * @brief Crea la cola vacía.
+	 * @param frontToBack Ordena primero por profundidad (true) o por estado (false).
+	 */
+	GERenderQueue(bool frontToBack);
+
+	/**
+	 * @brief Calcula la clave de ordenación de un draw.
+	 *
+	 * Los draws se agrupan siempre por pipeline. Dentro de cada pipeline se ordenan
+	 * de delante hacia atrás y, con la misma profundidad, por material y malla; o
+	 * por material y malla y, dentro de cada grupo, de delante hacia atrás.
+	 * @param pipeline Pipeline (8 bits).
+	 * @param material Identificador del material (16 bits).
+	 * @param mesh Identificador de los buffers de la malla (16 bits).
+	 * @param depth Distancia a la cámara (positiva).
+	 * @return Clave de 64 bits.
+	 */
+	uint64_t makeKey(uint32_t pipeline, uint32_t material, uint32_t mesh, float depth) const;
+
+	/**
+	 * @brief Asigna el pipeline con el que se graban los draws en la pasada de profundidad.
+	 * @param pipeline 0: pipeline principal; v + 1: variante v (solo escribe profundidad).
+	 */
+	void setDepthPipeline(uint32_t pipeline);
+
+	/**
+	 * @brief Vacía la cola y reinicia las estadísticas.
+	 */
+	void clear();
+
+	/**
+	 * @brief Añade un draw a la cola.
+	 * @param packet Draw a añadir.
+	 */
+	void submit(const GEDrawPacket& packet);
+
+	/**
+	 * @brief Ordena los draws por clave (radix sort estable de 8 bits por pasada).
+	 */
+	void sort();
+
+	/**
+	 * @brief Obtiene el número de draws de la cola.
+	 * @return Número de draws.
+	 */
+	uint32_t getPacketCount() const;
+
+	/**
+	 * @brief Graba un tramo de la cola ordenada.
+	 *
+	 * Se supone enlazado el set 0 y nada más: el primer draw del tramo siempre
+	 * enlaza su pipeline, porque antes puede haberse grabado otra pasada.
+	 * @param commandBuffer Buffer de comandos.
+	 * @param rc Contexto de renderizado (pipelines y layouts).
+	 * @param first Primer draw del tramo.
+	 * @param count Número de draws del tramo.
+	 * @param depthOnly Graba los draws con el pipeline de la pasada de profundidad.
+	 */
+	void record(VkCommandBuffer commandBuffer, GERenderingContext* rc, uint32_t first, uint32_t count, bool depthOnly = false);
+
+	/**
+	 * @brief Obtiene los binds grabados y evitados desde el último clear().
+	 * @return Estadísticas de la cola.
+	 */
+	GERenderQueueStats getStats() const;
+};
@@ -5,9 +5,6 @@
 
 #include "GERenderingContext.h"
 
-#include "resource.h"
-#include <windows.h>
-
 ///////////////////////////////////////////////////////////////////////////////////////////
 /////                                                                                 /////
 /////                              Métodos públicos                                   /////
@@ -24,11 +21,15 @@
 GERenderingContext::GERenderingContext(GEGraphicsContext* gc, GEDrawingContext* dc, GEPipelineConfig* config)
 {
 	imageCount = dc->getImageCount();
+	frameCount = dc->getFrameCount();
 	format = dc->getFormat();
 	extent = dc->getExtent();
+	finalLayout = dc->getFinalLayout();
+	overdrawQuery = nullptr;
+	updateViewport();
 	createRenderPass(gc);
-	createGraphicsPipeline(gc, config);
-	createDepthBuffers(gc);
+	createGraphicsPipeline(gc, config, &descriptorSetLayouts, &pipelineLayout, &graphicsPipeline);
+	createDepthBuffer(gc);
 	createFramebuffers(gc, dc);
 }
 
@@ -39,69 +40,198 @@ GERenderingContext::GERenderingContext(GEGraphicsContext* gc, GEDrawingContext*
  */
 void GERenderingContext::destroy(GEGraphicsContext* gc)
 {
-	for (uint32_t i = 0; i < imageCount; i++)
+	destroyFramebuffers(gc);
+	if (overdrawQuery != nullptr)
 	{
-		vkDestroyFramebuffer(gc->device, framebuffers[i], nullptr);
-		depthBuffers[i]->destroy(gc);
+		overdrawQuery->destroy(gc);
+		delete overdrawQuery;
+		overdrawQuery = nullptr;
+	}
+	for (size_t i = 0; i < variantPipelines.size(); i++)
+	{
+		vkDestroyPipeline(gc->device, variantPipelines[i], nullptr);
+		vkDestroyPipelineLayout(gc->device, variantPipelineLayouts[i], nullptr);
+		for (VkDescriptorSetLayout setLayout : variantDescriptorSetLayouts[i])
+		{
+			vkDestroyDescriptorSetLayout(gc->device, setLayout, nullptr);
+		}
 	}
 	vkDestroyPipeline(gc->device, graphicsPipeline, nullptr);
 	vkDestroyPipelineLayout(gc->device, pipelineLayout, nullptr);
-	vkDestroyDescriptorSetLayout(gc->device, descriptorSetLayout, nullptr);
+	for (VkDescriptorSetLayout setLayout : descriptorSetLayouts)
+	{
+		vkDestroyDescriptorSetLayout(gc->device, setLayout, nullptr);
+	}
 	vkDestroyRenderPass(gc->device, renderPass, nullptr);
 }
 
 /**
- * @brief Actualiza los buffers de comandos para añadir el renderizado.
- * @param commandBuffers Buffers de comandos.
+ * @brief Adapta el contexto al nuevo tamaño del swapchain.
+ * @param gc Contexto gráfico.
+ * @param dc Contexto de dibujo (ya reconstruido).
  */
-void GERenderingContext::startFillingCommandBuffers(std::vector<VkCommandBuffer> commandBuffers)
+void GERenderingContext::resize(GEGraphicsContext* gc, GEDrawingContext* dc)
 {
-	for (size_t i = 0; i < commandBuffers.size(); i++)
+	// El render pass solo depende del formato: si no cambia, sirven el render pass y los pipelines
+	if (dc->getFormat() != format)
 	{
-		VkCommandBufferBeginInfo beginInfo = {};
-		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		throw std::runtime_error("failed to resize rendering context: swapchain format changed!");
+	}
 
-		if (vkBeginCommandBuffer(commandBuffers[i], &beginInfo) != VK_SUCCESS)
-		{
-			throw std::runtime_error("failed to begin recording command buffer!");
-		}
+	// Los recursos por frame (consultas incluidas) no dependen del número de imágenes
+	destroyFramebuffers(gc);
+	imageCount = dc->getImageCount();
+	extent = dc->getExtent();
+	updateViewport();
+	createDepthBuffer(gc);
+	createFramebuffers(gc, dc);
+}
+
+/**
+ * @brief Activa la medida del overdraw en los command buffers que se graben a partir de ahora.
+ * @param gc Contexto gráfico.
+ * @return false si el dispositivo no admite las consultas necesarias.
+ */
+bool GERenderingContext::enableOverdrawQuery(GEGraphicsContext* gc)
+{
+	if (!GEOverdrawQuery::isSupported(gc)) return false;
+	if (overdrawQuery == nullptr) overdrawQuery = new GEOverdrawQuery(gc, frameCount);
+	return true;
+}
+
+/**
+ * @brief Prepara el buffer de comandos de un frame para renderizar sobre una imagen.
+ * @param commandBuffer Buffer de comandos (no puede estar pendiente de ejecución).
+ * @param frame Índice del frame.
+ * @param image Índice de la imagen.
+ * @param contents Origen de los comandos del render pass.
+ */
+void GERenderingContext::startFillingCommandBuffer(VkCommandBuffer commandBuffer, uint32_t frame, uint32_t image, VkSubpassContents contents)
+{
+	VkCommandBufferBeginInfo beginInfo = {};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+
+	if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to begin recording command buffer!");
+	}
 
-		VkClearValue clearValues[2];
-		clearValues[0].color = { 1.0f, 1.0f, 1.0f, 1.0f };
-		clearValues[1].depthStencil = { 1.0f, 0 };
+	// La consulta abarca todo el render pass (se reinicia y empieza fuera de él)
+	if (overdrawQuery != nullptr)
+	{
+		overdrawQuery->begin(commandBuffer, frame);
+	}
+
+	VkClearValue clearValues[2];
+	clearValues[0].color = { 1.0f, 1.0f, 1.0f, 1.0f };
+	clearValues[1].depthStencil = { 1.0f, 0 };
 
-		VkRenderPassBeginInfo renderPassInfo = {};
-		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-		renderPassInfo.renderPass = renderPass;
-		renderPassInfo.framebuffer = framebuffers[i];
-		renderPassInfo.renderArea.offset = { 0, 0 };
-		renderPassInfo.renderArea.extent = extent;
-		renderPassInfo.clearValueCount = 2;
-		renderPassInfo.pClearValues = clearValues;
+	VkRenderPassBeginInfo renderPassInfo = {};
+	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+	renderPassInfo.renderPass = renderPass;
+	renderPassInfo.framebuffer = framebuffers[image];
+	renderPassInfo.renderArea.offset = { 0, 0 };
+	renderPassInfo.renderArea.extent = extent;
+	renderPassInfo.clearValueCount = 2;
+	renderPassInfo.pClearValues = clearValues;
 
-		vkCmdBeginRenderPass(commandBuffers[i], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+	vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, contents);
 
-		vkCmdBindPipeline(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
+	// Los buffers secundarios no heredan el pipeline: cada uno enlaza el suyo
+	if (contents == VK_SUBPASS_CONTENTS_INLINE)
+	{
+		bindPipeline(commandBuffer);
 	}
 }
 
 /**
- * @brief Finaliza el llenado de los buffers de comandos.
- * @param commandBuffers Buffers de comandos.
+ * @brief Finaliza el llenado del buffer de comandos de un frame.
+ * @param commandBuffer Buffer de comandos.
+ * @param frame Índice del frame.
  */
-void GERenderingContext::endFillingCommandBuffers(std::vector<VkCommandBuffer> commandBuffers)
+void GERenderingContext::endFillingCommandBuffer(VkCommandBuffer commandBuffer, uint32_t frame)
 {
-	for (size_t i = 0; i < commandBuffers.size(); i++)
+	vkCmdEndRenderPass(commandBuffer);
+
+	if (overdrawQuery != nullptr)
 	{
-		vkCmdEndRenderPass(commandBuffers[i]);
+		overdrawQuery->end(commandBuffer, frame);
+	}
 
-		if (vkEndCommandBuffer(commandBuffers[i]) != VK_SUCCESS)
-		{
-			throw std::runtime_error("failed to record command buffer!");
-		}
+	if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to record command buffer!");
 	}
 }
 
+/**
+ * @brief Crea una variante del pipeline sobre el mismo render pass.
+ * @param gc Contexto gráfico.
+ * @param config Configuración de la variante.
+ * @return Índice de la variante creada.
+ */
+uint32_t GERenderingContext::addPipelineVariant(GEGraphicsContext* gc, GEPipelineConfig* config)
+{
+	std::vector<VkDescriptorSetLayout> setLayouts;
+	VkPipelineLayout layout;
+	VkPipeline pipeline;
+	createGraphicsPipeline(gc, config, &setLayouts, &layout, &pipeline);
+
+	variantDescriptorSetLayouts.push_back(setLayouts);
+	variantPipelineLayouts.push_back(layout);
+	variantPipelines.push_back(pipeline);
+	return (uint32_t)(variantPipelines.size() - 1);
+}
+
+/**
+ * @brief Activa una variante del pipeline en un buffer de comandos.
+ * @param commandBuffer Buffer de comandos.
+ * @param variant Índice de la variante.
+ */
+void GERenderingContext::bindPipelineVariant(VkCommandBuffer commandBuffer, uint32_t variant)
+{
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, variantPipelines[variant]);
+}
+
+/**
+ * @brief Activa el pipeline principal y fija el viewport y el scissor.
+ * @param commandBuffer Buffer de comandos.
+ */
+void GERenderingContext::bindPipeline(VkCommandBuffer commandBuffer)
+{
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
+
+	// Estado dinámico: las variantes lo comparten y se conserva al cambiar de pipeline
+	vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+	vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+}
+
+/**
+ * @brief Obtiene la información que heredan los buffers secundarios.
+ * @param index Índice de la imagen.
+ * @return Render pass, subpass y framebuffer de la imagen.
+ */
+VkCommandBufferInheritanceInfo GERenderingContext::getInheritanceInfo(uint32_t index)
+{
+	VkCommandBufferInheritanceInfo inheritance = {};
+	inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+	inheritance.renderPass = renderPass;
+	inheritance.subpass = 0;
+	inheritance.framebuffer = framebuffers[index];
+	// Con la consulta activa en el primario, los secundarios deben declarar sus estadísticas
+	inheritance.pipelineStatistics = overdrawQuery != nullptr ? GEOverdrawQuery::getStatistics() : 0;
+	return inheritance;
+}
+
+/**
+ * @brief Obtiene la extensión de las imágenes sobre las que se renderiza.
+ * @return Extensión de la imagen.
+ */
+VkExtent2D GERenderingContext::getExtent()
+{
+	return extent;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 /////                                                                                 /////
 /////                    Métodos de creación de los componentes                       /////
@@ -123,7 +253,7 @@ void GERenderingContext::createRenderPass(GEGraphicsContext* gc)
 	colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 	colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 	colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-	colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+	colorAttachment.finalLayout = finalLayout;
 
 	VkAttachmentDescription depthAttachment = {};
 	depthAttachment.format = gc->findDepthFormat();
@@ -149,14 +279,30 @@ void GERenderingContext::createRenderPass(GEGraphicsContext* gc)
 	subpass.pColorAttachments = &colorAttachmentRef;
 	subpass.pDepthStencilAttachment = &depthAttachmentRef;
 
+	// Todos los frames comparten el buffer de profundidad: el render pass de un frame
+	// espera a que el anterior termine de escribir en él
 	VkSubpassDependency dependency = {};
 	dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
 	dependency.dstSubpass = 0;
-	dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-	dependency.srcAccessMask = 0;
+	dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+	dependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
 	dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
 	dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
 
+	// Sin swapchain la imagen se copia a un buffer justo después del render pass
+	VkSubpassDependency dependencies[2] = { dependency, {} };
+	uint32_t dependencyCount = 1;
+	if (finalLayout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL)
+	{
+		dependencies[1].srcSubpass = 0;
+		dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+		dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		dependencies[1].dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		dependencies[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		dependencyCount = 2;
+	}
+
 	VkAttachmentDescription attachment[] = { colorAttachment, depthAttachment };
 
 	VkRenderPassCreateInfo renderPassInfo = {};
@@ -165,8 +311,8 @@ void GERenderingContext::createRenderPass(GEGraphicsContext* gc)
 	renderPassInfo.pAttachments = attachment;
 	renderPassInfo.subpassCount = 1;
 	renderPassInfo.pSubpasses = &subpass;
-	renderPassInfo.dependencyCount = 1;
-	renderPassInfo.pDependencies = &dependency;
+	renderPassInfo.dependencyCount = dependencyCount;
+	renderPassInfo.pDependencies = dependencies;
 
 	if (vkCreateRenderPass(gc->device, &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS)
 	{
@@ -178,24 +324,16 @@ void GERenderingContext::createRenderPass(GEGraphicsContext* gc)
  * @brief Crea el Pipeline de renderizado.
  * @param gc Contexto gráfico.
  * @param config Configuración del pipeline.
+ * @param setLayouts Layouts de descriptores creados (uno por set).
+ * @param layout Layout del pipeline creado.
+ * @param pipeline Pipeline creado.
  * 
  */
-void GERenderingContext::createGraphicsPipeline(GEGraphicsContext* gc, GEPipelineConfig* config)
+void GERenderingContext::createGraphicsPipeline(GEGraphicsContext* gc, GEPipelineConfig* config, std::vector<VkDescriptorSetLayout>* setLayouts, VkPipelineLayout* layout, VkPipeline* pipeline)
 {
-	viewport = {};
-	viewport.x = 0.0f;
-	viewport.y = 0.0f;
-	viewport.width = (float) config->extent.width;
-	viewport.height = (float) config->extent.height;
-	viewport.minDepth = 0.0f;
-	viewport.maxDepth = 1.0f;
-
-	scissor = {};
-	scissor.offset = { 0, 0 };
-	scissor.extent = config->extent;
-
-	VkShaderModule vertShaderModule, fragShaderModule;
-	VkPipelineShaderStageCreateInfo vertShaderStageInfo, fragShaderStageInfo;
+	VkPipelineShaderStageCreateInfo shaderStages[2];
+	std::vector<VkVertexInputBindingDescription> bindingDescriptions;
+	std::vector<VkVertexInputAttributeDescription> attributeDescriptions;
 	VkPipelineVertexInputStateCreateInfo vertexInputInfo;
 	VkPipelineInputAssemblyStateCreateInfo inputAssembly;
 	VkPipelineViewportStateCreateInfo viewportState;
@@ -204,22 +342,25 @@ void GERenderingContext::createGraphicsPipeline(GEGraphicsContext* gc, GEPipelin
 	VkPipelineDepthStencilStateCreateInfo depthStencil;
 	VkPipelineColorBlendAttachmentState colorBlendAttachment;
 	VkPipelineColorBlendStateCreateInfo colorBlending;
-
-	createPipelineLayout(gc, config);
-	createVertexShaderStageCreateInfo(gc, config->vertex_shader, &vertShaderModule, &vertShaderStageInfo);
-	createFragmentShaderStageCreateInfo(gc, config->fragment_shader, &fragShaderModule, &fragShaderStageInfo);
-	VkPipelineShaderStageCreateInfo shaderStages[] = { vertShaderStageInfo, fragShaderStageInfo };
-	createPipelineVertexInputStateCreateInfo(config, &vertexInputInfo);
+	VkPipelineDynamicStateCreateInfo dynamicState;
+
+	createPipelineLayout(gc, config, setLayouts, layout);
+	// Sin shader de fragmentos el pipeline solo escribe profundidad
+	uint32_t stageCount = config->fragment_shader >= 0 ? 2 : 1;
+	createVertexShaderStageCreateInfo(gc, config->vertex_shader, &shaderStages[0]);
+	if (stageCount > 1) createFragmentShaderStageCreateInfo(gc, config->fragment_shader, &shaderStages[1]);
+	createPipelineVertexInputStateCreateInfo(config, &bindingDescriptions, &attributeDescriptions, &vertexInputInfo);
 	createPipelineInputAssemblyStateCreateInfo(&inputAssembly);
 	createPipelineViewportStateCreateInfo(&viewportState);
 	createPipelineRasterizationStateCreateInfo(config, &rasterizer);
 	createPipelineMultisampleStateCreateInfo(&multisampling);
 	createPipelineDepthStencilStateCreateInfo(config, &depthStencil);
-	createPipelineColorBlendStateCreateInfo(&colorBlendAttachment, &colorBlending);
+	createPipelineColorBlendStateCreateInfo(config, &colorBlendAttachment, &colorBlending);
+	createPipelineDynamicStateCreateInfo(&dynamicState);
 
 	VkGraphicsPipelineCreateInfo pipelineInfo = {};
 	pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-	pipelineInfo.stageCount = 2;
+	pipelineInfo.stageCount = stageCount;
 	pipelineInfo.pStages = shaderStages;
 	pipelineInfo.pVertexInputState = &vertexInputInfo;
 	pipelineInfo.pInputAssemblyState = &inputAssembly;
@@ -228,33 +369,45 @@ void GERenderingContext::createGraphicsPipeline(GEGraphicsContext* gc, GEPipelin
 	pipelineInfo.pMultisampleState = &multisampling;
 	pipelineInfo.pDepthStencilState = &depthStencil;
 	pipelineInfo.pColorBlendState = &colorBlending;
-	pipelineInfo.pDynamicState = nullptr;
-	pipelineInfo.layout = pipelineLayout;
+	pipelineInfo.pDynamicState = &dynamicState;
+	pipelineInfo.layout = *layout;
 	pipelineInfo.renderPass = renderPass;
 	pipelineInfo.subpass = 0;
 	pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 
-	if (vkCreateGraphicsPipelines(gc->device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &graphicsPipeline) != VK_SUCCESS)
+	if (vkCreateGraphicsPipelines(gc->device, gc->pipelineCache->cache, 1, &pipelineInfo, nullptr, pipeline) != VK_SUCCESS)
 	{
 		throw std::runtime_error("failed to create graphics pipeline!");
 	}
-
-	vkDestroyShaderModule(gc->device, fragShaderModule, nullptr);
-	vkDestroyShaderModule(gc->device, vertShaderModule, nullptr);
 }
 
 /**
- * @brief Crea los buffers de profundidad.
+ * @brief Crea el buffer de profundidad.
+ *
+ * Se borra al empezar el render pass y no se conserva al terminar, así que basta
+ * uno para todas las imágenes y frames en vuelo.
  * @param gc Contexto gráfico.
  * 
  */
-void GERenderingContext::createDepthBuffers(GEGraphicsContext* gc)
+void GERenderingContext::createDepthBuffer(GEGraphicsContext* gc)
 {
-	depthBuffers.resize(imageCount);
-	for (size_t i = 0; i < imageCount; i++)
+	depthBuffer = new GEDepthBuffer(gc, extent);
+}
+
+/**
+ * @brief Destruye los framebuffers y el buffer de profundidad.
+ * @param gc Contexto gráfico.
+ */
+void GERenderingContext::destroyFramebuffers(GEGraphicsContext* gc)
+{
+	for (uint32_t i = 0; i < imageCount; i++)
 	{
-		depthBuffers[i] = new GEDepthBuffer(gc, extent);
+		vkDestroyFramebuffer(gc->device, framebuffers[i], nullptr);
 	}
+	framebuffers.clear();
+	depthBuffer->destroy(gc);
+	delete depthBuffer;
+	depthBuffer = nullptr;
 }
 
 /**
@@ -270,7 +423,7 @@ void GERenderingContext::createFramebuffers(GEGraphicsContext* gc,
 
 	for (size_t i = 0; i < imageCount; i++)
 	{
-		VkImageView attachments[] = { dc->imageViews[i], depthBuffers[i]->imageView };
+		VkImageView attachments[] = { dc->imageViews[i], depthBuffer->imageView };
 
 		VkFramebufferCreateInfo framebufferInfo{};
 		framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
@@ -295,45 +448,106 @@ void GERenderingContext::createFramebuffers(GEGraphicsContext* gc,
 /////                                                                                 /////
 ///////////////////////////////////////////////////////////////////////////////////////////
 
+/**
+ * @brief Comprueba que los buffers y push constants que usa un shader están en el layout.
+ *
+ * Cada (set, binding) del SPIR-V tiene que existir, ser del mismo tipo de buffer
+ * (uniforme o de almacenamiento, dinámico o no) y ser visible en la etapa del shader.
+ * El bloque de push constants tiene que caber en un rango de la misma etapa.
+ * @param shader Identificador del shader.
+ * @param stage Etapa del shader.
+ * @param config Configuración del pipeline (rangos de push constants).
+ * @param bindings Bindings del layout, por set.
+ */
+static void checkShaderLayout(int shader, VkShaderStageFlags stage, GEPipelineConfig* config, const std::vector<std::vector<VkDescriptorSetLayoutBinding>>& bindings)
+{
+	GEShaderInterface shaderInterface = GEShaderRegistry::reflect(shader);
+	for (const GEShaderBinding& used : shaderInterface.bindings)
+	{
+		if (used.set >= bindings.size() || used.binding >= bindings[used.set].size())
+		{
+			throw std::runtime_error("failed to find shader binding in pipeline layout!");
+		}
+
+		const VkDescriptorSetLayoutBinding& declared = bindings[used.set][used.binding];
+		bool uniform = declared.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER
+			|| declared.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+		bool storage = declared.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER
+			|| declared.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+		bool compatible = (used.type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER) ? storage : uniform;
+		if (!compatible || (declared.stageFlags & stage) == 0)
+		{
+			throw std::runtime_error("failed to match shader binding with pipeline layout!");
+		}
+	}
+
+	if (shaderInterface.pushConstantSize == 0) return;
+	uint32_t pushEnd = shaderInterface.pushConstantOffset + shaderInterface.pushConstantSize;
+	for (const VkPushConstantRange& range : config->pushConstantRanges)
+	{
+		if ((range.stageFlags & stage) != 0 && range.offset <= shaderInterface.pushConstantOffset
+			&& range.offset + range.size >= pushEnd)
+		{
+			return;
+		}
+	}
+	throw std::runtime_error("failed to find shader push constants in pipeline layout!");
+}
+
 /**
  * @brief Crea el esquema de los conjuntos de descriptores.
  * @param gc Contexto gráfico.
  * @param config Configuración del pipeline.
+ * @param setLayouts Layouts de descriptores creados (uno por set).
+ * @param layout Layout del pipeline creado.
  * 
  */
-void GERenderingContext::createPipelineLayout(GEGraphicsContext* gc, GEPipelineConfig* config)
+void GERenderingContext::createPipelineLayout(GEGraphicsContext* gc, GEPipelineConfig* config, std::vector<VkDescriptorSetLayout>* setLayouts, VkPipelineLayout* layout)
 {
-	uint32_t bindingCount = (uint32_t)config->descriptorTypes.size();
-	std::vector<VkDescriptorSetLayoutBinding> bindings(bindingCount);
-	for (uint32_t i = 0; i < bindingCount; i++)
+	// Los descriptores se reparten por sets; dentro de cada set se numeran en orden
+	uint32_t descriptorCount = (uint32_t)config->descriptorTypes.size();
+	std::vector<std::vector<VkDescriptorSetLayoutBinding>> bindings(1);
+	for (uint32_t i = 0; i < descriptorCount; i++)
 	{
+		uint32_t set = config->descriptorSets.empty() ? 0 : config->descriptorSets[i];
+		if (set >= bindings.size()) bindings.resize(set + 1);
+
 		VkDescriptorSetLayoutBinding binding = {};
-		binding.binding = i;
+		binding.binding = (uint32_t)bindings[set].size();
 		binding.descriptorCount = 1;
 		binding.descriptorType = config->descriptorTypes[i];
 		binding.pImmutableSamplers = nullptr;
 		binding.stageFlags = config->descriptorStages[i];
 
-		bindings[i] = binding;
+		bindings[set].push_back(binding);
 	}
 
-	VkDescriptorSetLayoutCreateInfo layoutInfo = {};
-	layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-	layoutInfo.bindingCount = bindingCount;
-	layoutInfo.pBindings = bindings.data();
+	// Lo que declaran los shaders compilados tiene que estar en el layout
+	checkShaderLayout(config->vertex_shader, VK_SHADER_STAGE_VERTEX_BIT, config, bindings);
+	if (config->fragment_shader >= 0) checkShaderLayout(config->fragment_shader, VK_SHADER_STAGE_FRAGMENT_BIT, config, bindings);
 
-	if (vkCreateDescriptorSetLayout(gc->device, &layoutInfo, nullptr, &descriptorSetLayout) != VK_SUCCESS)
+	setLayouts->resize(bindings.size());
+	for (size_t set = 0; set < bindings.size(); set++)
 	{
-		throw std::runtime_error("failed to create descriptor set layout!");
+		VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = (uint32_t)bindings[set].size();
+		layoutInfo.pBindings = bindings[set].data();
+
+		if (vkCreateDescriptorSetLayout(gc->device, &layoutInfo, nullptr, &(*setLayouts)[set]) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to create descriptor set layout!");
+		}
 	}
 
 	VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
 	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-	pipelineLayoutInfo.setLayoutCount = 1;
-	pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
-	pipelineLayoutInfo.pushConstantRangeCount = 0;
+	pipelineLayoutInfo.setLayoutCount = (uint32_t)setLayouts->size();
+	pipelineLayoutInfo.pSetLayouts = setLayouts->data();
+	pipelineLayoutInfo.pushConstantRangeCount = (uint32_t)config->pushConstantRanges.size();
+	pipelineLayoutInfo.pPushConstantRanges = config->pushConstantRanges.data();
 
-	if (vkCreatePipelineLayout(gc->device, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS)
+	if (vkCreatePipelineLayout(gc->device, &pipelineLayoutInfo, nullptr, layout) != VK_SUCCESS)
 	{
 		throw std::runtime_error("failed to create pipeline layout!");
 	}
@@ -342,81 +556,121 @@ void GERenderingContext::createPipelineLayout(GEGraphicsContext* gc, GEPipelineC
 /**
  * @brief Crea la información sobre el Vertex Shader.
  * @param gc Contexto gráfico.
- * @param resource Recurso del shader.
- * @param vertShaderModule Módulo de shader de salida.
+ * @param shader Identificador del shader.
  * @param vertShaderStageInfo Información de etapa de salida.
  */
-void GERenderingContext::createVertexShaderStageCreateInfo(GEGraphicsContext* gc, int resource, VkShaderModule* vertShaderModule, VkPipelineShaderStageCreateInfo* vertShaderStageInfo)
+void GERenderingContext::createVertexShaderStageCreateInfo(GEGraphicsContext* gc, int shader, VkPipelineShaderStageCreateInfo* vertShaderStageInfo)
 {
-	std::vector<char> vertShaderCode = getFileFromResource(resource);
-
-	*vertShaderModule = createShaderModule(gc, vertShaderCode);
-
 	*vertShaderStageInfo = {};
 	vertShaderStageInfo->sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
 	vertShaderStageInfo->stage = VK_SHADER_STAGE_VERTEX_BIT;
-	vertShaderStageInfo->module = *vertShaderModule;
+	vertShaderStageInfo->module = gc->shaderRegistry->getModule(shader);
 	vertShaderStageInfo->pName = "main";
 }
 
 /**
  * @brief Crea la información sobre el Fragment Shader.
  * @param gc Contexto gráfico.
- * @param resource Recurso del shader.
- * @param fragShaderModule Módulo de shader de salida.
+ * @param shader Identificador del shader.
  * @param fragShaderStageInfo Información de etapa de salida.
  */
-void GERenderingContext::createFragmentShaderStageCreateInfo(GEGraphicsContext* gc, int resource, VkShaderModule* fragShaderModule, VkPipelineShaderStageCreateInfo* fragShaderStageInfo)
+void GERenderingContext::createFragmentShaderStageCreateInfo(GEGraphicsContext* gc, int shader, VkPipelineShaderStageCreateInfo* fragShaderStageInfo)
 {
-	std::vector<char> fragShaderCode = getFileFromResource(resource);
-
-	*fragShaderModule = createShaderModule(gc, fragShaderCode);
-
 	*fragShaderStageInfo = {};
 	fragShaderStageInfo->sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
 	fragShaderStageInfo->stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-	fragShaderStageInfo->module = *fragShaderModule;
+	fragShaderStageInfo->module = gc->shaderRegistry->getModule(shader);
 	fragShaderStageInfo->pName = "main";
 }
 
+/**
+ * @brief Obtiene el número de componentes de un formato de atributo de vértice.
+ * @param format Formato del atributo.
+ * @return Número de componentes.
+ */
+static uint32_t getFormatComponents(VkFormat format)
+{
+	switch (format)
+	{
+	case VK_FORMAT_R32_SFLOAT:
+		return 1;
+	case VK_FORMAT_R32G32_SFLOAT:
+	case VK_FORMAT_R16G16_SNORM:
+		return 2;
+	case VK_FORMAT_R32G32B32_SFLOAT:
+		return 3;
+	case VK_FORMAT_R32G32B32A32_SFLOAT:
+	case VK_FORMAT_R16G16B16A16_SNORM:
+	case VK_FORMAT_R8G8B8A8_UNORM:
+	case VK_FORMAT_R8G8B8A8_SNORM:
+		return 4;
+	default:
+		throw std::runtime_error("failed to check vertex attribute: unsupported format!");
+	}
+}
+
+/**
+ * @brief Comprueba que cada entrada del shader de vértices tiene un atributo.
+ *
+ * El atributo de cada Location tiene que existir y tener tantos componentes como
+ * la entrada (por ejemplo vec4 para R16G16B16A16_SNORM y vec2 para R16G16_SNORM).
+ * @param config Configuración del pipeline.
+ */
+static void checkShaderInputs(GEPipelineConfig* config)
+{
+	GEShaderInterface shaderInterface = GEShaderRegistry::reflect(config->vertex_shader);
+	for (const GEShaderInput& input : shaderInterface.inputs)
+	{
+		if (input.location >= config->attrFormats.size()
+			|| getFormatComponents(config->attrFormats[input.location]) != input.components)
+		{
+			throw std::runtime_error("failed to match vertex shader inputs with vertex attributes!");
+		}
+	}
+}
+
 /**
  * @brief Crea la descripción de los atributos de los vértices.
+ *
+ * Las descripciones se guardan en los vectores del llamante porque el
+ * VkPipelineVertexInputStateCreateInfo solo apunta a ellas.
  * @param config Configuración del pipeline.
+ * @param bindingDescriptions Descripciones de los bindings de vértices creadas.
+ * @param attributeDescriptions Descripciones de los atributos creadas.
  * @param vertexInputInfo Información de entrada de vértices.
  */
-void GERenderingContext::createPipelineVertexInputStateCreateInfo(GEPipelineConfig* config, VkPipelineVertexInputStateCreateInfo* vertexInputInfo)
+void GERenderingContext::createPipelineVertexInputStateCreateInfo(GEPipelineConfig* config, std::vector<VkVertexInputBindingDescription>* bindingDescriptions, std::vector<VkVertexInputAttributeDescription>* attributeDescriptions, VkPipelineVertexInputStateCreateInfo* vertexInputInfo)
 {
-	std::vector<VkVertexInputBindingDescription> bindingDescriptions;
-	std::vector<VkVertexInputAttributeDescription> attributeDescriptions;
+	checkShaderInputs(config);
 
 	int attrCount = (int) config->attrOffsets.size();
 	int bindingCount = (attrCount > 0 ? 1 : 0);
 
-	bindingDescriptions.resize(bindingCount);
+	bindingDescriptions->resize(bindingCount);
 	for (int i = 0; i < bindingCount; i++)
 	{
-		bindingDescriptions[i] = {};
-		bindingDescriptions[i].binding = i;
-		bindingDescriptions[i].stride = config->attrStride;
-		bindingDescriptions[i].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+		(*bindingDescriptions)[i] = {};
+		(*bindingDescriptions)[i].binding = i;
+		(*bindingDescriptions)[i].stride = config->attrStride;
+		(*bindingDescriptions)[i].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
 	}
 
-	attributeDescriptions.resize(attrCount);
+	attributeDescriptions->resize(attrCount);
 	for (int i = 0; i < attrCount; i++)
 	{
-		attributeDescriptions[i] = {};
-		attributeDescriptions[i].binding = 0;
-		attributeDescriptions[i].location = i;
-		attributeDescriptions[i].format = config->attrFormats[i];
-		attributeDescriptions[i].offset = config->attrOffsets[i];
+		(*attributeDescriptions)[i] = {};
+		(*attributeDescriptions)[i].binding = 0;
+		(*attributeDescriptions)[i].location = i;
+		(*attributeDescriptions)[i].format = config->attrFormats[i];
+		(*attributeDescriptions)[i].offset = config->attrOffsets[i];
 	}
 
 	*vertexInputInfo = {};
 	vertexInputInfo->sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
 	vertexInputInfo->vertexBindingDescriptionCount = bindingCount;
 	vertexInputInfo->vertexAttributeDescriptionCount = attrCount;
-	vertexInputInfo->pVertexBindingDescriptions = bindingDescriptions.data();
-	vertexInputInfo->pVertexAttributeDescriptions = attributeDescriptions.data();
+	vertexInputInfo->pVertexBindingDescriptions = bindingDescriptions->data();
+	vertexInputInfo->pVertexAttributeDescriptions = attributeDescriptions->data();
 }
 
 /**
@@ -440,9 +694,9 @@ void GERenderingContext::createPipelineViewportStateCreateInfo(VkPipelineViewpor
 	*viewportState = {};
 	viewportState->sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
 	viewportState->viewportCount = 1;
-	viewportState->pViewports = &viewport;
+	viewportState->pViewports = nullptr;  // Dinámicos: se fijan en bindPipeline()
 	viewportState->scissorCount = 1;
-	viewportState->pScissors = &scissor;
+	viewportState->pScissors = nullptr;
 }
 
 /**
@@ -488,20 +742,23 @@ void GERenderingContext::createPipelineDepthStencilStateCreateInfo(GEPipelineCon
 	depthStencil->flags = 0;
 	depthStencil->depthTestEnable = config->depthTestEnable;
 	depthStencil->depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
-	depthStencil->depthWriteEnable = VK_TRUE;
+	depthStencil->depthWriteEnable = config->depthWriteEnable;
 	depthStencil->depthBoundsTestEnable = VK_FALSE;
 	depthStencil->stencilTestEnable = VK_FALSE;
 }
 
 /**
  * @brief Crea la información sobre la etapa de mezcla de colores.
+ * @param config Configuración del pipeline.
  * @param colorBlendAttachment Adjunto de mezcla de color.
  * @param colorBlending Información de mezcla de colores.
  */
-void GERenderingContext::createPipelineColorBlendStateCreateInfo(VkPipelineColorBlendAttachmentState* colorBlendAttachment, VkPipelineColorBlendStateCreateInfo* colorBlending)
+void GERenderingContext::createPipelineColorBlendStateCreateInfo(GEPipelineConfig* config, VkPipelineColorBlendAttachmentState* colorBlendAttachment, VkPipelineColorBlendStateCreateInfo* colorBlending)
 {
 	*colorBlendAttachment = {};
-	colorBlendAttachment->colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+	colorBlendAttachment->colorWriteMask = config->colorWriteEnable
+		? VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
+		: 0;
 	colorBlendAttachment->blendEnable = VK_FALSE;
 
 	*colorBlending = {};
@@ -516,6 +773,23 @@ void GERenderingContext::createPipelineColorBlendStateCreateInfo(VkPipelineColor
 	colorBlending->blendConstants[3] = 0.0f;
 }
 
+/**
+ * @brief Crea la información del estado dinámico (viewport y scissor).
+ * 
+ * Al no quedar fijados en el pipeline, un cambio de tamaño de la ventana solo
+ * obliga a reconstruir los framebuffers.
+ * @param dynamicState Información del estado dinámico.
+ */
+void GERenderingContext::createPipelineDynamicStateCreateInfo(VkPipelineDynamicStateCreateInfo* dynamicState)
+{
+	static const VkDynamicState dynamicStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+
+	*dynamicState = {};
+	dynamicState->sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+	dynamicState->dynamicStateCount = 2;
+	dynamicState->pDynamicStates = dynamicStates;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 /////                                                                                 /////
 /////                              Métodos auxiliares                                 /////
@@ -523,42 +797,19 @@ void GERenderingContext::createPipelineColorBlendStateCreateInfo(VkPipelineColor
 ///////////////////////////////////////////////////////////////////////////////////////////
 
 /**
- * @brief Crea un shader a partir de su código en SPIR-V.
- * @param gc Contexto gráfico.
- * @param code Código SPIR-V del shader.
- * @return Módulo de shader creado.
+ * @brief Ajusta el viewport y el scissor a la extensión actual.
  */
-VkShaderModule GERenderingContext::createShaderModule(GEGraphicsContext* gc, const std::vector<char>& code)
+void GERenderingContext::updateViewport()
 {
-	VkShaderModuleCreateInfo createInfo = {};
-	createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-	createInfo.codeSize = code.size();
-	createInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
-
-	VkShaderModule shaderModule;
-	if (vkCreateShaderModule(gc->device, &createInfo, nullptr, &shaderModule) != VK_SUCCESS)
-	{
-		throw std::runtime_error("failed to create shader module!");
-	}
+	viewport = {};
+	viewport.x = 0.0f;
+	viewport.y = 0.0f;
+	viewport.width = (float) extent.width;
+	viewport.height = (float) extent.height;
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
 
-	return shaderModule;
+	scissor = {};
+	scissor.offset = { 0, 0 };
+	scissor.extent = extent;
 }
-
-/**
- * @brief Extrae el contenido de un fichero incluido como recurso de la aplicación.
- * @param resource Identificador del recurso.
- * @return Vector con los bytes del fichero.
- */
-std::vector<char> GERenderingContext::getFileFromResource(int resource)
-{
-	HRSRC shaderHandle = FindResource(NULL, MAKEINTRESOURCE(resource), RT_HTML);
-	HGLOBAL shaderGlobal = LoadResource(NULL, shaderHandle);
-	LPCTSTR shaderPtr = static_cast<LPCTSTR>(LockResource(shaderGlobal));
-	DWORD shaderSize = SizeofResource(NULL, shaderHandle);
-
-	std::vector<char> shader(shaderSize);
-	memcpy(shader.data(), shaderPtr, shaderSize);
-	UnlockResource(shaderGlobal);
-	FreeResource(shaderGlobal);
-	return shader;
-}
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "GEDrawingContext.h"
 #include "GEPipelineConfig.h"
 #include "GEDepthBuffer.h"
+#include "GEOverdrawQuery.h"
 
 /**
  * @file GERenderingContext.h
@@ -19,16 +20,22 @@
 class GERenderingContext
 {
 public:
-	uint32_t imageCount; ///< Número de imágenes en el swapchain.
-	VkDescriptorSetLayout descriptorSetLayout; ///< Layout de los descriptor sets.
+	uint32_t imageCount; ///< Número de imágenes en el swapchain (un framebuffer por imagen).
+	uint32_t frameCount; ///< Número de frames en vuelo (copias de los recursos que se escriben en cada frame).
+	std::vector<VkDescriptorSetLayout> descriptorSetLayouts; ///< Layouts de los descriptor sets (uno por set).
 	VkPipelineLayout pipelineLayout; ///< Layout del pipeline.
+	std::vector<std::vector<VkDescriptorSetLayout>> variantDescriptorSetLayouts; ///< Layouts de descriptores de las variantes del pipeline.
+	std::vector<VkPipelineLayout> variantPipelineLayouts; ///< Layouts de las variantes del pipeline.
+	GEOverdrawQuery* overdrawQuery; ///< Medida del overdraw de cada frame (nullptr si no está activa).
 
 private:
 	VkFormat format;
 	VkExtent2D extent;
+	VkImageLayout finalLayout; ///< Layout en el que el render pass deja las imágenes del contexto de dibujo.
 	VkRenderPass renderPass;
 	VkPipeline graphicsPipeline;
-	std::vector<GEDepthBuffer*> depthBuffers;
+	std::vector<VkPipeline> variantPipelines;
+	GEDepthBuffer* depthBuffer;
 	std::vector<VkFramebuffer> framebuffers;
 	VkViewport viewport;
 	VkRect2D scissor;
@@ -49,38 +56,96 @@ public:
 	void destroy(GEGraphicsContext* gc);
 
 	/**
-	 * @brief Prepara los buffers de comandos para añadir las operaciones de renderizado.
-	 * @param commandBuffers Buffers de comandos a rellenar.
+	 * @brief Adapta el contexto al nuevo tamaño del swapchain.
+	 *
+	 * Solo se reconstruyen los framebuffers y el buffer de profundidad: el
+	 * viewport y el scissor son estado dinámico, así que el render pass y los
+	 * pipelines siguen siendo válidos mientras no cambie el formato.
+	 * @param gc Contexto gráfico.
+	 * @param dc Contexto de dibujo (ya reconstruido).
+	 */
+	void resize(GEGraphicsContext* gc, GEDrawingContext* dc);
+
+	/**
+	 * @brief Activa la medida del overdraw en los command buffers que se graben a partir de ahora.
+	 * @param gc Contexto gráfico.
+	 * @return false si el dispositivo no admite las consultas necesarias.
+	 */
+	bool enableOverdrawQuery(GEGraphicsContext* gc);
+
+	/**
+	 * @brief Prepara el buffer de comandos de un frame para renderizar sobre una imagen.
+	 * @param commandBuffer Buffer de comandos (no puede estar pendiente de ejecución).
+	 * @param frame Índice del frame.
+	 * @param image Índice de la imagen (framebuffer del render pass).
+	 * @param contents VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS si el render pass se graba
+	 *                 en buffers secundarios (en ese caso no se enlaza el pipeline).
+	 */
+	void startFillingCommandBuffer(VkCommandBuffer commandBuffer, uint32_t frame, uint32_t image, VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
+
+	/**
+	 * @brief Finaliza el llenado del buffer de comandos de un frame.
+	 * @param commandBuffer Buffer de comandos.
+	 * @param frame Índice del frame.
+	 */
+	void endFillingCommandBuffer(VkCommandBuffer commandBuffer, uint32_t frame);
+
+	/**
+	 * @brief Crea una variante del pipeline sobre el mismo render pass.
+	 * @param gc Contexto gráfico.
+	 * @param config Configuración de la variante (shaders y descriptores propios).
+	 * @return Índice de la variante creada.
+	 */
+	uint32_t addPipelineVariant(GEGraphicsContext* gc, GEPipelineConfig* config);
+
+	/**
+	 * @brief Activa una variante del pipeline en un buffer de comandos.
+	 * @param commandBuffer Buffer de comandos.
+	 * @param variant Índice de la variante.
+	 */
+	void bindPipelineVariant(VkCommandBuffer commandBuffer, uint32_t variant);
+
+	/**
+	 * @brief Activa el pipeline principal y fija el viewport y el scissor (necesario en cada buffer secundario).
+	 * @param commandBuffer Buffer de comandos.
+	 */
+	void bindPipeline(VkCommandBuffer commandBuffer);
+
+	/**
+	 * @brief Obtiene la información que heredan los buffers secundarios grabados dentro del render pass.
+	 * @param index Índice de la imagen.
+	 * @return Render pass, subpass y framebuffer de la imagen.
 	 */
-	void startFillingCommandBuffers(std::vector<VkCommandBuffer> commandBuffers);
+	VkCommandBufferInheritanceInfo getInheritanceInfo(uint32_t index);
 
 	/**
-	 * @brief Finaliza el llenado de los buffers de comandos.
-	 * @param commandBuffers Buffers de comandos.
+	 * @brief Obtiene la extensión de las imágenes sobre las que se renderiza.
+	 * @return Extensión de la imagen.
 	 */
-	void endFillingCommandBuffers(std::vector<VkCommandBuffer> commandBuffers);
+	VkExtent2D getExtent();
 
 private:
 	// ===== Métodos de creación de componentes =====
 	void createRenderPass(GEGraphicsContext* gc);
-	void createGraphicsPipeline(GEGraphicsContext* gc, GEPipelineConfig* config);
-	void createDepthBuffers(GEGraphicsContext* gc);
+	void createGraphicsPipeline(GEGraphicsContext* gc, GEPipelineConfig* config, std::vector<VkDescriptorSetLayout>* setLayouts, VkPipelineLayout* layout, VkPipeline* pipeline);
+	void createDepthBuffer(GEGraphicsContext* gc);
 	void createFramebuffers(GEGraphicsContext* gc, GEDrawingContext* dc);
+	void destroyFramebuffers(GEGraphicsContext* gc);
 
 	// ===== Métodos de definición del pipeline de renderizado =====
-	void createPipelineLayout(GEGraphicsContext* gc, GEPipelineConfig* config);
-	void createVertexShaderStageCreateInfo(GEGraphicsContext* gc, int resource, VkShaderModule* vertShaderModule, VkPipelineShaderStageCreateInfo* vertShaderStageInfo);
-	void createFragmentShaderStageCreateInfo(GEGraphicsContext* gc, int resource, VkShaderModule* fragShaderModule, VkPipelineShaderStageCreateInfo* fragShaderStageInfo);
-	void createPipelineVertexInputStateCreateInfo(GEPipelineConfig* config, VkPipelineVertexInputStateCreateInfo* vertexInputInfo);
+	void createPipelineLayout(GEGraphicsContext* gc, GEPipelineConfig* config, std::vector<VkDescriptorSetLayout>* setLayouts, VkPipelineLayout* layout);
+	void createVertexShaderStageCreateInfo(GEGraphicsContext* gc, int shader, VkPipelineShaderStageCreateInfo* vertShaderStageInfo);
+	void createFragmentShaderStageCreateInfo(GEGraphicsContext* gc, int shader, VkPipelineShaderStageCreateInfo* fragShaderStageInfo);
+	void createPipelineVertexInputStateCreateInfo(GEPipelineConfig* config, std::vector<VkVertexInputBindingDescription>* bindingDescriptions, std::vector<VkVertexInputAttributeDescription>* attributeDescriptions, VkPipelineVertexInputStateCreateInfo* vertexInputInfo);
 	void createPipelineInputAssemblyStateCreateInfo(VkPipelineInputAssemblyStateCreateInfo* inputAssembly);
 	void createPipelineViewportStateCreateInfo(VkPipelineViewportStateCreateInfo* viewportState);
 	void createPipelineRasterizationStateCreateInfo(GEPipelineConfig* config, VkPipelineRasterizationStateCreateInfo* rasterizer);
 	void createPipelineMultisampleStateCreateInfo(VkPipelineMultisampleStateCreateInfo* multisampling);
 	void createPipelineDepthStencilStateCreateInfo(GEPipelineConfig* config, VkPipelineDepthStencilStateCreateInfo* depthStencil);
-	void createPipelineColorBlendStateCreateInfo(VkPipelineColorBlendAttachmentState* colorBlendAttachment, VkPipelineColorBlendStateCreateInfo* colorBlending);
+	void createPipelineColorBlendStateCreateInfo(GEPipelineConfig* config, VkPipelineColorBlendAttachmentState* colorBlendAttachment, VkPipelineColorBlendStateCreateInfo* colorBlending);
+	void createPipelineDynamicStateCreateInfo(VkPipelineDynamicStateCreateInfo* dynamicState);
 
 	// ===== Métodos auxiliares =====
-	VkShaderModule createShaderModule(GEGraphicsContext* gc, const std::vector<char>& code);
-	std::vector<char> getFileFromResource(int resource);
+	void updateViewport();
 };
 
@@ -11,12 +11,13 @@
 #include "GETransform.h"
 #include "GEMaterial.h"
 #include "GELight.h"
-#include <windows.h>
-#include "resource.h"
+#include "DEBUG.h"
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
+#include <algorithm>
+#include <thread>
 
 /**
  * @brief Crea la animación de tiro libre con salto.
@@ -414,14 +415,26 @@ GEAnimation* GEScene::createBasketballThrowAnimation()
 /**
  * @brief Crea la escena.
  */
-GEScene::GEScene(GEGraphicsContext* gc, GEDrawingContext* dc, GECommandContext* cc)
+GEScene::GEScene(GEGraphicsContext* gc, GEDrawingContext* dc, GECommandContext* cc, bool pushTransforms,
+    const std::string& meshPath)
 {
+    this->pushTransforms = pushTransforms;
     VkExtent2D extent = dc->getExtent();
     double aspect = (double)extent.width / (double)extent.height;
     aspect_ratio(aspect);
 
     GEPipelineConfig* config = createPipelineConfig(dc->getExtent());
     rc = new GERenderingContext(gc, dc, config);
+    commandContext = cc;
+
+    // La pasada de profundidad usa los mismos shaders de vértices y descriptores, sin fragment shader
+    depthPipelineVariant = 0;
+    if (DEPTH_PREPASS)
+    {
+        config->setDepthOnly();
+        depthPipelineVariant = rc->addPipelineVariant(gc, config);
+    }
+    delete config;
 
     this->camera = new GECamera();
 
@@ -434,7 +447,7 @@ GEScene::GEScene(GEGraphicsContext* gc, GEDrawingContext* dc, GECommandContext*
     this->camera->setMoveStep(0.0f);
 
     
-    GELight light = {};
+    light = {};
     light.Ldir = glm::normalize(glm::vec3(1.0f, -0.8f, -0.7f));
     light.La = glm::vec3(0.2f, 0.2f, 0.2f);
     light.Ld = glm::vec3(0.8f, 0.8f, 0.8f);
@@ -446,23 +459,111 @@ GEScene::GEScene(GEGraphicsContext* gc, GEDrawingContext* dc, GECommandContext*
     groundMat.Ks = glm::vec3(0.8f, 0.8f, 0.8f);
     groundMat.Shininess = 16.0f;
 
+    // La cámara y la luz se suben una vez por frame y se enlazan una vez por command buffer
+    frameUniforms = new GEFrameUniforms(gc, rc);
+
+    // Todas las figuras comparten un buffer de uniformes por frame (offsets dinámicos)
+    // con el material en el set 1 y el objeto en el set 2 (sin set 2 con push constants)
+    std::vector<size_t> ranges(1, sizeof(GEMaterial));
+    if (!pushTransforms) ranges.push_back(sizeof(GETransform));
+    uniformRing = new GEUniformRing(gc, rc, UNIFORM_RING_SIZE, ranges, 1);
+
+    // La geometría estática se copia a memoria DEVICE_LOCAL en un único envío: las
+    // figuras en un par de buffers y las mallas instanciadas (comprimidas) en otro,
+    // porque cada pipeline espera un formato de vértice
+    uploadContext = new GEUploadContext(gc);
+    meshBuffer = new GEMeshBuffer();
+    instanceMeshBuffer = new GEMeshBuffer(PACKED_VERTICES);
+
     ground = new GEGround(5.0f, 5.0f);
-    ground->initialize(gc, rc);
-    ground->setLight(light);
+    ground->initialize(uniformRing, meshBuffer);
     ground->setMaterial(groundMat);
+    figures.push_back(ground);
+
+    // Malla convertida con --convert: el nivel 0 se sube directamente desde el fichero
+    // proyectado (sin comprimir, con buffers propios) y se dibuja como una figura más
+    GEMeshFile* meshFile = nullptr;
+    if (!meshPath.empty())
+    {
+        meshFile = new GEMeshFile(meshPath);
+        const GEBoundingSphere& bounds = meshFile->getHeader().bounds;
+        float scale = (bounds.radius > 0.0f) ? LOADED_MESH_RADIUS / bounds.radius : 1.0f;
+
+        GEMaterial meshMat = {};
+        meshMat.Ka = glm::vec3(0.3f, 0.15f, 0.05f);
+        meshMat.Kd = glm::vec3(0.8f, 0.4f, 0.1f);
+        meshMat.Ks = glm::vec3(0.5f, 0.5f, 0.5f);
+        meshMat.Shininess = 32.0f;
+
+        GEFigure* loaded = new GEFigure();
+        loaded->initialize(uniformRing, meshFile->loadLevel(gc, uploadContext, 0));
+        // Centrada al lado del esqueleto, apoyada en el suelo
+        loaded->setLocation(glm::translate(glm::mat4(1.0f), glm::vec3(1.5f, LOADED_MESH_RADIUS, 0.0f))
+            * glm::scale(glm::mat4(1.0f), glm::vec3(scale))
+            * glm::translate(glm::mat4(1.0f), -bounds.center));
+        loaded->setMaterial(meshMat);
+        figures.push_back(loaded);
+    }
 
-    // Crear esqueleto
+    renderQueue = new GERenderQueue(FRONT_TO_BACK);
+    if (DEPTH_PREPASS) renderQueue->setDepthPipeline(depthPipelineVariant + 1);
+
+    // Crear esqueleto (todas las articulaciones comparten la misma esfera y el mismo cilindro,
+    // y se dibujan con un draw indirecto instanciado por malla)
+    meshCache = new GEMeshCache(uploadContext, instanceMeshBuffer);
+    instanceRenderer = new GEInstanceRenderer(FRONT_TO_BACK, DEPTH_PREPASS);
     skeleton = new GESkeleton();
     skeleton->setPosition(glm::vec3(0.0f, 1.0f, 0.0f));
-    skeleton->initialize(gc, rc);
-    skeleton->setLight(light);
+    skeleton->initialize(gc, meshCache, instanceRenderer);
+    instanceRenderer->initialize(gc, rc);
+
+    meshBuffer->build(gc, uploadContext);
+    instanceMeshBuffer->build(gc, uploadContext);
+    uploadContext->submit(gc);
+    // La subida ya ha copiado los datos proyectados
+    delete meshFile;
     
     // Crear animación
     animation = createBasketballThrowAnimation();
     
-    lastTime = glfwGetTime();
-
-    fillCommandBuffers(cc->commandBuffers);
+    lastTime = std::chrono::steady_clock::now();
+    fixedTimestep = 0.0;
+    cullStats = {};
+    triangleCount = 0;
+#ifdef DEBUG
+    cpuTime = 0.0;
+    cpuFrames = 0;
+    recordTime = 0.0;
+    overdrawSum = 0.0;
+    overdrawFrames = 0;
+    // Fragmentos sombreados por píxel, medidos en la GPU en cada frame
+    rc->enableOverdrawQuery(gc);
+#endif
+
+    // Cada hilo graba en sus propios command pools; el hilo principal también graba
+    uint32_t threadCount = std::min(RECORDING_THREADS, std::max(std::thread::hardware_concurrency(), 1u));
+    recorder = new GECommandRecorder(gc, rc->frameCount, threadCount);
+
+#ifdef DEBUG
+    GEMemoryStats stats = gc->allocator->getStats();
+    std::cout << "[Memoria] bloques: " << stats.blockCount
+              << ", asignaciones: " << stats.allocationCount
+              << ", usado: " << stats.bytesUsed << "/" << stats.bytesReserved << " bytes"
+              << ", fragmentacion: " << stats.fragmentation << std::endl;
+    std::cout << "[Descriptores] pools: " << gc->descriptorAllocator->getPoolCount()
+              << ", conjuntos: " << gc->descriptorAllocator->getSetCount() << std::endl;
+    std::cout << "[Subida] " << uploadContext->getLastUploadSize() << " bytes a "
+              << uploadContext->getThroughput() << " MB/s" << std::endl;
+    std::cout << "[Geometria] vertices: " << meshBuffer->getVertexCount() + instanceMeshBuffer->getVertexCount()
+              << ", indices: " << meshBuffer->getIndexCount() + instanceMeshBuffer->getIndexCount()
+              << ", bytes de vertices de instancias: " << instanceMeshBuffer->getVertexCount() * instanceMeshBuffer->getVertexSize()
+              << ", draws de instancias: " << instanceRenderer->getDrawCount()
+              << " en " << instanceRenderer->getDrawCallCount() << " llamadas" << std::endl;
+    GEVertexCacheStats figureCache = meshBuffer->getCacheStats();
+    GEVertexCacheStats instanceCache = instanceMeshBuffer->getCacheStats();
+    std::cout << "[Cache de vertices] ACMR figuras: " << figureCache.acmrBefore << " -> " << figureCache.acmrAfter
+              << ", instancias: " << instanceCache.acmrBefore << " -> " << instanceCache.acmrAfter << std::endl;
+#endif
 }
 
 /**
@@ -474,11 +575,40 @@ void GEScene::destroy(GEGraphicsContext* gc)
     rc->destroy(gc);
     delete rc;
 
-    ground->destroy(gc);
-    delete ground;
+    recorder->destroy(gc);
+    delete recorder;
+    delete renderQueue;
+
+    for (GEFigure* figure : figures)
+    {
+        figure->destroy(gc);
+        delete figure;
+    }
+    figures.clear();
+
+    uniformRing->destroy(gc);
+    delete uniformRing;
+
+    frameUniforms->destroy(gc);
+    delete frameUniforms;
     
     skeleton->destroy(gc);
     delete skeleton;
+
+    instanceRenderer->destroy(gc);
+    delete instanceRenderer;
+
+    meshCache->destroy(gc);
+    delete meshCache;
+
+    meshBuffer->destroy(gc);
+    delete meshBuffer;
+
+    instanceMeshBuffer->destroy(gc);
+    delete instanceMeshBuffer;
+
+    uploadContext->destroy(gc);
+    delete uploadContext;
     
     delete animation;
 }
@@ -491,33 +621,122 @@ void GEScene::destroy(GEGraphicsContext* gc)
  */
 void GEScene::recreate(GEGraphicsContext* gc, GEDrawingContext* dc, GECommandContext* cc)
 {
-    rc->destroy(gc);
-    GEPipelineConfig* config = createPipelineConfig(dc->getExtent());
-    this->rc = new GERenderingContext(gc, dc, config);
-    fillCommandBuffers(cc->commandBuffers);
+    // El render pass y los pipelines se conservan: solo cambian los framebuffers.
+    // Los recursos por frame no dependen del número de imágenes
+    rc->resize(gc, dc);
+    commandContext = cc;
 }
 
 /**
  * @brief Actualiza la información para generar la imagen.
  * @param gc Contexto gráfico.
- * @param index Índice de la imagen a renderizar.
+ * @param frame Índice del frame en vuelo.
+ * @param image Índice de la imagen a renderizar.
  */
-void GEScene::update(GEGraphicsContext* gc, uint32_t index)
+void GEScene::update(GEGraphicsContext* gc, uint32_t frame, uint32_t image)
 {
+#ifdef DEBUG
+    // Reloj propio: sin ventana (benchmark) GLFW no está inicializado
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    // El uso anterior de este frame ya ha terminado: su consulta tiene resultado
+    double overdraw;
+    if (rc->overdrawQuery != nullptr && rc->overdrawQuery->getOverdraw(gc, frame, rc->getExtent(), &overdraw))
+    {
+        overdrawSum += overdraw;
+        overdrawFrames++;
+    }
+#endif
+
     camera->update();
     glm::mat4 view = camera->getViewMatrix();
 
-    // Calcular deltaTime
-    double currentTime = glfwGetTime();
-    float deltaTime = (float)(currentTime - lastTime);
-    lastTime = currentTime;
+    // Calcular deltaTime (con paso fijo no se consulta el reloj)
+    float deltaTime = (float)fixedTimestep;
+    if (fixedTimestep <= 0.0)
+    {
+        std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
+        deltaTime = std::chrono::duration<float>(currentTime - lastTime).count();
+        lastTime = currentTime;
+    }
     
     // Actualizar animación
     animation->update(deltaTime);
     animation->applyToSkeleton(skeleton);
 
-    ground->update(gc, index, view, projection);
-    skeleton->update(gc, index, view, projection);
+    frameUniforms->update(gc, frame, view, projection, light);
+    frustum.update(projection * view);
+    glm::vec3 eye = camera->getPosition();
+    uint32_t visibleFigures = 0;
+    uint32_t figureTriangles = 0;
+    // Las figuras visibles envían su draw a la cola, que se ordena para agrupar el estado,
+    // y copian sus uniformes seguidos en el buffer del frame (un único flush)
+    renderQueue->clear();
+    uniformRing->begin(frame);
+    for (GEFigure* figure : figures)
+    {
+        if (figure->cull(frustum))
+        {
+            visibleFigures++;
+            figureTriangles += figure->getTriangleCount();
+        }
+        figure->submit(renderQueue, (int)frame, eye);
+    }
+    uniformRing->flush(gc);
+    renderQueue->sort();
+    skeleton->update();
+    // Píxeles de un objeto de tamaño 1 a distancia 1, para elegir el nivel de detalle
+    GELodView lodView;
+    lodView.eye = eye;
+    lodView.pixelScale = fabsf(projection[1][1]) * rc->getExtent().height * 0.5f;
+    instanceRenderer->update(gc, frame, frustum, lodView);
+
+    uint32_t objectCount = instanceRenderer->getInstanceCount() + (uint32_t)figures.size();
+    cullStats.visible = instanceRenderer->getVisibleCount() + visibleFigures;
+    cullStats.culled = objectCount - cullStats.visible;
+    triangleCount = instanceRenderer->getTriangleCount() + figureTriangles;
+
+    // La cola cambia en cada frame (visibilidad, orden y push constants): se graba siempre
+#ifdef DEBUG
+    std::chrono::steady_clock::time_point recordStart = std::chrono::steady_clock::now();
+#endif
+    fillCommandBuffer(commandContext->commandBuffers[frame], frame, image);
+#ifdef DEBUG
+    recordTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - recordStart).count();
+#endif
+#ifdef DEBUG
+    if (rc->overdrawQuery != nullptr) rc->overdrawQuery->markSubmitted(frame);
+#endif
+
+#ifdef DEBUG
+    cpuTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    cpuFrames++;
+    if (cpuFrames == CPU_STATS_FRAMES)
+    {
+        std::cout << "[CPU] transformaciones por " << (pushTransforms ? "push constants" : "UBO")
+                  << ": " << (cpuTime * 1000000.0 / cpuFrames) << " us/frame" << std::endl;
+        GERenderQueueStats queueStats = renderQueue->getStats();
+        std::cout << "[Grabacion] draws: " << queueStats.packets + 1
+                  << ", hilos: " << recorder->getActiveThreads()
+                  << ", " << (recordTime * 1000000.0 / cpuFrames) << " us/grabacion" << std::endl;
+        std::cout << "[Cola] binds grabados: " << queueStats.bindsIssued
+                  << ", evitados: " << queueStats.bindsSkipped << std::endl;
+        std::cout << "[Culling] visibles: " << cullStats.visible
+                  << ", descartados: " << cullStats.culled << std::endl;
+        std::cout << "[LOD] triangulos por frame: " << triangleCount << std::endl;
+        if (overdrawFrames > 0)
+        {
+            std::cout << "[Overdraw] fragmentos sombreados por pixel: " << overdrawSum / overdrawFrames
+                      << " (orden " << (FRONT_TO_BACK ? "delante-atras" : "por estado")
+                      << ", pasada de profundidad: " << (DEPTH_PREPASS ? "si" : "no") << ")" << std::endl;
+        }
+        overdrawSum = 0.0;
+        overdrawFrames = 0;
+        cpuTime = 0.0;
+        cpuFrames = 0;
+        recordTime = 0.0;
+    }
+#endif
 }
 
 /**
@@ -580,7 +799,7 @@ void GEScene::key_action(int key, bool pressed)
         break;
     case GLFW_KEY_R:
         if (pressed) {
-            animation->reset();
+            resetAnimation();
             std::cout << "Animacion reiniciada" << std::endl;
         }
         break;
@@ -608,15 +827,47 @@ void GEScene::key_action(int key, bool pressed)
 void GEScene::aspect_ratio(double aspect)
 {
     constexpr double fov = glm::radians(30.0f);
-    double sin_fov = sin(fov);
-    double cos_fov = cos(fov);
-    float wHeight = (float)(sin_fov * 0.2 / cos_fov);
-    float wWidth = (float)(wHeight * aspect);
-
     projection = glm::perspective((float)fov, (float)aspect, 0.2f, 400.0f);
     projection[1][1] *= -1.0f;
 }
 
+/**
+ * @brief Fija el paso de tiempo de la animación.
+ * @param timestep Segundos por frame (0: tiempo real).
+ */
+void GEScene::setFixedTimestep(double timestep)
+{
+    fixedTimestep = timestep;
+    lastTime = std::chrono::steady_clock::now();
+}
+
+/**
+ * @brief Vuelve al comienzo de la animación.
+ */
+void GEScene::resetAnimation()
+{
+    animation->reset();
+    if (fixedTimestep <= 0.0) lastTime = std::chrono::steady_clock::now();
+}
+
+/**
+ * @brief Obtiene el resultado del descarte por volumen de visión del último frame.
+ * @return Número de objetos visibles y descartados.
+ */
+GECullStats GEScene::getCullStats() const
+{
+    return cullStats;
+}
+
+/**
+ * @brief Obtiene el número de triángulos enviados en el último frame.
+ * @return Triángulos de las figuras y de las instancias dibujadas.
+ */
+uint32_t GEScene::getTriangleCount() const
+{
+    return triangleCount;
+}
+
 /**
  * @brief Obtiene la configuración del pipeline de renderizado.
  * @param extent Extensión de la imagen.
@@ -625,8 +876,8 @@ void GEScene::aspect_ratio(double aspect)
 GEPipelineConfig* GEScene::createPipelineConfig(VkExtent2D extent)
 {
     GEPipelineConfig* config = new GEPipelineConfig();
-    config->vertex_shader = IDR_HTML1;
-    config->fragment_shader = IDR_HTML2;
+    config->vertex_shader = SHADER_VERT;
+    config->fragment_shader = SHADER_FRAG;
 
     config->attrStride = sizeof(GEVertex);
     config->attrOffsets.resize(2);
@@ -636,16 +887,32 @@ GEPipelineConfig* GEScene::createPipelineConfig(VkExtent2D extent)
     config->attrFormats[0] = VK_FORMAT_R32G32B32_SFLOAT;
     config->attrFormats[1] = VK_FORMAT_R32G32B32_SFLOAT;
 
-    config->descriptorTypes.resize(3);
-    config->descriptorTypes[0] = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    config->descriptorTypes[1] = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    config->descriptorTypes[2] = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    config->descriptorStages.resize(3);
-    config->descriptorStages[0] = VK_SHADER_STAGE_ALL_GRAPHICS;
-    config->descriptorStages[1] = VK_SHADER_STAGE_FRAGMENT_BIT;
-    config->descriptorStages[2] = VK_SHADER_STAGE_FRAGMENT_BIT;
+    GEFrameUniforms::addDescriptors(config);
+
+    config->descriptorTypes.push_back(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC);
+    config->descriptorStages.push_back(VK_SHADER_STAGE_FRAGMENT_BIT);
+    config->descriptorSets.push_back(1);
+
+    if (pushTransforms)
+    {
+        config->vertex_shader = SHADER_PUSHED_VERT;
+
+        VkPushConstantRange range = {};
+        range.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        range.offset = 0;
+        range.size = sizeof(GETransform);
+        config->pushConstantRanges.push_back(range);
+    }
+    else
+    {
+        config->descriptorTypes.push_back(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC);
+        config->descriptorStages.push_back(VK_SHADER_STAGE_VERTEX_BIT);
+        config->descriptorSets.push_back(2);
+    }
 
     config->depthTestEnable = VK_TRUE;
+    // Con pasada previa la profundidad ya es la final: basta con compararla (LESS_OR_EQUAL)
+    config->depthWriteEnable = DEPTH_PREPASS ? VK_FALSE : VK_TRUE;
     config->cullMode = VK_CULL_MODE_BACK_BIT;
     config->extent = extent;
 
@@ -653,16 +920,55 @@ GEPipelineConfig* GEScene::createPipelineConfig(VkExtent2D extent)
 }
 
 /**
- * @brief Rellena los buffers de comandos.
- * @param commandBuffers Buffers de comandos a rellenar.
+ * @brief Graba el buffer de comandos de un frame.
+ * @param commandBuffer Buffer de comandos.
+ * @param frame Índice del frame.
+ * @param image Índice de la imagen.
  */
-void GEScene::fillCommandBuffers(std::vector<VkCommandBuffer> commandBuffers)
+void GEScene::fillCommandBuffer(VkCommandBuffer commandBuffer, uint32_t frame, uint32_t image)
 {
-    rc->startFillingCommandBuffers(commandBuffers);
-    for (size_t i = 0; i < commandBuffers.size(); i++)
+    uint32_t drawCount = (renderQueue->getPacketCount() + 1) * (DEPTH_PREPASS ? 2 : 1);
+
+    // Los tramos de la lista se graban en buffers secundarios que ejecuta el primario
+    rc->startFillingCommandBuffer(commandBuffer, frame, image, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+    recorder->record(commandBuffer, rc, frame, image, drawCount,
+        [this, frame](VkCommandBuffer secondary, uint32_t first, uint32_t count) { recordDraws(secondary, frame, first, count); });
+    rc->endFillingCommandBuffer(commandBuffer, frame);
+}
+
+/**
+ * @brief Graba un tramo de la lista de draws en un buffer secundario.
+ * @param commandBuffer Buffer de comandos secundario.
+ * @param frame Índice del frame.
+ * @param first Primer draw del tramo.
+ * @param count Número de draws del tramo.
+ */
+void GEScene::recordDraws(VkCommandBuffer commandBuffer, uint32_t frame, uint32_t first, uint32_t count)
+{
+    // El buffer secundario empieza sin estado: pipeline y set 0 en cada tramo
+    rc->bindPipeline(commandBuffer);
+    frameUniforms->addCommands(commandBuffer, rc->pipelineLayout, (int)frame);
+    uint32_t packetCount = renderQueue->getPacketCount();
+    uint32_t passDraws = packetCount + 1;
+    uint32_t passCount = DEPTH_PREPASS ? 2 : 1;
+    for (uint32_t pass = 0; pass < passCount; pass++)
     {
-        ground->addCommands(commandBuffers[i], rc->pipelineLayout, (int)i);
-        skeleton->addCommands(commandBuffers[i], rc->pipelineLayout, (int)i);
+        // Parte del tramo que cae en esta pasada, relativa a su inicio
+        bool depthOnly = DEPTH_PREPASS && pass == 0;
+        uint32_t passFirst = pass * passDraws;
+        uint32_t begin = std::max(first, passFirst) - passFirst;
+        uint32_t end = std::min(first + count, passFirst + passDraws);
+        if (end <= passFirst + begin) continue;
+        end -= passFirst;
+
+        if (begin < packetCount)
+        {
+            renderQueue->record(commandBuffer, rc, begin, std::min(end, packetCount) - begin, depthOnly);
+        }
+        if (end > packetCount)
+        {
+            if (depthOnly) instanceRenderer->addDepthCommands(commandBuffer, rc, (int)frame);
+            else instanceRenderer->addCommands(commandBuffer, rc, (int)frame);
+        }
     }
-    rc->endFillingCommandBuffers(commandBuffers);
 }
\ No newline at end of file
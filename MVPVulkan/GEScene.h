@@ -11,11 +11,33 @@
 #include "GERenderingContext.h"
 
 #include "GEFigure.h"
+#include "GEUniformRing.h"
+#include "GEFrameUniforms.h"
+#include "GEMeshCache.h"
+#include "GEMeshBuffer.h"
+#include "GEUploadContext.h"
+#include "GEInstanceRenderer.h"
 #include "GESkeleton.h"
 #include "GEAnimation.h"
 #include "GECamera.h"
+#include "GEFrustum.h"
+#include "GECommandRecorder.h"
+#include "GERenderQueue.h"
+#include "GEMeshFile.h"
+#include "DEBUG.h"
 #include <vulkan/vulkan.h>
 #include <glm/glm.hpp>
+#include <chrono>
+#include <string>
+
+const size_t UNIFORM_RING_SIZE = 64 * 1024; ///< Tamaño del buffer de uniformes de cada frame en vuelo.
+const bool PUSH_TRANSFORMS = true; ///< Por defecto, envía la matriz Model de las figuras por push constants en lugar de por el buffer de uniformes (--ubo-transforms lo desactiva).
+const bool PACKED_VERTICES = true; ///< Guarda las mallas de las instancias con vértices comprimidos (GEPackedVertex).
+const bool FRONT_TO_BACK = true; ///< Ordena los draws opacos de delante hacia atrás (false: por estado del pipeline).
+const bool DEPTH_PREPASS = false; ///< Dibuja antes una pasada solo de profundidad (escenas con mucho overdraw).
+const uint32_t RECORDING_THREADS = 4; ///< Hilos máximos para grabar los buffers secundarios (limitado por los núcleos disponibles).
+const float LOADED_MESH_RADIUS = 0.5f; ///< Radio al que se escala la malla cargada de un fichero .gem.
+const uint32_t CPU_STATS_FRAMES = 600; ///< Frames promediados en la medida del tiempo de CPU (DEBUG).
 
 /**
  * @class GEScene
@@ -25,12 +47,37 @@ class GEScene
 {
 private:
     GERenderingContext* rc; ///< Contexto de renderizado.
+    GECommandContext* commandContext; ///< Command buffers primarios (se graban en cada frame).
+    GEFrameUniforms* frameUniforms; ///< Cámara y luz, compartidas por todos los pipelines (set 0).
+    GEUniformRing* uniformRing; ///< Buffer de uniformes compartido por las figuras.
+    GEMeshCache* meshCache; ///< Caché de mallas compartidas.
+    GEMeshBuffer* meshBuffer; ///< Vertex e index buffer compartidos por las figuras estáticas.
+    GEMeshBuffer* instanceMeshBuffer; ///< Vertex e index buffer compartidos por las mallas de las instancias.
+    GEUploadContext* uploadContext; ///< Subida de la geometría estática a memoria DEVICE_LOCAL.
+    GEInstanceRenderer* instanceRenderer; ///< Renderizador de las articulaciones por instancias.
     GEFigure* ground; ///< Figura del terreno.
+    std::vector<GEFigure*> figures; ///< Figuras que se dibujan con el pipeline principal.
+    GERenderQueue* renderQueue; ///< Draws de las figuras visibles en el frame actual, ordenados.
+    uint32_t depthPipelineVariant; ///< Variante del pipeline de las figuras para la pasada de profundidad.
+    bool pushTransforms; ///< La matriz Model de las figuras va por push constants (false: por el buffer de uniformes, set 2).
+    GECommandRecorder* recorder; ///< Grabación en paralelo de los buffers secundarios.
     GESkeleton* skeleton; ///< Esqueleto de la escena.
     GEAnimation* animation; ///< Animación asociada.
-    double lastTime; ///< Tiempo de la última actualización.
+    std::chrono::steady_clock::time_point lastTime; ///< Momento de la última actualización.
+    double fixedTimestep; ///< Paso fijo de la animación en segundos (0: tiempo real).
     GECamera* camera; ///< Cámara de la escena.
     glm::mat4 projection; ///< Matriz de proyección.
+    GELight light; ///< Luz de la escena.
+    GEFrustum frustum; ///< Volumen de visión del frame actual.
+    GECullStats cullStats; ///< Objetos visibles y descartados en el último frame.
+    uint32_t triangleCount; ///< Triángulos enviados en el último frame.
+#ifdef DEBUG
+    double cpuTime; ///< Tiempo de CPU acumulado en update().
+    uint32_t cpuFrames; ///< Frames acumulados en cpuTime.
+    double recordTime; ///< Tiempo de CPU acumulado grabando command buffers.
+    double overdrawSum; ///< Overdraw acumulado de los frames medidos.
+    uint32_t overdrawFrames; ///< Frames con medida de overdraw en overdrawSum.
+#endif
 
 public:
     /**
@@ -38,8 +85,11 @@ public:
      * @param gc Contexto gráfico.
      * @param dc Contexto de dibujo.
      * @param cc Contexto de comandos.
+     * @param pushTransforms Envía la matriz Model por push constants (false: por el buffer de uniformes).
+     * @param meshPath Fichero .gem (ver convertObjToMeshFile()) que se dibuja junto al esqueleto (vacío: ninguno).
      */
-    GEScene(GEGraphicsContext* gc, GEDrawingContext* dc, GECommandContext* cc);
+    GEScene(GEGraphicsContext* gc, GEDrawingContext* dc, GECommandContext* cc, bool pushTransforms = PUSH_TRANSFORMS,
+        const std::string& meshPath = "");
 
     /**
      * @brief Destruye los componentes gráficos de la escena.
@@ -58,9 +108,10 @@ public:
     /**
      * @brief Actualiza la escena (animaciones y transformaciones).
      * @param gc Contexto gráfico.
-     * @param index Índice de la imagen a renderizar.
+     * @param frame Índice del frame en vuelo (uniformes, descriptor sets y command buffer).
+     * @param image Índice de la imagen a renderizar.
      */
-    void update(GEGraphicsContext* gc, uint32_t index);
+    void update(GEGraphicsContext* gc, uint32_t frame, uint32_t image);
 
     /**
      * @brief Maneja acciones de teclado.
@@ -75,6 +126,32 @@ public:
      */
     void aspect_ratio(double aspect);
 
+    /**
+     * @brief Fija el paso de tiempo de la animación en cada update().
+     *
+     * Con un paso fijo la animación no depende del reloj, así que dos ejecuciones
+     * dibujan los mismos frames (p. ej. en el benchmark sin ventana).
+     * @param timestep Segundos por frame (0: tiempo real).
+     */
+    void setFixedTimestep(double timestep);
+
+    /**
+     * @brief Vuelve al comienzo de la animación.
+     */
+    void resetAnimation();
+
+    /**
+     * @brief Obtiene el resultado del descarte por volumen de visión del último frame.
+     * @return Número de objetos visibles y descartados.
+     */
+    GECullStats getCullStats() const;
+
+    /**
+     * @brief Obtiene el número de triángulos enviados en el último frame.
+     * @return Triángulos de las figuras y de las instancias dibujadas.
+     */
+    uint32_t getTriangleCount() const;
+
 private:
     /**
      * @brief Obtiene la configuración del pipeline para un extent dado.
@@ -84,10 +161,27 @@ private:
     GEPipelineConfig* createPipelineConfig(VkExtent2D extent);
 
     /**
-     * @brief Rellena los buffers de comandos para el renderizado.
-     * @param commandBuffers Buffers de comandos a rellenar.
+     * @brief Graba el buffer de comandos de un frame.
+     *
+     * La lista de draws se reparte entre buffers secundarios que graban varios hilos.
+     * @param commandBuffer Buffer de comandos (no puede estar pendiente de ejecución).
+     * @param frame Índice del frame.
+     * @param image Índice de la imagen.
+     */
+    void fillCommandBuffer(VkCommandBuffer commandBuffer, uint32_t frame, uint32_t image);
+
+    /**
+     * @brief Graba un tramo de la lista de draws en un buffer secundario.
+     *
+     * Los draws [0, renderQueue->getPacketCount()) son los de la cola ordenada y el
+     * último es el renderizador de instancias. Con DEPTH_PREPASS la lista está
+     * dos veces: primero la pasada de profundidad y después la de color.
+     * @param commandBuffer Buffer de comandos secundario.
+     * @param frame Índice del frame.
+     * @param first Primer draw del tramo.
+     * @param count Número de draws del tramo.
      */
-    void fillCommandBuffers(std::vector<VkCommandBuffer> commandBuffers);
+    void recordDraws(VkCommandBuffer commandBuffer, uint32_t frame, uint32_t first, uint32_t count);
 
     /**
      * @brief Crea la animación de tiro libre.
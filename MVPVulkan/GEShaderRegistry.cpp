@@ -0,0 +1,281 @@
+/**
+ * @file GEShaderRegistry.cpp
+ * @brief Implementación de la clase GEShaderRegistry.
+ */
+
+#include "GEShaderRegistry.h"
+
+#include <stdexcept>
+#include <map>
+#include <set>
+#include <utility>
+#include <algorithm>
+
+// Los genera glslangValidator, validados con spirv-val, en el directorio de salida de
+// la compilación (ver shaders/CompileShader.bat); no se guardan en el repositorio
+#include "vert_spv.h"
+#include "frag_spv.h"
+#include "instanced_vert_spv.h"
+#include "instanced_frag_spv.h"
+#include "pushed_vert_spv.h"
+#include "instanced_packed_vert_spv.h"
+
+/**
+ * @brief Tabla de shaders, en el orden de los identificadores SHADER_*.
+ */
+static const GEShaderCode shaderTable[SHADER_COUNT] =
+{
+	{ vert_spv, sizeof(vert_spv) },
+	{ frag_spv, sizeof(frag_spv) },
+	{ instanced_vert_spv, sizeof(instanced_vert_spv) },
+	{ instanced_frag_spv, sizeof(instanced_frag_spv) },
+	{ pushed_vert_spv, sizeof(pushed_vert_spv) },
+	{ instanced_packed_vert_spv, sizeof(instanced_packed_vert_spv) },
+};
+
+// Valores de la especificación de SPIR-V que se leen al reflejar un shader
+static const uint32_t SPV_MAGIC = 0x07230203;
+static const uint32_t SPV_HEADER_WORDS = 5;
+static const uint32_t SPV_OP_TYPE_INT = 21;
+static const uint32_t SPV_OP_TYPE_FLOAT = 22;
+static const uint32_t SPV_OP_TYPE_VECTOR = 23;
+static const uint32_t SPV_OP_TYPE_MATRIX = 24;
+static const uint32_t SPV_OP_TYPE_ARRAY = 28;
+static const uint32_t SPV_OP_TYPE_STRUCT = 30;
+static const uint32_t SPV_OP_TYPE_POINTER = 32;
+static const uint32_t SPV_OP_CONSTANT = 43;
+static const uint32_t SPV_OP_VARIABLE = 59;
+static const uint32_t SPV_OP_DECORATE = 71;
+static const uint32_t SPV_OP_MEMBER_DECORATE = 72;
+static const uint32_t SPV_DECORATION_BUFFER_BLOCK = 3;
+static const uint32_t SPV_DECORATION_ARRAY_STRIDE = 6;
+static const uint32_t SPV_DECORATION_MATRIX_STRIDE = 7;
+static const uint32_t SPV_DECORATION_LOCATION = 30;
+static const uint32_t SPV_DECORATION_BINDING = 33;
+static const uint32_t SPV_DECORATION_DESCRIPTOR_SET = 34;
+static const uint32_t SPV_DECORATION_OFFSET = 35;
+static const uint32_t SPV_STORAGE_CLASS_INPUT = 1;
+static const uint32_t SPV_STORAGE_CLASS_UNIFORM = 2;
+static const uint32_t SPV_STORAGE_CLASS_PUSH_CONSTANT = 9;
+static const uint32_t SPV_STORAGE_CLASS_STORAGE_BUFFER = 12;
+
+/**
+ * @brief Crea el registro (sin módulos).
+ * @param device Dispositivo lógico.
+ */
+GEShaderRegistry::GEShaderRegistry(VkDevice device)
+{
+	this->device = device;
+	for (int i = 0; i < SHADER_COUNT; i++)
+	{
+		modules[i] = VK_NULL_HANDLE;
+	}
+}
+
+/**
+ * @brief Obtiene el código SPIR-V de un shader sin copiarlo.
+ * @param shader Identificador del shader.
+ * @return Puntero y tamaño del código.
+ */
+GEShaderCode GEShaderRegistry::getCode(int shader)
+{
+	if (shader < 0 || shader >= SHADER_COUNT)
+	{
+		throw std::runtime_error("failed to find shader!");
+	}
+	return shaderTable[shader];
+}
+
+/**
+ * @brief Lee la interfaz de un shader de su código SPIR-V.
+ * @param shader Identificador del shader.
+ * @return Interfaz del shader.
+ */
+GEShaderInterface GEShaderRegistry::reflect(int shader)
+{
+	GEShaderCode shaderCode = getCode(shader);
+	const uint32_t* words = shaderCode.code;
+	size_t wordCount = shaderCode.size / sizeof(uint32_t);
+	if (wordCount < SPV_HEADER_WORDS || words[0] != SPV_MAGIC)
+	{
+		throw std::runtime_error("failed to reflect shader: invalid SPIR-V!");
+	}
+
+	std::map<uint32_t, uint32_t> sets;
+	std::map<uint32_t, uint32_t> bindings;
+	std::map<uint32_t, uint32_t> locations;
+	std::map<uint32_t, uint32_t> components;
+	std::set<uint32_t> bufferBlocks;
+	std::map<uint32_t, uint32_t> pointees;
+	std::vector<size_t> variables;
+
+	// Tamaños en bytes de los tipos, para el bloque de push constants. Las decoraciones
+	// van antes que los tipos y cada tipo antes que sus usos, así que basta una pasada
+	std::map<uint32_t, uint32_t> sizes;
+	std::map<uint32_t, uint32_t> columns;
+	std::map<uint32_t, uint32_t> constants;
+	std::map<uint32_t, uint32_t> arrayStrides;
+	std::map<std::pair<uint32_t, uint32_t>, uint32_t> memberOffsets;
+	std::map<std::pair<uint32_t, uint32_t>, uint32_t> matrixStrides;
+	std::map<uint32_t, uint32_t> structOffsets;
+	std::map<uint32_t, uint32_t> structSizes;
+
+	// Cada instrucción empieza por una palabra con su longitud (16 bits altos) y su código
+	for (size_t i = SPV_HEADER_WORDS; i < wordCount;)
+	{
+		uint32_t length = words[i] >> 16;
+		uint32_t opcode = words[i] & 0xFFFF;
+		if (length == 0 || i + length > wordCount)
+		{
+			throw std::runtime_error("failed to reflect shader: invalid SPIR-V!");
+		}
+		const uint32_t* op = words + i;
+
+		if (opcode == SPV_OP_DECORATE && length >= 3)
+		{
+			if (op[2] == SPV_DECORATION_DESCRIPTOR_SET && length >= 4) sets[op[1]] = op[3];
+			else if (op[2] == SPV_DECORATION_BINDING && length >= 4) bindings[op[1]] = op[3];
+			else if (op[2] == SPV_DECORATION_LOCATION && length >= 4) locations[op[1]] = op[3];
+			else if (op[2] == SPV_DECORATION_ARRAY_STRIDE && length >= 4) arrayStrides[op[1]] = op[3];
+			else if (op[2] == SPV_DECORATION_BUFFER_BLOCK) bufferBlocks.insert(op[1]);
+		}
+		else if (opcode == SPV_OP_MEMBER_DECORATE && length >= 5)
+		{
+			if (op[3] == SPV_DECORATION_OFFSET) memberOffsets[std::make_pair(op[1], op[2])] = op[4];
+			else if (op[3] == SPV_DECORATION_MATRIX_STRIDE) matrixStrides[std::make_pair(op[1], op[2])] = op[4];
+		}
+		else if ((opcode == SPV_OP_TYPE_INT || opcode == SPV_OP_TYPE_FLOAT) && length >= 3)
+		{
+			components[op[1]] = 1;
+			sizes[op[1]] = op[2] / 8;
+		}
+		else if (opcode == SPV_OP_TYPE_VECTOR && length >= 4)
+		{
+			components[op[1]] = op[3];
+			sizes[op[1]] = sizes[op[2]] * op[3];
+		}
+		else if (opcode == SPV_OP_TYPE_MATRIX && length >= 4)
+		{
+			columns[op[1]] = op[3];
+			sizes[op[1]] = sizes[op[2]] * op[3];
+		}
+		else if (opcode == SPV_OP_CONSTANT && length >= 4)
+		{
+			constants[op[2]] = op[3];
+		}
+		else if (opcode == SPV_OP_TYPE_ARRAY && length >= 4)
+		{
+			sizes[op[1]] = arrayStrides[op[1]] * constants[op[3]];
+		}
+		else if (opcode == SPV_OP_TYPE_STRUCT && length >= 2)
+		{
+			// El tamaño va desde el primer miembro hasta el final del último (según sus Offset)
+			uint32_t first = UINT32_MAX;
+			uint32_t end = 0;
+			for (uint32_t m = 0; m + 2 < length; m++)
+			{
+				std::pair<uint32_t, uint32_t> member = std::make_pair(op[1], m);
+				uint32_t offset = memberOffsets.count(member) ? memberOffsets[member] : 0;
+				uint32_t size = sizes[op[m + 2]];
+				if (matrixStrides.count(member)) size = matrixStrides[member] * columns[op[m + 2]];
+				first = std::min(first, offset);
+				end = std::max(end, offset + size);
+			}
+			structOffsets[op[1]] = (first == UINT32_MAX) ? 0 : first;
+			structSizes[op[1]] = end - structOffsets[op[1]];
+			sizes[op[1]] = end;
+		}
+		else if (opcode == SPV_OP_TYPE_POINTER && length >= 4)
+		{
+			pointees[op[1]] = op[3];
+		}
+		else if (opcode == SPV_OP_VARIABLE && length >= 4)
+		{
+			if (op[3] == SPV_STORAGE_CLASS_UNIFORM || op[3] == SPV_STORAGE_CLASS_STORAGE_BUFFER
+				|| op[3] == SPV_STORAGE_CLASS_INPUT || op[3] == SPV_STORAGE_CLASS_PUSH_CONSTANT)
+			{
+				variables.push_back(i);
+			}
+		}
+		i += length;
+	}
+
+	GEShaderInterface shaderInterface;
+	shaderInterface.pushConstantOffset = 0;
+	shaderInterface.pushConstantSize = 0;
+	for (size_t v : variables)
+	{
+		const uint32_t* op = words + v;
+		uint32_t id = op[2];
+		if (op[3] == SPV_STORAGE_CLASS_PUSH_CONSTANT)
+		{
+			shaderInterface.pushConstantOffset = structOffsets[pointees[op[1]]];
+			shaderInterface.pushConstantSize = structSizes[pointees[op[1]]];
+			continue;
+		}
+		if (op[3] == SPV_STORAGE_CLASS_INPUT)
+		{
+			// Las variables predefinidas (gl_InstanceIndex...) no tienen Location
+			if (locations.count(id) == 0) continue;
+			if (components.count(pointees[op[1]]) == 0)
+			{
+				throw std::runtime_error("failed to reflect shader: unsupported input type!");
+			}
+
+			GEShaderInput input;
+			input.location = locations[id];
+			input.components = components[pointees[op[1]]];
+			shaderInterface.inputs.push_back(input);
+			continue;
+		}
+
+		if (sets.count(id) == 0 || bindings.count(id) == 0)
+		{
+			throw std::runtime_error("failed to reflect shader: buffer without set or binding!");
+		}
+
+		// Con Vulkan 1.0 glslang declara los buffers de almacenamiento como Uniform + BufferBlock
+		bool storage = op[3] == SPV_STORAGE_CLASS_STORAGE_BUFFER || bufferBlocks.count(pointees[op[1]]) > 0;
+
+		GEShaderBinding binding;
+		binding.set = sets[id];
+		binding.binding = bindings[id];
+		binding.type = storage ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		shaderInterface.bindings.push_back(binding);
+	}
+	return shaderInterface;
+}
+
+/**
+ * @brief Obtiene el módulo de un shader, creándolo la primera vez.
+ * @param shader Identificador del shader.
+ * @return Módulo del shader.
+ */
+VkShaderModule GEShaderRegistry::getModule(int shader)
+{
+	GEShaderCode shaderCode = getCode(shader);
+	if (modules[shader] != VK_NULL_HANDLE) return modules[shader];
+
+	VkShaderModuleCreateInfo createInfo = {};
+	createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+	createInfo.codeSize = shaderCode.size;
+	createInfo.pCode = shaderCode.code;
+
+	if (vkCreateShaderModule(device, &createInfo, nullptr, &modules[shader]) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create shader module!");
+	}
+	return modules[shader];
+}
+
+/**
+ * @brief Destruye los módulos creados.
+ */
+void GEShaderRegistry::destroy()
+{
+	for (int i = 0; i < SHADER_COUNT; i++)
+	{
+		if (modules[i] != VK_NULL_HANDLE) vkDestroyShaderModule(device, modules[i], nullptr);
+		modules[i] = VK_NULL_HANDLE;
+	}
+}
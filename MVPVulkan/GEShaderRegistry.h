@@ -0,0 +1,115 @@
+/**
+ * @file GEShaderRegistry.h
+ * @brief Declaración de la clase GEShaderRegistry que da acceso a los shaders incrustados en el ejecutable.
+ */
+
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+const int SHADER_VERT = 0;                   ///< shader.vert (transformación por UBO).
+const int SHADER_FRAG = 1;                   ///< shader.frag.
+const int SHADER_INSTANCED_VERT = 2;         ///< instanced.vert.
+const int SHADER_INSTANCED_FRAG = 3;         ///< instanced.frag.
+const int SHADER_PUSHED_VERT = 4;            ///< pushed.vert (transformación por push constants).
+const int SHADER_INSTANCED_PACKED_VERT = 5;  ///< instanced_packed.vert (vértices de 12 bytes).
+const int SHADER_COUNT = 6;                  ///< Número de shaders incrustados.
+
+/**
+ * @struct GEShaderCode
+ * @brief Código SPIR-V de un shader.
+ */
+struct GEShaderCode
+{
+	const uint32_t* code; ///< Palabras SPIR-V (datos estáticos del ejecutable).
+	size_t size;          ///< Tamaño en bytes.
+};
+
+/**
+ * @struct GEShaderBinding
+ * @brief Buffer de un descriptor que usa un shader (decoraciones DescriptorSet y Binding).
+ */
+struct GEShaderBinding
+{
+	uint32_t set;          ///< Set del descriptor.
+	uint32_t binding;      ///< Binding dentro del set.
+	VkDescriptorType type; ///< VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER o VK_DESCRIPTOR_TYPE_STORAGE_BUFFER.
+};
+
+/**
+ * @struct GEShaderInput
+ * @brief Entrada de un shader (decoración Location).
+ */
+struct GEShaderInput
+{
+	uint32_t location;   ///< Posición de la entrada.
+	uint32_t components; ///< Número de componentes (1 a 4).
+};
+
+/**
+ * @struct GEShaderInterface
+ * @brief Interfaz de un shader leída de su código SPIR-V.
+ */
+struct GEShaderInterface
+{
+	std::vector<GEShaderBinding> bindings; ///< Buffers de descriptores usados por el shader.
+	std::vector<GEShaderInput> inputs;     ///< Entradas con Location (sin las variables predefinidas).
+	uint32_t pushConstantOffset;           ///< Offset del primer miembro del bloque de push constants.
+	uint32_t pushConstantSize;             ///< Bytes del bloque de push constants desde su offset (0: no lo usa).
+};
+
+/**
+ * @class GEShaderRegistry
+ * @brief Registro de los shaders compilados a SPIR-V durante la compilación del proyecto.
+ *
+ * El código de cada shader es un array de uint32_t generado por glslangValidator
+ * (--vn) a partir de los ficheros de la carpeta shaders, así que no hace falta
+ * leer ficheros ni recursos de Windows. Los módulos se crean la primera vez que
+ * se piden y se comparten entre todos los pipelines que usan el mismo shader.
+ */
+class GEShaderRegistry
+{
+private:
+	VkDevice device;                       ///< Dispositivo lógico.
+	VkShaderModule modules[SHADER_COUNT];  ///< Módulo de cada shader (VK_NULL_HANDLE si no se ha pedido).
+
+public:
+	/**
+	 * @brief Crea el registro (sin módulos).
+	 * @param device Dispositivo lógico.
+	 */
+	GEShaderRegistry(VkDevice device);
+
+	/**
+	 * @brief Obtiene el código SPIR-V de un shader sin copiarlo.
+	 * @param shader Identificador del shader (SHADER_*).
+	 * @return Puntero y tamaño del código.
+	 */
+	static GEShaderCode getCode(int shader);
+
+	/**
+	 * @brief Lee la interfaz de un shader de su código SPIR-V.
+	 *
+	 * Permite comprobar al crear un pipeline que su layout coincide con lo que
+	 * declara el shader compilado, en lugar de esperar a las capas de validación.
+	 * Solo se reflejan buffers (los shaders del proyecto no usan imágenes).
+	 * @param shader Identificador del shader (SHADER_*).
+	 * @return Interfaz del shader.
+	 */
+	static GEShaderInterface reflect(int shader);
+
+	/**
+	 * @brief Obtiene el módulo de un shader, creándolo la primera vez.
+	 * @param shader Identificador del shader (SHADER_*).
+	 * @return Módulo del shader (propiedad del registro).
+	 */
+	VkShaderModule getModule(int shader);
+
+	/**
+	 * @brief Destruye los módulos creados.
+	 */
+	void destroy();
+};
@@ -83,12 +83,13 @@ void GESkeleton::buildSkeleton()
 /**
  * @brief Inicializa el esqueleto.
  * @param gc Contexto gráfico.
- * @param rc Contexto de renderizado.
+ * @param cache Caché de mallas compartidas por las articulaciones.
+ * @param renderer Renderizador de instancias.
  */
-void GESkeleton::initialize(GEGraphicsContext* gc, GERenderingContext* rc)
+void GESkeleton::initialize(GEGraphicsContext* gc, GEMeshCache* cache, GEInstanceRenderer* renderer)
 {
     for (GEBalljoint* root : rootJoints) {
-        root->initializeRecursive(gc, rc);
+        root->initializeRecursive(gc, cache, renderer);
     }
 }
 
@@ -108,37 +109,13 @@ void GESkeleton::destroy(GEGraphicsContext* gc)
 /**
  * @brief Actualiza el esqueleto.
  */
-void GESkeleton::update(GEGraphicsContext* gc, uint32_t index, glm::mat4 view, glm::mat4 projection)
+void GESkeleton::update()
 {
     // Matriz base: traslación + orientación del esqueleto
     glm::mat4 baseMatrix = glm::translate(glm::mat4(1.0f), position);
     
     for (GEBalljoint* root : rootJoints) {
-        root->updateRecursive(gc, index, baseMatrix, view, projection);
-    }
-}
-
-/**
- * @brief Añade comandos de dibujo.
- * @param commandBuffer Buffer de comandos Vulkan.
- * @param pipelineLayout Layout del pipeline.
- * @param index Índice de la imagen.
- */
-void GESkeleton::addCommands(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, int index)
-{
-    for (GEBalljoint* root : rootJoints) {
-        root->addCommandsRecursive(commandBuffer, pipelineLayout, index);
-    }
-}
-
-/**
- * @brief Asigna la luz al esqueleto.
- * @param light Parámetros de la luz.
- */
-void GESkeleton::setLight(GELight light)
-{
-    for (GEBalljoint* root : rootJoints) {
-        root->setLightRecursive(light);
+        root->updateRecursive(baseMatrix);
     }
 }
 
@@ -6,10 +6,8 @@
 #pragma once
 
 #include "GEGraphicsContext.h"
-#include "GERenderingContext.h"
 #include "GEBalljoint.h"
 #include "GEXMLParser.h"
-#include "GELight.h"
 #include <glm/glm.hpp>
 #include <string>
 
@@ -49,11 +47,12 @@ public:
     ~GESkeleton();
     
     /**
-     * @brief Inicializa los recursos gráficos del esqueleto.
+     * @brief Registra las articulaciones del esqueleto en el renderizador de instancias.
      * @param gc Contexto gráfico.
-     * @param rc Contexto de renderizado.
+     * @param cache Caché de mallas compartidas por las articulaciones.
+     * @param renderer Renderizador de instancias.
      */
-    void initialize(GEGraphicsContext* gc, GERenderingContext* rc);
+    void initialize(GEGraphicsContext* gc, GEMeshCache* cache, GEInstanceRenderer* renderer);
 
     /**
      * @brief Destruye los recursos asociados al esqueleto.
@@ -62,27 +61,9 @@ public:
     void destroy(GEGraphicsContext* gc);
 
     /**
-     * @brief Actualiza el esqueleto (transformaciones y memoria intermedia).
-     * @param gc Contexto gráfico.
-     * @param index Índice de la imagen a renderizar.
-     * @param view Matriz de vista.
-     * @param projection Matriz de proyección.
-     */
-    void update(GEGraphicsContext* gc, uint32_t index, glm::mat4 view, glm::mat4 projection);
-
-    /**
-     * @brief Añade comandos de dibujo del esqueleto al command buffer.
-     * @param commandBuffer Buffer de comandos Vulkan.
-     * @param pipelineLayout Layout del pipeline.
-     * @param index Índice de imagen.
-     */
-    void addCommands(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, int index);
-
-    /**
-     * @brief Asigna la luz para el esqueleto.
-     * @param light Estructura con los parámetros de la luz.
+     * @brief Actualiza las transformaciones de las articulaciones.
      */
-    void setLight(GELight light);
+    void update();
     
     // Acceso a articulaciones
     /**
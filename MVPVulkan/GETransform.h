@@ -9,11 +9,22 @@
 
 /**
  * @struct GETransform
- * @brief Estructura que almacena los datos necesarios para girar las figuras.
+ * @brief Estructura con los datos propios de cada figura (se actualizan por objeto).
+ *
+ * Se envía en el set del objeto o como bloque de push constants (64 bytes,
+ * dentro del mínimo de 128 bytes garantizado por Vulkan).
+ */
+typedef struct
+{
+	alignas(16) glm::mat4 Model; ///< Matriz de modelo.
+} GETransform;
+
+/**
+ * @struct GEViewTransform
+ * @brief Estructura con las matrices comunes a todas las figuras (se actualizan una vez por frame).
  */
 typedef struct
 {
-	alignas(16) glm::mat4 MVP; ///< Matriz modelo-vista-proyección.
 	alignas(16) glm::mat4 ViewMatrix; ///< Matriz de vista.
-	alignas(16) glm::mat4 ModelViewMatrix; ///< Matriz modelo-vista.
-} GETransform;
\ No newline at end of file
+	alignas(16) glm::mat4 Projection; ///< Matriz de proyección.
+} GEViewTransform;
\ No newline at end of file
@@ -5,29 +5,30 @@
 
 #include "GEUniformBuffer.h"
 
+#include <cstring>
 #include <iostream>
 
 /**
- * @brief Crea una lista de Uniform Buffers asociados a cada imagen a generar.
+ * @brief Crea una lista de Uniform Buffers asociados a cada frame en vuelo.
  * @param gc Contexto gráfico.
- * @param imageCount Número de imágenes del swapchain.
+ * @param frameCount Número de frames en vuelo.
  * @param bufferSize Tamaño del buffer en bytes.
+ * @param usage Uso del buffer (uniform o storage buffer).
  */
-GEUniformBuffer::GEUniformBuffer(GEGraphicsContext* gc, uint32_t imageCount, size_t bufferSize)
+GEUniformBuffer::GEUniformBuffer(GEGraphicsContext* gc, uint32_t frameCount, size_t bufferSize, VkBufferUsageFlags usage)
 {
 	this->bufferSize = bufferSize;
-	this->buffers.resize(imageCount);
-	this->memories.resize(imageCount);
+	this->buffers.resize(frameCount);
+	this->allocations.resize(frameCount);
 
-	for (uint32_t i = 0; i < imageCount; i++)
+	for (uint32_t i = 0; i < frameCount; i++)
 	{
 		VkBuffer buffer;
-		VkDeviceMemory deviceMemory;
 
 		VkBufferCreateInfo bufferInfo = {};
 		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
 		bufferInfo.size = bufferSize;
-		bufferInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+		bufferInfo.usage = usage;
 		bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
 		if (vkCreateBuffer(gc->device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS)
@@ -38,36 +39,33 @@ GEUniformBuffer::GEUniformBuffer(GEGraphicsContext* gc, uint32_t imageCount, siz
 		VkMemoryRequirements memRequirements;
 		vkGetBufferMemoryRequirements(gc->device, buffer, &memRequirements);
 
-		VkMemoryAllocateInfo allocInfo = {};
-		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		allocInfo.allocationSize = memRequirements.size;
-		allocInfo.memoryTypeIndex = gc->findMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+		// El asignador mantiene mapeados los bloques visibles desde la CPU
+		bool coherent;
+		uint32_t memoryType = gc->findHostMemoryType(memRequirements.memoryTypeBits, &coherent);
+		GEAllocation allocation = gc->allocator->allocate(memRequirements, memoryType, true);
 
-		if (vkAllocateMemory(gc->device, &allocInfo, nullptr, &deviceMemory) != VK_SUCCESS)
-		{
-			throw std::runtime_error("failed to allocate buffer memory!");
-		}
-
-		vkBindBufferMemory(gc->device, buffer, deviceMemory, 0);
+		vkBindBufferMemory(gc->device, buffer, allocation.memory, allocation.offset);
 
 		buffers[i] = buffer;
-		memories[i] = deviceMemory;
+		allocations[i] = allocation;
 	}
 }
 
 /**
  * @brief Actualiza el valor almacenado en un Uniform Buffer.
  * @param gc Contexto gráfico.
- * @param currentImage Índice de la imagen actual.
+ * @param currentFrame Índice del frame actual.
  * @param size Tamaño de los datos a actualizar.
  * @param data Puntero a los datos.
  */
-void GEUniformBuffer::update(GEGraphicsContext* gc, uint32_t currentImage, size_t size, const void* data)
+void GEUniformBuffer::update(GEGraphicsContext* gc, uint32_t currentFrame, size_t size, const void* data)
 {
-	void* mdata;
-	vkMapMemory(gc->device, memories[currentImage], 0, size, 0, &mdata);
-	memcpy(mdata, data, size);
-	vkUnmapMemory(gc->device, memories[currentImage]);
+	GEAllocation& allocation = allocations[currentFrame];
+	memcpy(allocation.mapped, data, size);
+	if (!allocation.coherent)
+	{
+		gc->flushMappedMemory(allocation.memory, allocation.blockSize, allocation.offset, size);
+	}
 }
 
 /**
@@ -80,7 +78,7 @@ void GEUniformBuffer::destroy(GEGraphicsContext* gc)
 	for (uint32_t i = 0; i < size; i++)
 	{
 		vkDestroyBuffer(gc->device, buffers[i], nullptr);
-		vkFreeMemory(gc->device, memories[i], nullptr);
+		gc->allocator->free(allocations[i]);
 	}
 }
 
@@ -13,10 +13,10 @@ class GEUniformBuffer
 public:
 	size_t bufferSize;
 	std::vector<VkBuffer> buffers;
-	std::vector<VkDeviceMemory> memories;
+	std::vector<GEAllocation> allocations;
 
-	GEUniformBuffer(GEGraphicsContext* gc, uint32_t imageCount, size_t bufferSize);
-	void update(GEGraphicsContext* gc, uint32_t currentImage, size_t size, const void* data);
+	GEUniformBuffer(GEGraphicsContext* gc, uint32_t frameCount, size_t bufferSize, VkBufferUsageFlags usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+	void update(GEGraphicsContext* gc, uint32_t currentFrame, size_t size, const void* data);
 	void destroy(GEGraphicsContext* gc);
 };
 
@@ -0,0 +1,137 @@
+/**
+ * @file GEUniformRing.cpp
+ * @brief Implementación de la clase GEUniformRing.
+ */
+
+#include "GEUniformRing.h"
+
+#include <cstring>
+#include <iostream>
+
+/**
+ * @brief Crea y mapea los buffers y los descriptor sets compartidos.
+ * @param gc Contexto gráfico.
+ * @param rc Contexto de renderizado.
+ * @param capacity Tamaño de cada buffer en bytes.
+ * @param ranges Tamaño de la porción que ve cada set dinámico.
+ * @param firstSet Índice en el pipeline del primer set dinámico.
+ */
+GEUniformRing::GEUniformRing(GEGraphicsContext* gc, GERenderingContext* rc, size_t capacity, std::vector<size_t> ranges, uint32_t firstSet)
+{
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(gc->physicalDevice, &properties);
+
+	this->alignment = properties.limits.minUniformBufferOffsetAlignment;
+	this->capacity = capacity;
+	this->head = 0;
+	this->currentFrame = 0;
+	this->firstSet = firstSet;
+
+	uint32_t frameCount = rc->frameCount;
+	buffers.resize(frameCount);
+	allocations.resize(frameCount);
+
+	for (uint32_t i = 0; i < frameCount; i++)
+	{
+		VkBufferCreateInfo bufferInfo = {};
+		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		bufferInfo.size = capacity;
+		bufferInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+		bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		if (vkCreateBuffer(gc->device, &bufferInfo, nullptr, &buffers[i]) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to create uniform ring buffer!");
+		}
+
+		VkMemoryRequirements memRequirements;
+		vkGetBufferMemoryRequirements(gc->device, buffers[i], &memRequirements);
+
+		// El asignador mantiene el bloque mapeado durante toda su vida
+		bool coherent;
+		uint32_t memoryType = gc->findHostMemoryType(memRequirements.memoryTypeBits, &coherent);
+		allocations[i] = gc->allocator->allocate(memRequirements, memoryType, true);
+
+		vkBindBufferMemory(gc->device, buffers[i], allocations[i].memory, allocations[i].offset);
+	}
+
+	for (size_t i = 0; i < ranges.size(); i++)
+	{
+		VkDescriptorSetLayout layout = rc->descriptorSetLayouts[firstSet + i];
+		dsets.push_back(new GEDescriptorSet(gc, frameCount, layout, this, std::vector<size_t>(1, ranges[i])));
+	}
+}
+
+/**
+ * @brief Empieza a llenar el buffer de un frame desde el principio.
+ * @param frame Índice del frame.
+ */
+void GEUniformRing::begin(uint32_t frame)
+{
+	currentFrame = frame;
+	head = 0;
+}
+
+/**
+ * @brief Reserva una porción alineada en el buffer del frame actual y copia en ella los datos.
+ * @param size Tamaño de los datos en bytes.
+ * @param data Puntero a los datos.
+ * @return Offset dinámico de la porción.
+ */
+uint32_t GEUniformRing::allocate(size_t size, const void* data)
+{
+	VkDeviceSize alignedSize = (size + alignment - 1) & ~(alignment - 1);
+	if (head + alignedSize > capacity)
+	{
+		throw std::runtime_error("failed to allocate uniform ring slice!");
+	}
+
+	// Las porciones se escriben una detrás de otra en la memoria mapeada
+	VkDeviceSize offset = head;
+	memcpy((uint8_t*)allocations[currentFrame].mapped + offset, data, size);
+	head += alignedSize;
+	return (uint32_t)offset;
+}
+
+/**
+ * @brief Hace visibles al dispositivo las porciones escritas desde begin().
+ * @param gc Contexto gráfico.
+ */
+void GEUniformRing::flush(GEGraphicsContext* gc)
+{
+	GEAllocation& allocation = allocations[currentFrame];
+	if (!allocation.coherent && head > 0)
+	{
+		gc->flushMappedMemory(allocation.memory, allocation.blockSize, allocation.offset, head);
+	}
+}
+
+/**
+ * @brief Obtiene el número de bytes reservados en el frame actual.
+ * @return Bytes reservados.
+ */
+size_t GEUniformRing::getUsedSize() const
+{
+	return (size_t)head;
+}
+
+/**
+ * @brief Destruye los buffers y los descriptor sets.
+ * @param gc Contexto gráfico.
+ */
+void GEUniformRing::destroy(GEGraphicsContext* gc)
+{
+	for (GEDescriptorSet* dset : dsets)
+	{
+		dset->destroy(gc);
+		delete dset;
+	}
+	dsets.clear();
+
+	uint32_t size = (uint32_t)buffers.size();
+	for (uint32_t i = 0; i < size; i++)
+	{
+		vkDestroyBuffer(gc->device, buffers[i], nullptr);
+		gc->allocator->free(allocations[i]);
+	}
+}
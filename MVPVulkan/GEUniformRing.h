@@ -0,0 +1,89 @@
+/**
+ * @file GEUniformRing.h
+ * @brief Declaración de la clase GEUniformRing que agrupa las variables uniformes de las figuras.
+ */
+
+#pragma once
+
+#include "GEGraphicsContext.h"
+#include "GERenderingContext.h"
+#include "GEDescriptorSet.h"
+#include <vulkan/vulkan.h>
+#include <vector>
+
+/**
+ * @class GEUniformRing
+ * @brief Buffer de variables uniformes compartido por todas las figuras.
+ *
+ * Hay un único buffer por frame en vuelo, mapeado de forma persistente.
+ * Cada figura reserva en él porciones alineadas a minUniformBufferOffsetAlignment
+ * y las enlaza mediante descriptores VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+ * de modo que todas las figuras comparten los mismos descriptor sets por frame y
+ * se diferencian únicamente en los offsets dinámicos. Cada set dinámico (material,
+ * objeto...) tiene un único binding sobre este buffer.
+ *
+ * Es un asignador lineal por frame: begin() vuelve al principio del buffer del
+ * frame, cada allocate() copia sus datos a continuación de la porción anterior y
+ * flush() publica de una vez todo lo escrito. Las porciones solo valen para el
+ * frame en el que se reservan, así que no hay nada que liberar.
+ */
+class GEUniformRing
+{
+private:
+	VkDeviceSize capacity;           ///< Tamaño de cada buffer en bytes.
+	VkDeviceSize alignment;          ///< Alineamiento mínimo de los offsets dinámicos.
+	VkDeviceSize head;               ///< Primer byte libre en el buffer del frame actual.
+	uint32_t currentFrame;           ///< Frame cuyo buffer se está llenando.
+
+public:
+	std::vector<VkBuffer> buffers;         ///< Buffer de cada frame.
+	std::vector<GEAllocation> allocations; ///< Memoria de cada buffer.
+	std::vector<GEDescriptorSet*> dsets;   ///< Descriptor sets compartidos (uno por set dinámico).
+	uint32_t firstSet;                     ///< Índice en el pipeline del primer set dinámico.
+
+	/**
+	 * @brief Crea y mapea los buffers y los descriptor sets compartidos.
+	 * @param gc Contexto gráfico.
+	 * @param rc Contexto de renderizado.
+	 * @param capacity Tamaño de cada buffer en bytes.
+	 * @param ranges Tamaño de la porción que ve cada set dinámico (sets firstSet, firstSet + 1...).
+	 * @param firstSet Índice en el pipeline del primer set dinámico.
+	 */
+	GEUniformRing(GEGraphicsContext* gc, GERenderingContext* rc, size_t capacity, std::vector<size_t> ranges, uint32_t firstSet);
+
+	/**
+	 * @brief Empieza a llenar el buffer de un frame desde el principio.
+	 *
+	 * El frame ya no puede estar en vuelo (se ha esperado a su fence).
+	 * @param frame Índice del frame.
+	 */
+	void begin(uint32_t frame);
+
+	/**
+	 * @brief Reserva una porción alineada en el buffer del frame actual y copia en ella los datos.
+	 * @param size Tamaño de los datos en bytes.
+	 * @param data Puntero a los datos.
+	 * @return Offset dinámico de la porción.
+	 */
+	uint32_t allocate(size_t size, const void* data);
+
+	/**
+	 * @brief Hace visibles al dispositivo las porciones escritas desde begin().
+	 *
+	 * Con memoria no coherente es un único vkFlushMappedMemoryRanges por frame.
+	 * @param gc Contexto gráfico.
+	 */
+	void flush(GEGraphicsContext* gc);
+
+	/**
+	 * @brief Obtiene el número de bytes reservados en el frame actual.
+	 * @return Bytes reservados.
+	 */
+	size_t getUsedSize() const;
+
+	/**
+	 * @brief Destruye los buffers y los descriptor sets.
+	 * @param gc Contexto gráfico.
+	 */
+	void destroy(GEGraphicsContext* gc);
+};
@@ -0,0 +1,199 @@
+/**
+ * @file GEUploadContext.cpp
+ * @brief Implementación de la clase GEUploadContext.
+ */
+
+#include "GEUploadContext.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+/**
+ * @brief Crea el command pool y el fence de las transferencias.
+ * @param gc Contexto gráfico.
+ */
+GEUploadContext::GEUploadContext(GEGraphicsContext* gc)
+{
+	// Las transferencias se envían por la cola gráfica, que siempre las admite
+	vkGetDeviceQueue(gc->device, gc->graphicsQueueFamilyIndex, 0, &queue);
+	this->lastBytes = 0;
+	this->stagingSize = 0;
+	this->lastSeconds = 0.0;
+
+	VkCommandPoolCreateInfo poolInfo = {};
+	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	poolInfo.queueFamilyIndex = gc->graphicsQueueFamilyIndex;
+
+	if (vkCreateCommandPool(gc->device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create upload command pool!");
+	}
+
+	VkFenceCreateInfo fenceInfo = {};
+	fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+	if (vkCreateFence(gc->device, &fenceInfo, nullptr, &fence) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create upload fence!");
+	}
+}
+
+/**
+ * @brief Añade una copia de datos a un buffer DEVICE_LOCAL.
+ * @param dst Buffer de destino.
+ * @param data Puntero a los datos.
+ * @param size Tamaño de los datos en bytes.
+ * @param copy true para copiar los datos en el momento; false para leerlos en submit().
+ */
+void GEUploadContext::enqueue(VkBuffer dst, const void* data, size_t size, bool copy)
+{
+	// Cada copia empieza en un offset múltiplo de 16 dentro del staging buffer
+	PendingCopy pendingCopy;
+	pendingCopy.dst = dst;
+	pendingCopy.srcOffset = (stagingSize + 15) & ~(VkDeviceSize)15;
+	pendingCopy.size = size;
+	pendingCopy.source = copy ? nullptr : data;
+	pendingCopy.dataOffset = pendingData.size();
+	stagingSize = pendingCopy.srcOffset + size;
+
+	if (copy)
+	{
+		pendingData.resize(pendingCopy.dataOffset + size);
+		memcpy(pendingData.data() + pendingCopy.dataOffset, data, size);
+	}
+	pending.push_back(pendingCopy);
+}
+
+/**
+ * @brief Envía todas las copias pendientes y espera a que terminen.
+ * @param gc Contexto gráfico.
+ */
+void GEUploadContext::submit(GEGraphicsContext* gc)
+{
+	if (pending.empty()) return;
+
+	auto start = std::chrono::steady_clock::now();
+
+	// Staging buffer único para todas las copias
+	VkBuffer staging;
+	VkBufferCreateInfo bufferInfo = {};
+	bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferInfo.size = stagingSize;
+	bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+	bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	if (vkCreateBuffer(gc->device, &bufferInfo, nullptr, &staging) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create staging buffer!");
+	}
+
+	VkMemoryRequirements memRequirements;
+	vkGetBufferMemoryRequirements(gc->device, staging, &memRequirements);
+
+	bool coherent;
+	uint32_t memoryType = gc->findHostMemoryType(memRequirements.memoryTypeBits, &coherent);
+	GEAllocation allocation = gc->allocator->allocate(memRequirements, memoryType, true);
+	vkBindBufferMemory(gc->device, staging, allocation.memory, allocation.offset);
+
+	uint8_t* mapped = (uint8_t*)allocation.mapped;
+	for (const PendingCopy& copy : pending)
+	{
+		const void* data = (copy.source != nullptr) ? copy.source : pendingData.data() + copy.dataOffset;
+		memcpy(mapped + copy.srcOffset, data, (size_t)copy.size);
+	}
+	if (!coherent)
+	{
+		gc->flushMappedMemory(allocation.memory, allocation.blockSize, allocation.offset, stagingSize);
+	}
+
+	// Command buffer de un solo uso con todas las copias
+	VkCommandBuffer commandBuffer;
+	VkCommandBufferAllocateInfo allocInfo = {};
+	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocInfo.commandPool = commandPool;
+	allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocInfo.commandBufferCount = 1;
+
+	if (vkAllocateCommandBuffers(gc->device, &allocInfo, &commandBuffer) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to allocate upload command buffer!");
+	}
+
+	VkCommandBufferBeginInfo beginInfo = {};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+	for (const PendingCopy& copy : pending)
+	{
+		VkBufferCopy region = {};
+		region.srcOffset = copy.srcOffset;
+		region.dstOffset = 0;
+		region.size = copy.size;
+		vkCmdCopyBuffer(commandBuffer, staging, copy.dst, 1, &region);
+	}
+
+	// Las copias deben ser visibles para la lectura de vértices e índices
+	VkMemoryBarrier barrier = {};
+	barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+	vkEndCommandBuffer(commandBuffer);
+
+	VkSubmitInfo submitInfo = {};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &commandBuffer;
+
+	if (vkQueueSubmit(queue, 1, &submitInfo, fence) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to submit upload command buffer!");
+	}
+	vkWaitForFences(gc->device, 1, &fence, VK_TRUE, UINT64_MAX);
+	vkResetFences(gc->device, 1, &fence);
+
+	auto end = std::chrono::steady_clock::now();
+	lastBytes = stagingSize;
+	lastSeconds = std::chrono::duration<double>(end - start).count();
+
+	vkFreeCommandBuffers(gc->device, commandPool, 1, &commandBuffer);
+	vkDestroyBuffer(gc->device, staging, nullptr);
+	gc->allocator->free(allocation);
+
+	pending.clear();
+	pendingData.clear();
+	stagingSize = 0;
+}
+
+/**
+ * @brief Obtiene la velocidad de la última subida.
+ * @return Megabytes por segundo del último submit().
+ */
+double GEUploadContext::getThroughput() const
+{
+	if (lastBytes == 0 || lastSeconds <= 0.0) return 0.0;
+	return (double)lastBytes / (1024.0 * 1024.0) / lastSeconds;
+}
+
+/**
+ * @brief Obtiene los bytes enviados en la última subida.
+ * @return Número de bytes.
+ */
+VkDeviceSize GEUploadContext::getLastUploadSize() const
+{
+	return lastBytes;
+}
+
+/**
+ * @brief Destruye el command pool y el fence.
+ * @param gc Contexto gráfico.
+ */
+void GEUploadContext::destroy(GEGraphicsContext* gc)
+{
+	vkDestroyFence(gc->device, fence, nullptr);
+	vkDestroyCommandPool(gc->device, commandPool, nullptr);
+}
@@ -0,0 +1,88 @@
+/**
+ * @file GEUploadContext.h
+ * @brief Declaración de la clase GEUploadContext que sube datos estáticos a memoria local del dispositivo.
+ */
+
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include "GEGraphicsContext.h"
+
+/**
+ * @class GEUploadContext
+ * @brief Agrupa copias a buffers DEVICE_LOCAL a través de un staging buffer.
+ *
+ * Las copias se acumulan con enqueue() y se envían todas juntas con submit():
+ * un único staging buffer, un único command buffer de transferencia, un único
+ * vkQueueSubmit y una única espera sobre un fence.
+ *
+ * Los datos se copian al encolarlos salvo que se pida lo contrario: así un
+ * fichero proyectado en memoria pasa directamente al staging buffer.
+ */
+class GEUploadContext
+{
+private:
+	/**
+	 * @struct PendingCopy
+	 * @brief Copia pendiente desde el staging buffer a un buffer de destino.
+	 */
+	struct PendingCopy
+	{
+		VkBuffer dst;               ///< Buffer de destino.
+		VkDeviceSize srcOffset;     ///< Posición de los datos en el staging buffer.
+		VkDeviceSize size;          ///< Tamaño de la copia.
+		const void* source;         ///< Datos externos (nullptr si se copiaron en pendingData).
+		size_t dataOffset;          ///< Posición de los datos en pendingData.
+	};
+
+	VkQueue queue;                      ///< Cola en la que se envían las transferencias.
+	VkCommandPool commandPool;          ///< Pool para los command buffers de un solo uso.
+	VkFence fence;                      ///< Fence que señala el final de la transferencia.
+	std::vector<uint8_t> pendingData;   ///< Datos copiados al encolar.
+	VkDeviceSize stagingSize;           ///< Tamaño del staging buffer con todas las copias pendientes.
+	std::vector<PendingCopy> pending;   ///< Copias pendientes.
+	VkDeviceSize lastBytes;             ///< Bytes enviados en el último submit().
+	double lastSeconds;                 ///< Duración del último submit() en segundos.
+
+public:
+	/**
+	 * @brief Crea el command pool y el fence de las transferencias.
+	 * @param gc Contexto gráfico.
+	 */
+	GEUploadContext(GEGraphicsContext* gc);
+
+	/**
+	 * @brief Añade una copia de datos a un buffer DEVICE_LOCAL.
+	 * @param dst Buffer de destino (creado con VK_BUFFER_USAGE_TRANSFER_DST_BIT).
+	 * @param data Puntero a los datos.
+	 * @param size Tamaño de los datos en bytes.
+	 * @param copy true para copiar los datos en el momento; false para leerlos en submit()
+	 *             (deben seguir siendo válidos hasta entonces).
+	 */
+	void enqueue(VkBuffer dst, const void* data, size_t size, bool copy = true);
+
+	/**
+	 * @brief Envía todas las copias pendientes y espera a que terminen.
+	 * @param gc Contexto gráfico.
+	 */
+	void submit(GEGraphicsContext* gc);
+
+	/**
+	 * @brief Obtiene la velocidad de la última subida.
+	 * @return Megabytes por segundo del último submit() (0 si no hubo datos).
+	 */
+	double getThroughput() const;
+
+	/**
+	 * @brief Obtiene los bytes enviados en la última subida.
+	 * @return Número de bytes.
+	 */
+	VkDeviceSize getLastUploadSize() const;
+
+	/**
+	 * @brief Destruye el command pool y el fence.
+	 * @param gc Contexto gráfico.
+	 */
+	void destroy(GEGraphicsContext* gc);
+};
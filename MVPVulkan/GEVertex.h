@@ -1,11 +1,12 @@
 /**
  * @file GEVertex.h
- * @brief Declaración de la estructura GEVertex para vértices.
+ * @brief Declaración de las estructuras GEVertex y GEPackedVertex para vértices.
  */
 
 #pragma once
 
-#include <glm\glm.hpp>
+#include <glm/glm.hpp>
+#include <stdint.h>
 
 /**
  * @struct GEVertex
@@ -17,3 +18,17 @@ typedef struct
 	glm::vec3 norm; ///< Vector normal del vértice.
 } GEVertex;
 
+/**
+ * @struct GEPackedVertex
+ * @brief Vértice comprimido de 12 bytes (la mitad que GEVertex).
+ *
+ * La posición se guarda como SNORM16 relativa a la esfera envolvente de la malla
+ * (GEMesh::dequantize la devuelve a coordenadas del modelo) y la normal como
+ * SNORM16 x2 con codificación octaédrica.
+ */
+typedef struct
+{
+	int16_t pos[4];  ///< Posición cuantizada en [-1, 1] (el cuarto valor es relleno para alinear a 8 bytes).
+	int16_t norm[2]; ///< Normal codificada en octaedro.
+} GEPackedVertex;
+
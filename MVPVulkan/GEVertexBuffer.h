@@ -2,6 +2,7 @@
 
 #include <vulkan/vulkan.h>
 #include "GEGraphicsContext.h"
+#include "GEUploadContext.h"
 
 /**
  * @class GEVertexBuffer
@@ -11,9 +12,13 @@ class GEVertexBuffer
 {
 public:
 	VkBuffer buffer;
-	VkDeviceMemory memory;
+	GEAllocation allocation;
 
 	GEVertexBuffer(GEGraphicsContext* gc, size_t size, const void* data);
+	GEVertexBuffer(GEGraphicsContext* gc, GEUploadContext* upload, size_t size, const void* data, bool copy = true);
 	void destroy(GEGraphicsContext* gc);
+
+private:
+	void create(GEGraphicsContext* gc, size_t size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties);
 };
 
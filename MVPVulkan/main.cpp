@@ -4,7 +4,11 @@
  */
 
 #include "GEApplication.h"
+#include "GEMeshConverter.h"
+#include "GEBenchmark.h"
 #include <iostream>
+#include <string>
+#include <vector>
 #include <stdexcept>
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -22,9 +26,58 @@
  */
 void printControls();
 
-int main()
+/**
+ * @brief Punto de entrada.
+ *
+ * Con "--convert salida.gem nivel0.obj [nivel1.obj ...]" convierte ficheros OBJ
+ * al formato binario de mallas sin abrir la ventana. Con "--benchmark [frames] [prefijo]"
+ * mide los FPS de la escena sin ventana a varias resoluciones (y guarda las imágenes
+ * en PPM si se da un prefijo), con las matrices Model por push constants y por UBO.
+ * Al abrir la ventana, "--ubo-transforms" envía las matrices Model por el buffer de
+ * uniformes en lugar de por push constants y "--mesh fichero.gem" dibuja una malla
+ * convertida junto al esqueleto.
+ */
+int main(int argc, char* argv[])
 {
-	GEApplication app;
+	if (argc >= 4 && std::string(argv[1]) == "--convert")
+	{
+		try
+		{
+			convertObjToMeshFile(std::vector<std::string>(argv + 3, argv + argc), argv[2]);
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << e.what() << std::endl;
+			return EXIT_FAILURE;
+		}
+		return EXIT_SUCCESS;
+	}
+
+	if (argc >= 2 && std::string(argv[1]) == "--benchmark")
+	{
+		try
+		{
+			uint32_t frames = (argc >= 3) ? (uint32_t)std::stoul(argv[2]) : BENCHMARK_FRAMES;
+			runOffscreenBenchmark(frames, (argc >= 4) ? argv[3] : "");
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << e.what() << std::endl;
+			return EXIT_FAILURE;
+		}
+		return EXIT_SUCCESS;
+	}
+
+	bool pushTransforms = PUSH_TRANSFORMS;
+	std::string meshPath;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--ubo-transforms") pushTransforms = false;
+		else if (arg == "--mesh" && i + 1 < argc) meshPath = argv[++i];
+	}
+
+	GEApplication app(pushTransforms, meshPath);
 
     printControls();
 	try
@@ -61,6 +114,11 @@ void printControls() {
                                       R     : Reiniciar Animacion (Reset)
                                       N     : Keyframe Anterior
                                       M     : Siguiente Keyframe
+
+    [ VENTANA / PRESENTACION ]
+     F12 : Pantalla completa / Ventana
+     F11 : Siguiente modo de presentacion (FIFO, MAILBOX, IMMEDIATE)
+     F10 : Ritmo de frames: minima latencia / maximo rendimiento
     ___________________________________________________________
     )" << std::endl;
 }
\ No newline at end of file
@@ -2,15 +2,13 @@
 // Archivo de inclusión generado de Microsoft Visual C++.
 // Usado por MVPVulkan.rc
 //
-#define IDR_HTML1                       101
-#define IDR_HTML2                       102
 #define IDI_ICON1                       103
 
 // Next default values for new objects
 // 
 #ifdef APSTUDIO_INVOKED
 #ifndef APSTUDIO_READONLY_SYMBOLS
-#define _APS_NEXT_RESOURCE_VALUE        104
+#define _APS_NEXT_RESOURCE_VALUE        108
 #define _APS_NEXT_COMMAND_VALUE         40001
 #define _APS_NEXT_CONTROL_VALUE         1001
 #define _APS_NEXT_SYMED_VALUE           101
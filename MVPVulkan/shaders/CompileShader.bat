@@ -0,0 +1,10 @@
+@echo off
+rem Compila un shader GLSL a SPIR-V, lo valida con spirv-val y genera la cabecera con el array.
+rem Uso: CompileShader.bat <fuente> <nombre del array> <directorio de salida>
+setlocal
+set GLSLANG="%VULKAN_SDK%\Bin\glslangValidator.exe"
+set SPIRV_VAL="%VULKAN_SDK%\Bin\spirv-val.exe"
+if not exist "%~3" mkdir "%~3"
+%GLSLANG% -V "%~1" -o "%~3\%~2.spv" || exit /b 1
+%SPIRV_VAL% --target-env vulkan1.0 "%~3\%~2.spv" || exit /b 1
+%GLSLANG% -V "%~1" --vn %~2 -o "%~3\%~2.h" || exit /b 1
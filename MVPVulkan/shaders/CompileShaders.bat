@@ -1,3 +1,13 @@
-C:\VulkanSDK\1.3.216.0\Bin\glslangValidator.exe -V shader.vert
-C:\VulkanSDK\1.3.216.0\Bin\glslangValidator.exe -V shader.frag
-pause
\ No newline at end of file
+@echo off
+rem Genera las cabeceras SPIR-V igual que el paso de compilación del proyecto.
+rem Uso: CompileShaders.bat [directorio de salida] (por defecto shaders\generated)
+set OUT=%~1
+if "%OUT%"=="" set OUT=%~dp0generated
+call "%~dp0CompileShader.bat" "%~dp0shader.vert" vert_spv "%OUT%" || goto end
+call "%~dp0CompileShader.bat" "%~dp0shader.frag" frag_spv "%OUT%" || goto end
+call "%~dp0CompileShader.bat" "%~dp0instanced.vert" instanced_vert_spv "%OUT%" || goto end
+call "%~dp0CompileShader.bat" "%~dp0instanced.frag" instanced_frag_spv "%OUT%" || goto end
+call "%~dp0CompileShader.bat" "%~dp0pushed.vert" pushed_vert_spv "%OUT%" || goto end
+call "%~dp0CompileShader.bat" "%~dp0instanced_packed.vert" instanced_packed_vert_spv "%OUT%" || goto end
+:end
+pause
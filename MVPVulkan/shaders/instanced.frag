@@ -0,0 +1,53 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+struct MaterialInfo {
+    vec3 Ka;
+    vec3 Kd;
+    vec3 Ks;
+    float Shininess;
+};
+
+layout(location = 0) in vec3 Position;
+layout(location = 1) in vec3 Normal;
+layout(location = 2) flat in uint MaterialIndex;
+
+layout(location = 0) out vec4 outColor;
+
+layout(set=0, binding = 0) uniform CameraInfo {
+    mat4 ViewMatrix;
+    mat4 Projection;
+} Camera;
+
+layout(set=0, binding = 1) uniform LightInfo 
+{
+    vec3 Ldir;
+    vec3 La;
+    vec3 Ld;
+    vec3 Ls;
+} Light;
+
+layout(std430, set=1, binding = 1) readonly buffer MaterialBuffer {
+    MaterialInfo materials[];
+} Materials;
+
+vec3 ads() 
+{
+    vec4 s4 = Camera.ViewMatrix*vec4(Light.Ldir, 0.0);
+    vec3 n = normalize(Normal);
+    vec3 v = normalize(-Position);
+    vec3 s = normalize(-vec3(s4));
+    vec3 r = reflect(-s, n);
+    float dRate = max(dot(s, n), 0.0);
+    float sRate = pow(max(dot(r, v), 0.0), Materials.materials[MaterialIndex].Shininess);
+    vec3 ambient = Light.La * Materials.materials[MaterialIndex].Ka;
+    vec3 difusse = Light.Ld * Materials.materials[MaterialIndex].Kd * dRate;
+    vec3 specular = Light.Ls * Materials.materials[MaterialIndex].Ks * sRate;
+    return ambient + difusse + specular;
+}
+
+void main() 
+{
+    vec3 Color = ads();
+    outColor = vec4(Color, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+struct InstanceInfo {
+    mat4 Model;
+    uint MaterialIndex;
+};
+
+layout(set=0, binding = 0) uniform CameraInfo {
+    mat4 ViewMatrix;
+    mat4 Projection;
+} Camera;
+
+layout(std430, set=1, binding = 0) readonly buffer InstanceBuffer {
+    InstanceInfo instances[];
+} Instances;
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+
+layout(location = 0) out vec3 Position;
+layout(location = 1) out vec3 Normal;
+layout(location = 2) flat out uint MaterialIndex;
+
+void main() 
+{
+	mat4 ModelViewMatrix = Camera.ViewMatrix * Instances.instances[gl_InstanceIndex].Model;
+	vec4 n4 = ModelViewMatrix*vec4(inNormal, 0.0);
+	vec4 v4 = ModelViewMatrix*vec4(inPosition,1.0);
+	Normal = vec3(n4);
+	Position = vec3(v4);
+	MaterialIndex = Instances.instances[gl_InstanceIndex].MaterialIndex;
+	gl_Position = Camera.Projection * v4;
+}
\ No newline at end of file
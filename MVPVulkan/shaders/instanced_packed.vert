@@ -0,0 +1,45 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+struct InstanceInfo {
+    mat4 Model;
+    uint MaterialIndex;
+};
+
+layout(set=0, binding = 0) uniform CameraInfo {
+    mat4 ViewMatrix;
+    mat4 Projection;
+} Camera;
+
+layout(std430, set=1, binding = 0) readonly buffer InstanceBuffer {
+    InstanceInfo instances[];
+} Instances;
+
+// Posición cuantizada en [-1, 1] (SNORM16) y normal codificada en octaedro (2 x SNORM16).
+// La matriz Model de cada instancia ya incluye el centro y la escala de la cuantización.
+layout(location = 0) in vec4 inPosition;
+layout(location = 1) in vec2 inNormal;
+
+layout(location = 0) out vec3 Position;
+layout(location = 1) out vec3 Normal;
+layout(location = 2) flat out uint MaterialIndex;
+
+vec3 octDecode(vec2 e)
+{
+	vec3 n = vec3(e.x, e.y, 1.0 - abs(e.x) - abs(e.y));
+	float t = max(-n.z, 0.0);
+	n.x += (n.x >= 0.0) ? -t : t;
+	n.y += (n.y >= 0.0) ? -t : t;
+	return normalize(n);
+}
+
+void main() 
+{
+	mat4 ModelViewMatrix = Camera.ViewMatrix * Instances.instances[gl_InstanceIndex].Model;
+	vec4 n4 = ModelViewMatrix*vec4(octDecode(inNormal), 0.0);
+	vec4 v4 = ModelViewMatrix*vec4(inPosition.xyz,1.0);
+	Normal = normalize(vec3(n4));
+	Position = vec3(v4);
+	MaterialIndex = Instances.instances[gl_InstanceIndex].MaterialIndex;
+	gl_Position = Camera.Projection * v4;
+}
\ No newline at end of file
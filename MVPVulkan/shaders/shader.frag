@@ -6,21 +6,12 @@ layout(location = 1) in vec3 Normal;
 
 layout(location = 0) out vec4 outColor;
 
-layout(set=0, binding = 0) uniform TransformInfo {
-    mat4 MVP;
+layout(set=0, binding = 0) uniform CameraInfo {
     mat4 ViewMatrix;
-    mat4 ModelViewMatrix;
-} Transform;
+    mat4 Projection;
+} Camera;
 
-layout(set=0, binding = 1) uniform MaterialInfo 
-{
-    vec3 Ka;
-    vec3 Kd;
-    vec3 Ks;
-    float Shininess;
-} Material;
-
-layout(set=0, binding = 2) uniform LightInfo 
+layout(set=0, binding = 1) uniform LightInfo 
 {
     vec3 Ldir;
     vec3 La;
@@ -28,9 +19,17 @@ layout(set=0, binding = 2) uniform LightInfo
     vec3 Ls;
 } Light;
 
+layout(set=1, binding = 0) uniform MaterialInfo 
+{
+    vec3 Ka;
+    vec3 Kd;
+    vec3 Ks;
+    float Shininess;
+} Material;
+
 vec3 ads() 
 {
-    vec4 s4 = Transform.ViewMatrix*vec4(Light.Ldir, 0.0);
+    vec4 s4 = Camera.ViewMatrix*vec4(Light.Ldir, 0.0);
     vec3 n = normalize(Normal);
     vec3 v = normalize(-Position);
     vec3 s = normalize(-vec3(s4));
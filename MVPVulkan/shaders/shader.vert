@@ -1,11 +1,14 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
-layout(set=0, binding = 0) uniform TransformInfo {
-    mat4 MVP;
+layout(set=0, binding = 0) uniform CameraInfo {
     mat4 ViewMatrix;
-    mat4 ModelViewMatrix;
-} Transform;
+    mat4 Projection;
+} Camera;
+
+layout(set=2, binding = 0) uniform ObjectInfo {
+    mat4 Model;
+} Object;
 
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inNormal;
@@ -15,9 +18,10 @@ layout(location = 1) out vec3 Normal;
 
 void main() 
 {
-	vec4 n4 = Transform.ModelViewMatrix*vec4(inNormal, 0.0);
-	vec4 v4 = Transform.ModelViewMatrix*vec4(inPosition,1.0);
+	mat4 ModelViewMatrix = Camera.ViewMatrix * Object.Model;
+	vec4 n4 = ModelViewMatrix*vec4(inNormal, 0.0);
+	vec4 v4 = ModelViewMatrix*vec4(inPosition,1.0);
 	Normal = vec3(n4);
 	Position = vec3(v4);
-	gl_Position = Transform.MVP * vec4(inPosition, 1.0);
+	gl_Position = Camera.Projection * v4;
 }
\ No newline at end of file